@@ -116,19 +116,6 @@ GENERATED.commands =                                \
     mkdir generated;                                \
     touch generated/empty
 
-#-------------------------------------------------------------------------------
-# src/dep/generated/ctv.h
-#-------------------------------------------------------------------------------
-CTV_HEADER.depends = GENERATED
-CTV_HEADER.target = $$GEN/ctv.h
-
-CTV_HEADER.commands =                               \
-    @echo "Building ctv...";                        \
-    cd $$SRC/burn/drv/capcom;                       \
-    $$QMAKE_CXX ctv_make.cpp -o ctv_make;           \
-    ./ctv_make > $$CTV_HEADER.target;         \
-    rm ctv_make
-
 #-------------------------------------------------------------------------------
 # perl scripts
 #-------------------------------------------------------------------------------
@@ -271,7 +258,6 @@ macx {
 #-------------------------------------------------------------------------------
 QMAKE_EXTRA_TARGETS +=      \
     GENERATED               \
-    CTV_HEADER              \
     CAVE_SPRFUNC_HEADER     \
     CAVE_TILEFUNC_HEADER    \
     NEO_SPRFUNC_HEADER      \
@@ -289,7 +275,6 @@ QMAKE_EXTRA_TARGETS +=      \
     M68K_LIB
 
 PRE_TARGETDEPS +=                               \
-    $$CTV_HEADER.target                         \
     $$CAVE_SPRFUNC_HEADER.target                \
     $$CAVE_TILEFUNC_HEADER.target               \
     $$NEO_SPRFUNC_HEADER.target                 \
@@ -311,7 +296,6 @@ $$DRV_CAPCOM {
 
         HEADERS += $$files(../../src/burn/drv/capcom/*.h)
         SOURCES += $$files(../../src/burn/drv/capcom/*.cpp)
-        SOURCES -= ../../src/burn/drv/capcom/ctv_make.cpp
 }
 
 #===============================================================================
@@ -429,7 +413,6 @@ $$DRV_PRE90S {
         # CAPCOM deps...
         HEADERS *= $$files(../../src/burn/drv/capcom/*.h)
         SOURCES *= $$files(../../src/burn/drv/capcom/*.cpp)
-        SOURCES -= ../../src/burn/drv/capcom/ctv_make.cpp
         # KONAMI deps...
         HEADERS *= $$files(../../src/burn/drv/konami/*.h)
         SOURCES *= $$files(../../src/burn/drv/konami/k*.cpp)
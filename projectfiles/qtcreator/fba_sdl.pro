@@ -101,19 +101,6 @@ GENERATED.commands =                                \
     mkdir generated;                                \
     touch generated/empty
 
-#-------------------------------------------------------------------------------
-# src/dep/generated/ctv.h
-#-------------------------------------------------------------------------------
-CTV_HEADER.depends = GENERATED
-CTV_HEADER.target = $$GEN/ctv.h
-
-CTV_HEADER.commands =                               \
-    @echo "Building ctv...";                        \
-    cd $$SRC/burn/drv/capcom;                       \
-    $$QMAKE_CXX ctv_make.cpp -o ctv_make;           \
-    ./ctv_make > $$CTV_HEADER.target;         \
-    rm ctv_make
-
 #-------------------------------------------------------------------------------
 # perl scripts
 #-------------------------------------------------------------------------------
@@ -255,7 +242,6 @@ DRIVERLIST.commands = \
 #-------------------------------------------------------------------------------
 QMAKE_EXTRA_TARGETS +=      \
     GENERATED               \
-    CTV_HEADER              \
     CAVE_SPRFUNC_HEADER     \
     CAVE_TILEFUNC_HEADER    \
     NEO_SPRFUNC_HEADER      \
@@ -273,7 +259,6 @@ QMAKE_EXTRA_TARGETS +=      \
     M68K_LIB
 
 PRE_TARGETDEPS +=                               \
-    $$CTV_HEADER.target                         \
     $$CAVE_SPRFUNC_HEADER.target                \
     $$CAVE_TILEFUNC_HEADER.target               \
     $$NEO_SPRFUNC_HEADER.target                 \
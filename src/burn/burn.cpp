@@ -4,6 +4,9 @@
 #include "burnint.h"
 #include "timer.h"
 #include "burn_sound.h"
+#include "burn_idle.h"
+#include "burn_prof.h"
+#include "burn_pal.h"
 #include "driverlist.h"
 
 #ifndef __LIBRETRO__
@@ -60,6 +63,9 @@ bool bSaveCRoms = 0;
 
 UINT32 *pBurnDrvPalette;
 
+bool bBurnTransferDirtyLines = false;
+bool bBurnTransferDeferred = false;
+
 bool BurnCheckMMXSupport()
 {
 #if defined BUILD_X86_ASM
@@ -690,6 +696,12 @@ extern "C" INT32 BurnDrvExit()
 	pBurnDrvPalette = NULL;	
 	
 	INT32 nRet = pDriver[nBurnDrvActive]->Exit();			// Forward to drivers function
+
+	BurnIdleExit();
+	BurnPaletteExit();
+#if defined BURN_PROFILE
+	BurnProfExit();
+#endif
 	
 	BurnExitMemoryManager();
 #if defined FBA_DEBUG
@@ -737,12 +749,23 @@ extern "C" INT32 BurnDrvFrame()
 {
 	CheatApply();									// Apply cheats (if any)
 	HiscoreApply();
+
+#if defined BURN_PROFILE
+	BurnProfFrameBegin();
+	INT32 nRet = pDriver[nBurnDrvActive]->Frame();	// Forward to drivers function
+	BurnProfFrameEnd();
+
+	return nRet;
+#else
 	return pDriver[nBurnDrvActive]->Frame();		// Forward to drivers function
+#endif
 }
 
 // Force redraw of the screen
 extern "C" INT32 BurnDrvRedraw()
 {
+	BURN_PROF_SCOPE(BURN_PROF_DRAW);
+
 	if (pDriver[nBurnDrvActive]->Redraw) {
 		return pDriver[nBurnDrvActive]->Redraw();	// Forward to drivers function
 	}
@@ -753,7 +776,11 @@ extern "C" INT32 BurnDrvRedraw()
 // Refresh Palette
 extern "C" INT32 BurnRecalcPal()
 {
+	BURN_PROF_SCOPE(BURN_PROF_PALETTE);
+
 	if (nBurnDrvActive < nBurnDrvCount) {
+		BurnPaletteInvalidate();					// BurnHighCol may have changed
+
 		UINT8* pr = pDriver[nBurnDrvActive]->pRecalcPal;
 		if (pr == NULL) return 1;
 		*pr = 1;									// Signal for the driver to refresh it's palette
@@ -792,6 +819,22 @@ INT32 BurnUpdateProgress(double fProgress, const TCHAR* pszText, bool bAbs)
 
 // ----------------------------------------------------------------------------
 
+void (__cdecl *BurnExtParallelFor)(void (*pTask)(void* pParam, INT32 i), void* pParam, INT32 nCount) = NULL;
+
+void BurnParallelFor(void (*pTask)(void* pParam, INT32 i), void* pParam, INT32 nCount)
+{
+	if (BurnExtParallelFor && nCount > 1) {
+		BurnExtParallelFor(pTask, pParam, nCount);
+		return;
+	}
+
+	for (INT32 i = 0; i < nCount; i++) {
+		pTask(pParam, i);
+	}
+}
+
+// ----------------------------------------------------------------------------
+
 INT32 BurnSetRefreshRate(double dFrameRate)
 {
 	if (!bForce60Hz) {
@@ -845,6 +888,9 @@ INT32 BurnByteswap(UINT8* pMem, INT32 nLen)
 // Application-defined rom loading function:
 INT32 (__cdecl *BurnExtLoadRom)(UINT8 *Dest, INT32 *pnWrote, INT32 i) = NULL;
 
+// Application-defined rom mapping function:
+INT32 (__cdecl *BurnExtMapRom)(UINT8 **ppData, INT32 *pnLen, INT32 i) = NULL;
+
 // Application-defined colour conversion function
 static UINT32 __cdecl BurnHighColFiller(INT32, INT32, INT32, INT32) { return (UINT32)(~0); }
 UINT32 (__cdecl *BurnHighCol) (INT32 r, INT32 g, INT32 b, INT32 i) = BurnHighColFiller;
@@ -100,6 +100,8 @@ enum BurnCartrigeCommand { CART_INIT_START, CART_INIT_END, CART_EXIT };
 
 // Application-defined rom loading function
 extern INT32 (__cdecl *BurnExtLoadRom)(UINT8* Dest, INT32* pnWrote, INT32 i);
+// Application-defined rom mapping function (optional, returns a read-only view of the rom)
+extern INT32 (__cdecl *BurnExtMapRom)(UINT8** ppData, INT32* pnLen, INT32 i);
 
 // Application-defined progress indicator functions
 extern INT32 (__cdecl *BurnExtProgressRangeCallback)(double dProgressRange);
@@ -111,6 +113,10 @@ extern INT32 (__cdecl *BurnExtCartridgeSetupCallback)(BurnCartrigeCommand nComma
 // Application-defined colour conversion function
 extern UINT32 (__cdecl *BurnHighCol) (INT32 r, INT32 g, INT32 b, INT32 i);
 
+// Application-defined parallel loop (optional), must call pTask(pParam, i) once for every i < nCount,
+// on any number of threads, and only return when all calls are done
+extern void (__cdecl *BurnExtParallelFor)(void (*pTask)(void* pParam, INT32 i), void* pParam, INT32 nCount);
+
 // ---------------------------------------------------------------------------
 
 extern UINT32 nCurrentFrame;
@@ -232,6 +238,9 @@ extern clock_t starttime;					// system time when emulation started and after ro
 
 extern bool bForce60Hz;
 extern bool bBurnUseBlend;
+extern bool bBurnUseHugePages;				// Back large allocations (roms, graphics) with huge pages if the OS can
+extern bool bBurnUseGfxCache;				// Keep GfxDecode output on disk in szBurnGfxCachePath
+extern TCHAR szBurnGfxCachePath[MAX_PATH];
 
 extern INT32 nBurnFPS;
 extern INT32 nBurnCPUSpeedAdjust;
@@ -245,6 +254,8 @@ extern INT32 nMaxPlayers;
 extern UINT8 *pBurnDraw;			// Pointer to correctly sized bitmap
 extern INT32 nBurnPitch;						// Pitch between each line
 extern INT32 nBurnBpp;						// Bytes per pixel (2, 3, or 4)
+extern bool bBurnTransferDirtyLines;		// pBurnDraw keeps its contents between frames, only redraw changed lines
+extern bool bBurnTransferDeferred;			// BurnTransferCopy() only takes a snapshot, see BurnTransferDeferredTake()
 
 extern UINT8 nBurnLayer;			// Can be used externally to select which layers to show
 extern UINT8 nSpriteEnable;			// Can be used externally to select which Sprites to show
@@ -290,9 +301,14 @@ INT32 BurnDrvRedraw();
 INT32 BurnRecalcPal();
 INT32 BurnDrvGetPaletteEntries();
 
+INT32 BurnTransferDeferredTake();					// Slot of the snapshot taken during the last frame, or -1
+void BurnTransferDeferredFlush(INT32 nSlot);		// Convert a snapshot into pBurnDraw as it was at the time, any thread
+
 INT32 BurnSetProgressRange(double dProgressRange);
 INT32 BurnUpdateProgress(double dProgressStep, const TCHAR* pszText, bool bAbs);
 
+void BurnParallelFor(void (*pTask)(void* pParam, INT32 i), void* pParam, INT32 nCount);	// Runs the tasks through BurnExtParallelFor, or in order if there is none
+
 void BurnLocalisationSetName(char *szName, TCHAR *szLongName);
 
 UINT16 BurnRandom();                                // State-able Random Number Generator (0-32767)
@@ -304,6 +320,36 @@ void BurnRandomSetSeed(UINT64 nSeed);               // Set the seed - useful for
 INT32 BurnSynchroniseStream(INT32 nSoundRate);
 double BurnGetTime();
 
+// ---------------------------------------------------------------------------
+// Profiling counters, only collected when the core is built with BURN_PROFILE
+
+#define BURN_PROF_FRAME		0				// all of BurnDrvFrame()
+#define BURN_PROF_CPU		1				// inside the cpu run functions
+#define BURN_PROF_DRAW		2				// BurnDrvRedraw, BurnTransferCopy and what drivers mark
+#define BURN_PROF_SOUND		3				// the common sound chip updates and what drivers mark
+#define BURN_PROF_PALETTE	4				// palette recalculation (burn_pal, the cps / toaplan / neogeo / konami palettes)
+#define BURN_PROF_MAX		5
+
+#define BURN_PROF_MAXCPU	16
+
+struct BurnProfCpu {
+	const char* szName;
+	INT32 nCpu;
+	UINT32 nRuns;							// calls to the run function
+	INT64 nCyclesRequested;
+	INT64 nCyclesDone;
+	UINT64 nHandlerCalls[4];				// reads, writes, fetches, port accesses that went to a handler (if the cpu counts them)
+};
+
+struct BurnProfFrame {
+	UINT32 nFrame;							// nCurrentFrame when the frame was run
+	UINT64 nTime[BURN_PROF_MAX];			// nanoseconds, sections nest so they add up to more than BURN_PROF_FRAME
+	INT32 nCpuCount;
+	struct BurnProfCpu Cpu[BURN_PROF_MAXCPU];
+};
+
+INT32 BurnProfGet(struct BurnProfFrame* pFrame);	// Counters of the last frame, returns 1 if profiling isn't compiled in
+
 // ---------------------------------------------------------------------------
 // Retrieve driver information
 
@@ -451,6 +451,8 @@ void BurnGunDrawTarget(INT32 num, INT32 x, INT32 y)
 
 void BurnGunDrawTargets()
 {
+	BurnTransferInvalidate();
+
 	for (INT32 i = 0; i < nBurnGunNumPlayers; i++) {
 		BurnGunDrawTarget(i, BurnGunX[i] >> 8, BurnGunY[i] >> 8);
 	}
@@ -0,0 +1,48 @@
+// Idle loop detection, see burn_idle.h
+
+#include "burnint.h"
+#include "burn_idle.h"
+
+burn_idle BurnIdleInfo[IDLE_MAXTYPE][IDLE_MAXCPU];
+
+void BurnIdleEnable(INT32 nType, INT32 nCpu, INT32 bEnable)
+{
+	if (nType < 0 || nType >= IDLE_MAXTYPE || nCpu < 0 || nCpu >= IDLE_MAXCPU) {
+		bprintf(PRINT_ERROR, _T("BurnIdleEnable called with invalid cpu %d/%d\n"), nType, nCpu);
+		return;
+	}
+
+	burn_idle *p = &BurnIdleInfo[nType][nCpu];
+
+	p->bEnabled = bEnable ? 1 : 0;
+	p->nMatches = 0;
+}
+
+void BurnIdleReset()
+{
+	for (INT32 i = 0; i < IDLE_MAXTYPE; i++) {
+		for (INT32 j = 0; j < IDLE_MAXCPU; j++) {
+			BurnIdleInfo[i][j].nLoop = ~0;
+			BurnIdleInfo[i][j].nMatches = 0;
+		}
+	}
+}
+
+void BurnIdleExit()
+{
+	memset(BurnIdleInfo, 0, sizeof(BurnIdleInfo));
+
+	BurnIdleReset();
+}
+
+INT32 BurnIdleGetStats(INT32 nType, INT32 nCpu, UINT32 *pnDetected, UINT64 *pnCyclesSkipped)
+{
+	if (nType < 0 || nType >= IDLE_MAXTYPE || nCpu < 0 || nCpu >= IDLE_MAXCPU) return 1;
+
+	burn_idle *p = &BurnIdleInfo[nType][nCpu];
+
+	if (pnDetected) *pnDetected = p->nDetected;
+	if (pnCyclesSkipped) *pnCyclesSkipped = p->nCyclesSkipped;
+
+	return 0;
+}
@@ -0,0 +1,80 @@
+// Idle loop detection, shared by the Z80, 68000, SH-2 and ARM7 cores
+//
+// The cores count every memory / port write and call BurnIdleBranch() on taken
+// backward branches.  A short loop that comes round several times with no
+// writes and identical registers is spinning on memory nothing in this cpu
+// can change, so only an interrupt or another cpu / timer (which all happen
+// outside the current run) can get it out - the core then ends its run early.
+// Reads with time dependent results (status ports, counters) break this, so
+// detection is off unless the driver enables it per cpu with BurnIdleEnable().
+
+#define IDLE_CPU_Z80		0
+#define IDLE_CPU_SEK		1
+#define IDLE_CPU_SH2		2
+#define IDLE_CPU_ARM7		3
+#define IDLE_MAXTYPE		4
+
+#define IDLE_MAXCPU			8
+
+#define IDLE_MAXLOOP		32		// longest loop in bytes
+#define IDLE_MATCHES		3		// identical passes before the loop counts as idle
+#define IDLE_MAXREGS		96		// register snapshot size in bytes
+
+struct burn_idle {
+	INT32 bEnabled;
+
+	UINT32 nLoop;					// target of the last backward branch
+	UINT32 nWrites;					// write count when we got there
+	INT32 nMatches;
+	UINT8 nRegs[IDLE_MAXREGS];
+
+	UINT32 nDetected;				// stats
+	UINT64 nCyclesSkipped;
+};
+
+extern burn_idle BurnIdleInfo[IDLE_MAXTYPE][IDLE_MAXCPU];
+
+static inline burn_idle *BurnIdleGet(INT32 nType, INT32 nCpu)
+{
+	return &BurnIdleInfo[nType][(nCpu >= 0 && nCpu < IDLE_MAXCPU) ? nCpu : 0];
+}
+
+// Call on a taken branch from nPc to nTarget once bEnabled is checked, pRegs is
+// only read when the loop looks like a candidate.  Returns 1 if the cpu is idle.
+static inline INT32 BurnIdleBranch(burn_idle *p, UINT32 nPc, UINT32 nTarget, UINT32 nWrites, const void *pRegs, INT32 nSize)
+{
+	if (nTarget > nPc || (nPc - nTarget) > IDLE_MAXLOOP) return 0;
+
+	if (nTarget != p->nLoop || nWrites != p->nWrites) {
+		p->nLoop = nTarget;
+		p->nWrites = nWrites;
+		p->nMatches = 0;
+		return 0;
+	}
+
+	if (p->nMatches == 0 || memcmp(p->nRegs, pRegs, nSize)) {
+		memcpy(p->nRegs, pRegs, nSize);
+		p->nMatches = 1;
+		return 0;
+	}
+
+	if (++p->nMatches < IDLE_MATCHES) return 0;
+
+	p->nMatches = 0;
+	p->nDetected++;
+
+	return 1;
+}
+
+static inline void BurnIdleSkipped(burn_idle *p, INT32 nCycles)
+{
+	if (nCycles > 0) p->nCyclesSkipped += nCycles;
+}
+
+// driver whitelist
+void BurnIdleEnable(INT32 nType, INT32 nCpu, INT32 bEnable);
+
+void BurnIdleReset();
+void BurnIdleExit();
+
+INT32 BurnIdleGetStats(INT32 nType, INT32 nCpu, UINT32 *pnDetected, UINT64 *pnCyclesSkipped);
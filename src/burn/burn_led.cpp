@@ -197,6 +197,8 @@ void BurnLEDRender()
 	if (!Debug_BurnLedInitted) bprintf(PRINT_ERROR, _T("BurnLEDRender called without init\n"));
 #endif
 
+	BurnTransferInvalidate();
+
 	INT32 xpos = led_xpos;
 	INT32 ypos = led_ypos;
 	int color = BurnHighCol((led_color >> 16) & 0xff, (led_color >> 8) & 0xff, (led_color >> 0) & 0xff, 0);
@@ -1,78 +1,375 @@
 // FB Alpha memory management module
 
-// The purpose of this module is to offer replacement functions for standard C/C++ ones 
+// The purpose of this module is to offer replacement functions for standard C/C++ ones
 // that allocate and free memory.  This should help deal with the problem of memory
 // leaks and non-null pointers on game exit.
 
+// Small allocations are carved out of an arena (big blocks from the OS, handed out one
+// after the other), large ones (roms, decoded graphics) get their own block from the OS
+// so they can be returned as soon as they are freed. Fresh memory from the OS is already
+// zeroed, so only reused arena memory needs clearing. Everything still allocated is
+// released in one go by BurnExitMemoryManager.
+
 #include "burnint.h"
 
+#if defined(_WIN32)
+ #include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+ #include <sys/mman.h>
+ #define MEM_USE_MMAP
+ #if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+  #define MAP_ANONYMOUS MAP_ANON
+ #endif
+#endif
+
 //#define LOG_MEMORY_USAGE
 
-#define MAX_MEM_PTR	0x400 // more than 1024 malloc calls should be insane...
+#define MEM_ARENA_CHUNK		0x100000	// arena grows 1MB at a time
+#define MEM_LARGE		0x40000		// allocations this big or bigger don't go in the arena
+#define MEM_HUGE_PAGE		0x200000	// allocations this big or bigger may use huge pages
+#define MEM_MAX_SITES		0x400		// call sites tracked for the usage report
+
+#define MEM_MAGIC		0x4d4d5242	// 'BRMM'
+#define MEM_ARENA		(1 << 0)	// block lives in the arena
+#define MEM_FREED		(1 << 1)	// arena block was freed but can't be reused yet
+
+// placed in front of every allocation, 32 bytes to keep the data aligned
+union MemBlock {
+	struct {
+		union MemBlock *prev;		// large allocations are kept in a list
+		union MemBlock *next;
+		UINT32 size;
+		UINT16 site;
+		UINT16 flags;
+		UINT32 magic;
+	} b;
+	UINT8 align[32];
+};
+
+struct MemChunk {
+	struct MemChunk *next;
+	UINT32 size;
+	UINT32 used;
+	UINT32 dirty;				// memory below this was handed out before and isn't zero anymore
+	union MemBlock *last;			// last block handed out
+};
+
+#define MEM_CHUNK_HEADER	64		// blocks start after this in a chunk
+
+struct MemSite {
+	const char *file;
+	INT32 line;
+	INT32 count;				// live allocations
+	INT32 total;				// allocations since the last report
+	INT64 bytes;				// live bytes
+	INT64 peak;
+};
+
+bool bBurnUseHugePages = false;
 
-static UINT8 *memptr[MAX_MEM_PTR]; // pointer to allocated memory
-static INT32 memsize[MAX_MEM_PTR];
+static MemChunk *mem_chunks = NULL;		// newest first, only the first one is allocated from
+static MemBlock *mem_large = NULL;
 static INT32 mem_allocated;
 
-// this should be called early on... BurnDrvInit?
+static MemSite mem_sites[MEM_MAX_SITES];	// 0 is used when the table is full
 
-void BurnInitMemoryManager()
+// -----------------------------------------------------------------------------
+// Memory from the OS, zeroed
+
+static void *MemOSAlloc(UINT32 size, bool huge)
 {
-	memset (memptr, 0, MAX_MEM_PTR * sizeof(UINT8 **));
-	memset (memsize, 0, MAX_MEM_PTR * sizeof(INT32));
-	mem_allocated = 0;
+#if defined(_WIN32)
+	(void)huge;
+	return VirtualAlloc(NULL, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#elif defined(MEM_USE_MMAP)
+	void *ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (ptr == MAP_FAILED) return NULL;
+ #if defined(MADV_HUGEPAGE)
+	if (huge) madvise(ptr, size, MADV_HUGEPAGE);
+ #else
+	(void)huge;
+ #endif
+	return ptr;
+#else
+	(void)huge;
+	return calloc(1, size);
+#endif
+}
+
+static void MemOSFree(void *ptr, UINT32 size)
+{
+#if defined(_WIN32)
+	(void)size;
+	VirtualFree(ptr, 0, MEM_RELEASE);
+#elif defined(MEM_USE_MMAP)
+	munmap(ptr, size);
+#else
+	(void)size;
+	free(ptr);
+#endif
 }
 
-// should we pass the pointer as a variable here so that we can save a pointer to it
-// and then ensure it is NULL'd in BurnFree or BurnExitMemoryManager?
+// -----------------------------------------------------------------------------
+// Usage per call site
 
-// call instead of 'malloc'
-UINT8 *BurnMalloc(INT32 size)
+static INT32 MemSiteFind(const char *file, INT32 line)
 {
-	for (INT32 i = 0; i < MAX_MEM_PTR; i++)
+	if (file == NULL) return 0;
+
+	UINT32 hash = ((UINT32)(size_t)file >> 4) ^ (line * 0x9e3779b1);
+
+	for (INT32 i = 0; i < MEM_MAX_SITES - 1; i++)
 	{
-		if (memptr[i] == NULL) {
-			memptr[i] = (UINT8*)malloc(size);
+		INT32 n = 1 + ((hash + i) % (MEM_MAX_SITES - 1));
+
+		if (mem_sites[n].file == NULL) {
+			mem_sites[n].file = file;
+			mem_sites[n].line = line;
+			return n;
+		}
+
+		if (mem_sites[n].line == line && (mem_sites[n].file == file || strcmp(mem_sites[n].file, file) == 0)) {
+			return n;
+		}
+	}
 
-			if (memptr[i] == NULL) {
-				bprintf (0, _T("BurnMalloc failed to allocate %d bytes of memory!\n"), size);
-				return NULL;
+	return 0;
+}
+
+static void MemSiteAdd(INT32 site, INT32 size)
+{
+	MemSite *s = &mem_sites[site];
+
+	s->count++;
+	s->total++;
+	s->bytes += size;
+	if (s->bytes > s->peak) s->peak = s->bytes;
+
+	mem_allocated += size;
+}
+
+static void MemSiteRemove(INT32 site, INT32 size)
+{
+	MemSite *s = &mem_sites[site];
+
+	s->count--;
+	s->bytes -= size;
+
+	mem_allocated -= size;
+}
+
+// Print the peak usage of each call site since the last report, largest first
+void BurnMemoryReport()
+{
+	INT64 total = 0;
+
+	bprintf(PRINT_NORMAL, _T(" ** Memory usage per call site (peak bytes, allocations, still allocated):\n"));
+
+	while (1)
+	{
+		INT32 best = -1;
+
+		for (INT32 i = 0; i < MEM_MAX_SITES; i++) {
+			if (mem_sites[i].total && (best < 0 || mem_sites[i].peak > mem_sites[best].peak)) {
+				best = i;
 			}
+		}
+
+		if (best < 0) break;
+
+		MemSite *s = &mem_sites[best];
+
+		bprintf(PRINT_NORMAL, _T("    %10d %5d %10d  %hs:%d\n"), (INT32)s->peak, s->total, (INT32)s->bytes, s->file ? s->file : "(other)", s->line);
+
+		total += s->peak;
+
+		// start counting again from what is still allocated
+		s->total = 0;
+		s->peak = s->bytes;
+	}
+
+	bprintf(PRINT_NORMAL, _T("    %10d total\n"), (INT32)total);
+}
+
+// -----------------------------------------------------------------------------
+
+static inline UINT32 MemArenaSize(UINT32 size)
+{
+	return sizeof(MemBlock) + ((size + 31) & ~31);
+}
+
+static MemBlock *MemArenaAlloc(UINT32 size)
+{
+	UINT32 need = MemArenaSize(size);
+
+	MemChunk *chunk = mem_chunks;
+
+	if (chunk == NULL || chunk->used + need > chunk->size)
+	{
+		UINT32 chunk_size = MEM_ARENA_CHUNK;
+		if (MEM_CHUNK_HEADER + need > chunk_size) {
+			chunk_size = MEM_CHUNK_HEADER + need;
+		}
+
+		chunk = (MemChunk*)MemOSAlloc(chunk_size, false);
+		if (chunk == NULL) return NULL;
+
+		chunk->next = mem_chunks;
+		chunk->size = chunk_size;
+		chunk->used = MEM_CHUNK_HEADER;
+		chunk->dirty = MEM_CHUNK_HEADER;
+		chunk->last = NULL;
+		mem_chunks = chunk;
+	}
+
+	UINT8 *ptr = (UINT8*)chunk + chunk->used;
+	UINT32 end = chunk->used + need;
+
+	// this was handed out and given back before, clear it again
+	if (chunk->used < chunk->dirty) {
+		memset (ptr, 0, ((end < chunk->dirty) ? end : chunk->dirty) - chunk->used);
+	}
+
+	chunk->used = end;
+	if (end > chunk->dirty) chunk->dirty = end;
+
+	MemBlock *blk = (MemBlock*)ptr;
+	blk->b.flags = MEM_ARENA;
+	blk->b.prev = chunk->last;		// arena blocks link back to the one before them
+	blk->b.next = NULL;
+	chunk->last = blk;
+
+	return blk;
+}
+
+static void MemArenaFree(MemBlock *blk)
+{
+	MemChunk *chunk = mem_chunks;
+
+	blk->b.flags |= MEM_FREED;
+
+	if (chunk == NULL) return;
+
+	// freed blocks at the top of the current chunk can be handed out again,
+	// anything else stays until BurnExitMemoryManager
+	while (chunk->last && (chunk->last->b.flags & MEM_FREED))
+	{
+		MemBlock *last = chunk->last;
+
+		chunk->used = (UINT32)((UINT8*)last - (UINT8*)chunk);
+		chunk->last = last->b.prev;
+		last->b.magic = 0;
+	}
+}
+
+// call instead of 'malloc'
+UINT8 *_BurnMalloc(INT32 size, const char *file, INT32 line)
+{
+	if (size < 0) {
+		bprintf (0, _T("BurnMalloc failed to allocate %d bytes of memory!\n"), size);
+		return NULL;
+	}
+
+	MemBlock *blk;
 
-			memset (memptr[i], 0, size); // set contents to 0
+	if (size >= MEM_LARGE)
+	{
+		blk = (MemBlock*)MemOSAlloc(sizeof(MemBlock) + size, bBurnUseHugePages && size >= MEM_HUGE_PAGE);
 
-			mem_allocated += size;
-			memsize[i] = size;
+		if (blk) {
+			blk->b.flags = 0;
+			blk->b.prev = NULL;
+			blk->b.next = mem_large;
+			if (mem_large) mem_large->b.prev = blk;
+			mem_large = blk;
+		}
+	}
+	else
+	{
+		blk = MemArenaAlloc(size);
+	}
+
+	if (blk == NULL) {
+		bprintf (0, _T("BurnMalloc failed to allocate %d bytes of memory!\n"), size);
+		return NULL;
+	}
+
+	blk->b.size = size;
+	blk->b.site = MemSiteFind(file, line);
+	blk->b.magic = MEM_MAGIC;
+
+	MemSiteAdd(blk->b.site, size);
 
 #ifdef LOG_MEMORY_USAGE
-			bprintf (0, _T("BurnMalloc allocated %d bytes of memory (%d bytes total allocated)!\n"), size, mem_allocated);
+	bprintf (0, _T("BurnMalloc allocated %d bytes of memory (%d bytes total allocated) at %hs:%d!\n"), size, mem_allocated, file, line);
 #endif
 
-			return memptr[i];
-		}
+	return (UINT8*)(blk + 1);
+}
+
+// for callers that don't go through the macro in burnint.h
+UINT8 *(BurnMalloc)(INT32 size)
+{
+	return _BurnMalloc(size, NULL, 0);
+}
+
+// The block ptr was handed out in, NULL if it isn't a live BurnMalloc pointer.
+// Memory in front of a foreign (or already released) pointer may not even be
+// mapped, so only look at the header once the address is known to be ours.
+static MemBlock *MemFindBlock(void *ptr)
+{
+	MemBlock *blk = (MemBlock*)ptr - 1;
+
+	for (MemBlock *large = mem_large; large; large = large->b.next) {
+		if (large == blk) return blk;
 	}
 
-	bprintf (0, _T("BurnMalloc called too many times!\n"));
+	for (MemChunk *chunk = mem_chunks; chunk; chunk = chunk->next) {
+		if ((UINT8*)blk >= (UINT8*)chunk + MEM_CHUNK_HEADER && (UINT8*)blk < (UINT8*)chunk + chunk->used) {
+			return (blk->b.magic == MEM_MAGIC) ? blk : NULL;
+		}
+	}
 
-	return NULL; // Freak out!
+	return NULL;
 }
 
 // call instead of "free"
 void _BurnFree(void *ptr)
 {
-	UINT8 *mptr = (UINT8*)ptr;
+	if (ptr == NULL) return;
 
-	for (INT32 i = 0; i < MAX_MEM_PTR; i++)
-	{
-		if (memptr[i] == mptr) {
-			free (memptr[i]);
-			memptr[i] = NULL;
+	MemBlock *blk = MemFindBlock(ptr);
 
-			mem_allocated -= memsize[i];
-			memsize[i] = 0;
+	if (blk == NULL || (blk->b.flags & MEM_FREED)) {
+#if defined FBA_DEBUG
+		bprintf(PRINT_ERROR, _T("BurnFree called with memory not from BurnMalloc!\n"));
+#endif
+		return;
+	}
 
-			break;
-		}
+	MemSiteRemove(blk->b.site, blk->b.size);
+
+	if (blk->b.flags & MEM_ARENA) {
+		MemArenaFree(blk);
+		return;
+	}
+
+	if (blk->b.prev) blk->b.prev->b.next = blk->b.next; else mem_large = blk->b.next;
+	if (blk->b.next) blk->b.next->b.prev = blk->b.prev;
+
+	blk->b.magic = 0;
+
+	MemOSFree(blk, sizeof(MemBlock) + blk->b.size);
+}
+
+// this should be called early on... BurnDrvInit?
+
+void BurnInitMemoryManager()
+{
+	// start the report over, keep the sites of anything still allocated
+	for (INT32 i = 0; i < MEM_MAX_SITES; i++) {
+		mem_sites[i].total = mem_sites[i].count;
+		mem_sites[i].peak = mem_sites[i].bytes;
 	}
 }
 
@@ -80,18 +377,47 @@ void _BurnFree(void *ptr)
 
 void BurnExitMemoryManager()
 {
-	for (INT32 i = 0; i < MAX_MEM_PTR; i++)
+	while (mem_large)
 	{
-		if (memptr[i] != NULL) {
+		MemBlock *blk = mem_large;
+		mem_large = blk->b.next;
+
 #if defined FBA_DEBUG
-			bprintf(PRINT_ERROR, _T("BurnExitMemoryManager had to free mem pointer %i (%d bytes)\n"), i, memsize[i]);
+		MemSite *s = &mem_sites[blk->b.site];
+		bprintf(PRINT_ERROR, _T("BurnExitMemoryManager had to free %d bytes (%hs:%d)\n"), blk->b.size, s->file ? s->file : "?", s->line);
 #endif
-			free (memptr[i]);
-			memptr[i] = NULL;
+		MemSiteRemove(blk->b.site, blk->b.size);
+
+		blk->b.magic = 0;
+		MemOSFree(blk, sizeof(MemBlock) + blk->b.size);
+	}
+
+	// the arena goes in one go
+	while (mem_chunks)
+	{
+		MemChunk *chunk = mem_chunks;
+		mem_chunks = chunk->next;
 
-			mem_allocated -= memsize[i];
-			memsize[i] = 0;
+		for (MemBlock *blk = chunk->last; blk; blk = blk->b.prev) {
+			if (blk->b.flags & MEM_FREED) continue;
+#if defined FBA_DEBUG
+			MemSite *s = &mem_sites[blk->b.site];
+			bprintf(PRINT_ERROR, _T("BurnExitMemoryManager had to free %d bytes (%hs:%d)\n"), blk->b.size, s->file ? s->file : "?", s->line);
+#endif
+			MemSiteRemove(blk->b.site, blk->b.size);
+			blk->b.magic = 0;
 		}
+
+		MemOSFree(chunk, chunk->size);
+	}
+
+#ifdef LOG_MEMORY_USAGE
+	BurnMemoryReport();
+#endif
+
+	for (INT32 i = 0; i < MEM_MAX_SITES; i++) {
+		mem_sites[i].count = 0;
+		mem_sites[i].bytes = 0;
 	}
 
 	mem_allocated = 0;
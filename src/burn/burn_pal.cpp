@@ -1,9 +1,122 @@
 #include "burnint.h"
 #include "burn_pal.h"
+#include "burn_prof.h"
 
 UINT32 *BurnPalette = NULL;
 UINT8 *BurnPalRAM = NULL;
 
+//-------------------------------------------------------------------------------------
+// Lazy recalculation
+//
+// Most drivers map BurnPalRAM straight into the cpu and call a full update every
+// frame.  The update functions keep a copy of the palette ram as it was when
+// BurnPalette was last converted and only convert entries that changed since,
+// scanning 4 entries (8 bytes) at a time.  Converted colours are also cached by
+// rgb value, so palette cycling doesn't call BurnHighCol for colours seen before.
+// Everything is thrown away when BurnHighCol changes (BurnRecalcPal).
+
+static UINT8 *PalShadow = NULL;			// palette ram as of the last update
+static INT32 nPalShadowSize = 0;
+static INT32 nPalShadowFormat = -1;		// update function that filled it
+static UINT8 *PalShadowRAM = NULL;
+static UINT32 *PalShadowPalette = NULL;
+
+static UINT32 *PalCache = NULL;			// BurnHighCol results for 4 or 5 bit rgb
+static UINT32 *PalCacheValid = NULL;	// one bit per PalCache entry
+static INT32 nPalCacheBits = 0;
+
+static UINT32 (__cdecl *PalHighCol)(INT32 r, INT32 g, INT32 b, INT32 i) = NULL;
+
+#define PAL_FORMAT(bits, r, g, b)	(((bits) << 16) | ((r) << 10) | ((g) << 5) | (b))
+
+void BurnPaletteInvalidate()
+{
+	nPalShadowFormat = -1;
+
+	if (PalCacheValid) {
+		memset(PalCacheValid, 0, (1 << (nPalCacheBits * 3)) / 8);
+	}
+}
+
+void BurnPaletteExit()
+{
+	BurnFree(PalShadow);
+	BurnFree(PalCache);
+	BurnFree(PalCacheValid);
+
+	nPalShadowSize = 0;
+	nPalShadowFormat = -1;
+	nPalCacheBits = 0;
+	PalHighCol = NULL;
+}
+
+// returns 1 if every entry has to be converted (the shadow is then filled by the caller)
+static INT32 PaletteShadowStart(INT32 nFormat, INT32 nSize)
+{
+	if (PalHighCol != BurnHighCol) {
+		PalHighCol = BurnHighCol;
+		BurnPaletteInvalidate();
+	}
+
+	if (nPalShadowFormat == nFormat && nPalShadowSize == nSize && PalShadowRAM == BurnPalRAM && PalShadowPalette == BurnPalette) {
+		return 0;
+	}
+
+	if (nPalShadowSize != nSize) {
+		BurnFree(PalShadow);
+		PalShadow = (UINT8*)BurnMalloc(nSize);
+		nPalShadowSize = nSize;
+	}
+
+	nPalShadowFormat = nFormat;
+	PalShadowRAM = BurnPalRAM;
+	PalShadowPalette = BurnPalette;
+
+	return 1;
+}
+
+static inline UINT32 PaletteCacheColour(INT32 nBits, INT32 r, INT32 g, INT32 b, INT32 r8, INT32 g8, INT32 b8)
+{
+	if (nPalCacheBits != nBits) {
+		BurnFree(PalCache);
+		BurnFree(PalCacheValid);
+		PalCache = (UINT32*)BurnMalloc((1 << (nBits * 3)) * sizeof(UINT32));
+		PalCacheValid = (UINT32*)BurnMalloc((1 << (nBits * 3)) / 8);
+		memset(PalCacheValid, 0, (1 << (nBits * 3)) / 8);
+		nPalCacheBits = nBits;
+	}
+
+	INT32 nKey = (r << (nBits * 2)) | (g << nBits) | b;
+
+	if ((PalCacheValid[nKey >> 5] & (1 << (nKey & 0x1f))) == 0) {
+		PalCache[nKey] = BurnHighCol(r8, g8, b8, 0);
+		PalCacheValid[nKey >> 5] |= 1 << (nKey & 0x1f);
+	}
+
+	return PalCache[nKey];
+}
+
+// next entry at or after i that differs from the shadow, nEntries if none
+static inline INT32 PaletteNextDirty16(const UINT16 *pal, const UINT16 *old, INT32 i, INT32 nEntries)
+{
+	while (i < nEntries) {
+		if ((i & 3) == 0 && (i + 4) <= nEntries) {
+			UINT64 a, b;
+			memcpy(&a, pal + i, sizeof(a));
+			memcpy(&b, old + i, sizeof(b));
+			if (a == b) {
+				i += 4;
+				continue;
+			}
+		}
+
+		if (pal[i] != old[i]) break;
+		i++;
+	}
+
+	return i;
+}
+
 //-------------------------------------------------------------------------------------
 
 static inline UINT32 PaletteWrite4Bit(INT32 offset, INT32 rshift, INT32 gshift, INT32 bshift)
@@ -17,17 +130,35 @@ static inline UINT32 PaletteWrite4Bit(INT32 offset, INT32 rshift, INT32 gshift,
 	UINT8 g = (p >> gshift) & 0xf;
 	UINT8 b = (p >> bshift) & 0xf;
 
-	return BurnHighCol(r+(r*16), b+(b*16), g+(g*16), 0);	
+	return PaletteCacheColour(4, r, g, b, r+(r*16), b+(b*16), g+(g*16));
 }
 
 static inline void PaletteUpdate4Bit(INT32 rshift, INT32 gshift, INT32 bshift)
 {
-	if (BurnPalette == NULL) return;
+	if (BurnPalette == NULL || BurnPalRAM == NULL) return;
 
-	for (INT32 i = 0; i < BurnDrvGetPaletteEntries(); i++)
-	{
-		BurnPalette[i] = PaletteWrite4Bit(i, rshift, gshift,  bshift);
+	BURN_PROF_BEGIN(BURN_PROF_PALETTE);
+
+	INT32 nEntries = BurnDrvGetPaletteEntries();
+	UINT16 *pal = (UINT16*)BurnPalRAM;
+
+	if (PaletteShadowStart(PAL_FORMAT(4, rshift, gshift, bshift), nEntries * sizeof(UINT16))) {
+		for (INT32 i = 0; i < nEntries; i++)
+		{
+			BurnPalette[i] = PaletteWrite4Bit(i, rshift, gshift,  bshift);
+		}
+	} else {
+		UINT16 *old = (UINT16*)PalShadow;
+
+		for (INT32 i = PaletteNextDirty16(pal, old, 0, nEntries); i < nEntries; i = PaletteNextDirty16(pal, old, i + 1, nEntries))
+		{
+			BurnPalette[i] = PaletteWrite4Bit(i, rshift, gshift,  bshift);
+		}
 	}
+
+	memcpy(PalShadow, pal, nEntries * sizeof(UINT16));
+
+	BURN_PROF_END(BURN_PROF_PALETTE);
 }
 
 void BurnPaletteUpdate_xxxxBBBBGGGGRRRR()
@@ -79,21 +210,35 @@ static inline UINT32 PaletteWrite5Bit(INT32 offset, INT32 rshift, INT32 gshift,
 	UINT8 g = (p >> gshift) & 0x1f;
 	UINT8 b = (p >> bshift) & 0x1f;
 
-	r = (r * 8) + (r / 4);
-	g = (g * 8) + (g / 4);
-	b = (b * 8) + (b / 4);
-
-	return BurnHighCol(r, g, b, 0);
+	return PaletteCacheColour(5, r, g, b, (r * 8) + (r / 4), (g * 8) + (g / 4), (b * 8) + (b / 4));
 }
 
 static inline void PaletteUpdate5Bit(INT32 rshift, INT32 gshift, INT32 bshift)
 {
-	if (BurnPalette == NULL) return;
+	if (BurnPalette == NULL || BurnPalRAM == NULL) return;
 
-	for (INT32 i = 0; i < BurnDrvGetPaletteEntries(); i++)
-	{
-		BurnPalette[i] = PaletteWrite5Bit(i, rshift, gshift,  bshift);
+	BURN_PROF_BEGIN(BURN_PROF_PALETTE);
+
+	INT32 nEntries = BurnDrvGetPaletteEntries();
+	UINT16 *pal = (UINT16*)BurnPalRAM;
+
+	if (PaletteShadowStart(PAL_FORMAT(5, rshift, gshift, bshift), nEntries * sizeof(UINT16))) {
+		for (INT32 i = 0; i < nEntries; i++)
+		{
+			BurnPalette[i] = PaletteWrite5Bit(i, rshift, gshift,  bshift);
+		}
+	} else {
+		UINT16 *old = (UINT16*)PalShadow;
+
+		for (INT32 i = PaletteNextDirty16(pal, old, 0, nEntries); i < nEntries; i = PaletteNextDirty16(pal, old, i + 1, nEntries))
+		{
+			BurnPalette[i] = PaletteWrite5Bit(i, rshift, gshift,  bshift);
+		}
 	}
+
+	memcpy(PalShadow, pal, nEntries * sizeof(UINT16));
+
+	BURN_PROF_END(BURN_PROF_PALETTE);
 }
 
 void BurnPaletteUpdate_xRRRRRGGGGGBBBBB()
@@ -168,26 +313,44 @@ void BurnPaletteWrite_GGGGGRRRRRBBBBBx(INT32 offset)
 
 //-------------------------------------------------------------------------------------
 
+static inline UINT32 PaletteWriteRGBx(INT32 offset)
+{
+	UINT16 *pal = (UINT16*)BurnPalRAM;
+	UINT16 p = BURN_ENDIAN_SWAP_INT16(pal[offset]);
+
+	UINT8 r = ((p >>  11) & 0x1e) | ((p >> 3) & 0x01);
+	UINT8 g = ((p >>   7) & 0x1e) | ((p >> 2) & 0x01);
+	UINT8 b = ((p >>   3) & 0x1e) | ((p >> 1) & 0x01);
+
+	return PaletteCacheColour(5, r, g, b, (r * 8) + (r / 4), (g * 8) + (g / 4), (b * 8) + (b / 4));
+}
+
 void BurnPaletteUpdate_RRRRGGGGBBBBRGBx()
 {
 	if (BurnPalRAM == NULL || BurnPalette == NULL) return;
 
-	UINT16 *pal = (UINT16*)BurnPalRAM;
+	BURN_PROF_BEGIN(BURN_PROF_PALETTE);
 
-	for (INT32 i = 0; i < BurnDrvGetPaletteEntries(); i++)
-	{
-		UINT16 p = BURN_ENDIAN_SWAP_INT16(pal[i]);
+	INT32 nEntries = BurnDrvGetPaletteEntries();
+	UINT16 *pal = (UINT16*)BurnPalRAM;
 
-		UINT8 r = ((p >>  11) & 0x1e) | ((p >> 3) & 0x01);
-		UINT8 g = ((p >>   7) & 0x1e) | ((p >> 2) & 0x01);
-		UINT8 b = ((p >>   3) & 0x1e) | ((p >> 1) & 0x01);
+	if (PaletteShadowStart(PAL_FORMAT(5, 0x1f, 0x1f, 0x1f), nEntries * sizeof(UINT16))) {
+		for (INT32 i = 0; i < nEntries; i++)
+		{
+			BurnPalette[i] = PaletteWriteRGBx(i);
+		}
+	} else {
+		UINT16 *old = (UINT16*)PalShadow;
+
+		for (INT32 i = PaletteNextDirty16(pal, old, 0, nEntries); i < nEntries; i = PaletteNextDirty16(pal, old, i + 1, nEntries))
+		{
+			BurnPalette[i] = PaletteWriteRGBx(i);
+		}
+	}
 
-		r = (r * 8) + (r / 4);
-		g = (g * 8) + (g / 4);
-		b = (b * 8) + (b / 4);
+	memcpy(PalShadow, pal, nEntries * sizeof(UINT16));
 
-		BurnPalette[i] = BurnHighCol(r, g, b, 0);
-	}	
+	BURN_PROF_END(BURN_PROF_PALETTE);
 }
 
 void BurnPaletteWrite_RRRRGGGGBBBBRGBx(INT32 offset)
@@ -196,18 +359,7 @@ void BurnPaletteWrite_RRRRGGGGBBBBRGBx(INT32 offset)
 
 	offset /= 2;
 
-	UINT16 *pal = (UINT16*)BurnPalRAM;
-	UINT16 p = BURN_ENDIAN_SWAP_INT16(pal[offset]);
-
-	UINT8 r = ((p >>  11) & 0x1e) | ((p >> 3) & 0x01);
-	UINT8 g = ((p >>   7) & 0x1e) | ((p >> 2) & 0x01);
-	UINT8 b = ((p >>   3) & 0x1e) | ((p >> 1) & 0x01);
-
-	r = (r * 8) + (r / 4);
-	g = (g * 8) + (g / 4);
-	b = (b * 8) + (b / 4);
-
-	BurnPalette[offset] = BurnHighCol(r, g, b, 0);
+	BurnPalette[offset] = PaletteWriteRGBx(offset);
 }
 
 //-------------------------------------------------------------------------------------
@@ -216,13 +368,22 @@ static inline void palette_update_8bit(INT32 r_mask, INT32 g_mask, INT32 b_mask,
 {
 	if (BurnPalRAM == NULL || BurnPalette == NULL) return;
 
+	INT32 nFormat = PAL_FORMAT(8, r_shift, g_shift, b_shift) | (invert << 15);
+
 	r_mask = (1 << r_mask) - 1;
 	g_mask = (1 << g_mask) - 1;
 	b_mask = (1 << b_mask) - 1;
 	invert = (invert) ? 0xff : 0;
 
-	for (INT32 i = 0; i < BurnDrvGetPaletteEntries(); i++)
+	BURN_PROF_BEGIN(BURN_PROF_PALETTE);
+
+	INT32 nEntries = BurnDrvGetPaletteEntries();
+	INT32 bAll = PaletteShadowStart(nFormat, nEntries);
+
+	for (INT32 i = 0; i < nEntries; i++)
 	{
+		if (!bAll && BurnPalRAM[i] == PalShadow[i]) continue;
+
 		UINT8 p = BurnPalRAM[i] ^ invert;
 		UINT8 r = (p >> r_shift) & r_mask;
 		UINT8 g = (p >> g_shift) & g_mask;
@@ -239,6 +400,10 @@ static inline void palette_update_8bit(INT32 r_mask, INT32 g_mask, INT32 b_mask,
 
 		BurnPalette[i] = BurnHighCol(r,g,b,0);
 	}
+
+	memcpy(PalShadow, BurnPalRAM, nEntries);
+
+	BURN_PROF_END(BURN_PROF_PALETTE);
 }
 
 void BurnPaletteUpdate_BBGGGRRR()
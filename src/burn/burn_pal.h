@@ -5,7 +5,8 @@
 extern UINT32 *BurnPalette;
 extern UINT8 *BurnPalRAM;
 
-// palette update functions are called to recalculate the entire palette
+// palette update functions are called to recalculate the entire palette, only
+// entries that changed since the last call are converted again
 
 void BurnPaletteUpdate_xxxxBBBBRRRRGGGG();
 void BurnPaletteUpdate_xxxxBBBBGGGGRRRR();
@@ -21,6 +22,10 @@ void BurnPaletteUpdate_RRRGGGBB();
 void BurnPaletteUpdate_BBGGGRRR_inverted();
 void BurnPaletteUpdate_RRRGGGBB_inverted();
 
+// forget the converted palette (BurnRecalcPal calls this when BurnHighCol changes)
+void BurnPaletteInvalidate();
+void BurnPaletteExit();
+
 // palette write functions called to write single palette entry
 // note that the offset should not be shifted, only masked for palette size
 
@@ -0,0 +1,164 @@
+// Profiling counters, see burn_prof.h
+
+#include "burnint.h"
+#include "burn_prof.h"
+
+#if defined BURN_PROFILE
+
+#if defined _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+struct prof_cpu {
+	cpu_core_config *config;
+	UINT64 nCountersLast[CPU_COUNTER_MAX];	// config->counters() at the start of the frame
+};
+
+static BurnProfFrame ProfCurrent;
+static BurnProfFrame ProfLast;
+static prof_cpu ProfCpus[BURN_PROF_MAXCPU];
+
+static INT32 nProfDepth[BURN_PROF_MAX];
+static INT64 nProfStart[BURN_PROF_MAX];
+static INT32 bProfValid = 0;
+
+static inline INT64 prof_now()
+{
+#if defined _WIN32
+	static LARGE_INTEGER nFreq;
+	LARGE_INTEGER nCount;
+
+	if (nFreq.QuadPart == 0) QueryPerformanceFrequency(&nFreq);
+	QueryPerformanceCounter(&nCount);
+
+	return (INT64)((double)nCount.QuadPart * 1000000000.0 / (double)nFreq.QuadPart);
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (INT64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+void BurnProfBegin(INT32 nSection)
+{
+	if (nProfDepth[nSection]++ == 0) {
+		nProfStart[nSection] = prof_now();
+	}
+}
+
+void BurnProfEnd(INT32 nSection)
+{
+	if (nProfDepth[nSection] <= 0) return;
+
+	if (--nProfDepth[nSection] == 0) {
+		ProfCurrent.nTime[nSection] += prof_now() - nProfStart[nSection];
+	}
+}
+
+static INT32 prof_find_cpu(const char *szName, cpu_core_config *config, INT32 nCpu)
+{
+	for (INT32 i = 0; i < ProfCurrent.nCpuCount; i++) {
+		if (ProfCpus[i].config == config && ProfCurrent.Cpu[i].nCpu == nCpu) return i;
+	}
+
+	if (ProfCurrent.nCpuCount >= BURN_PROF_MAXCPU) return -1;
+
+	INT32 i = ProfCurrent.nCpuCount++;
+
+	ProfCpus[i].config = config;
+	memset(ProfCpus[i].nCountersLast, 0, sizeof(ProfCpus[i].nCountersLast));
+	if (config && config->counters) {
+		config->counters(nCpu, ProfCpus[i].nCountersLast);
+	}
+
+	ProfCurrent.Cpu[i].szName = szName;
+	ProfCurrent.Cpu[i].nCpu = nCpu;
+
+	return i;
+}
+
+void BurnProfCpuRun(const char *szName, cpu_core_config *config, INT32 nCpu, INT32 nRequested, INT32 nDone)
+{
+	INT32 i = prof_find_cpu(szName, config, nCpu);
+	if (i < 0) return;
+
+	BurnProfCpu *p = &ProfCurrent.Cpu[i];
+
+	p->nRuns++;
+	p->nCyclesRequested += nRequested;
+	p->nCyclesDone += nDone;
+}
+
+void BurnProfFrameBegin()
+{
+	// keep the cpu list (and their counter baselines) from frame to frame
+	for (INT32 i = 0; i < ProfCurrent.nCpuCount; i++) {
+		BurnProfCpu *p = &ProfCurrent.Cpu[i];
+
+		p->nRuns = 0;
+		p->nCyclesRequested = 0;
+		p->nCyclesDone = 0;
+		memset(p->nHandlerCalls, 0, sizeof(p->nHandlerCalls));
+	}
+
+	memset(ProfCurrent.nTime, 0, sizeof(ProfCurrent.nTime));
+	memset(nProfDepth, 0, sizeof(nProfDepth));
+
+	ProfCurrent.nFrame = nCurrentFrame;
+
+	BurnProfBegin(BURN_PROF_FRAME);
+}
+
+void BurnProfFrameEnd()
+{
+	BurnProfEnd(BURN_PROF_FRAME);
+
+	for (INT32 i = 0; i < ProfCurrent.nCpuCount; i++) {
+		prof_cpu *c = &ProfCpus[i];
+		if (c->config == NULL || c->config->counters == NULL) continue;
+
+		UINT64 nCounters[CPU_COUNTER_MAX];
+		c->config->counters(ProfCurrent.Cpu[i].nCpu, nCounters);
+
+		for (INT32 j = 0; j < CPU_COUNTER_MAX; j++) {
+			ProfCurrent.Cpu[i].nHandlerCalls[j] = nCounters[j] - c->nCountersLast[j];
+			c->nCountersLast[j] = nCounters[j];
+		}
+	}
+
+	memcpy(&ProfLast, &ProfCurrent, sizeof(BurnProfFrame));
+	bProfValid = 1;
+}
+
+void BurnProfExit()
+{
+	memset(&ProfCurrent, 0, sizeof(ProfCurrent));
+	memset(&ProfLast, 0, sizeof(ProfLast));
+	memset(ProfCpus, 0, sizeof(ProfCpus));
+	memset(nProfDepth, 0, sizeof(nProfDepth));
+
+	bProfValid = 0;
+}
+
+INT32 BurnProfGet(BurnProfFrame* pFrame)
+{
+	if (pFrame == NULL || !bProfValid) return 1;
+
+	memcpy(pFrame, &ProfLast, sizeof(BurnProfFrame));
+
+	return 0;
+}
+
+#else
+
+INT32 BurnProfGet(BurnProfFrame* pFrame)
+{
+	if (pFrame) memset(pFrame, 0, sizeof(BurnProfFrame));
+
+	return 1;
+}
+
+#endif
@@ -0,0 +1,60 @@
+// Profiling counters (see BurnProfFrame in burn.h)
+//
+// Everything here compiles to nothing unless BURN_PROFILE is defined, so the
+// hooks can stay in hot paths. Sections may nest (a sound chip updated from
+// a cpu handler counts as both cpu and sound), but a section only counts
+// time in its outermost Begin / End pair.
+//
+// BURN_PROF_SCOPE(n) times section n until the end of the enclosing block.
+// Every cpu_core_config run function starts with BURN_PROF_CPU_SCOPE, which
+// times the run and takes the cycles done from config->totalcycles().
+
+#if defined BURN_PROFILE
+
+void BurnProfBegin(INT32 nSection);
+void BurnProfEnd(INT32 nSection);
+void BurnProfCpuRun(const char *szName, cpu_core_config *config, INT32 nCpu, INT32 nRequested, INT32 nDone);
+
+void BurnProfFrameBegin();
+void BurnProfFrameEnd();
+void BurnProfExit();
+
+struct BurnProfScope {
+	INT32 nSection;
+
+	BurnProfScope(INT32 n) : nSection(n) { BurnProfBegin(nSection); }
+	~BurnProfScope() { BurnProfEnd(nSection); }
+};
+
+struct BurnProfCpuScope {
+	const char *szName;
+	cpu_core_config *pConfig;
+	INT32 nRequested;
+	INT32 nStart;
+
+	BurnProfCpuScope(const char *name, cpu_core_config *config, INT32 nCycles) : szName(name), pConfig(config), nRequested(nCycles)
+	{
+		BurnProfBegin(BURN_PROF_CPU);
+		nStart = pConfig->totalcycles();
+	}
+
+	~BurnProfCpuScope()
+	{
+		BurnProfCpuRun(szName, pConfig, pConfig->active(), nRequested, pConfig->totalcycles() - nStart);
+		BurnProfEnd(BURN_PROF_CPU);
+	}
+};
+
+#define BURN_PROF_BEGIN(n)								BurnProfBegin(n)
+#define BURN_PROF_END(n)								BurnProfEnd(n)
+#define BURN_PROF_SCOPE(n)								BurnProfScope ProfScope(n)
+#define BURN_PROF_CPU_SCOPE(name, config, cycles)		BurnProfCpuScope ProfCpuScope(name, config, cycles)
+
+#else
+
+#define BURN_PROF_BEGIN(n)
+#define BURN_PROF_END(n)
+#define BURN_PROF_SCOPE(n)
+#define BURN_PROF_CPU_SCOPE(name, config, cycles)
+
+#endif
@@ -0,0 +1,302 @@
+// Central cpu scheduler
+//
+// Every cpu is run, in the order it was added, up to the current deadline.
+// Deadlines are the line boundaries set with BurnSchedSetLines, or the next
+// BurnTimer expiry if that comes first. A cpu that calls BurnSchedSync() has
+// the cpus after it run up to its own position before it carries on, so they
+// see the event when it happens. Time is kept in timer ticks (see timer.h) so
+// cpus with different clocks share one time base.
+
+#include "burnint.h"
+#include "timer.h"
+#include "burn_sched.h"
+
+struct sched_cpu {
+	cpu_core_config *config;
+	INT32 nCpu;
+	INT32 nClockspeed;
+
+	INT32 nCyclesFrame;		// cycles in one frame
+	INT32 nCyclesDone;		// cycles done this frame (as of the last slice)
+	INT32 nCyclesExtra;		// cycles run past the end of the previous frame
+
+	// sound chip timer driven by this cpu
+	INT32 (*pTimerUpdate)(INT32);
+	void (*pTimerEndFrame)(INT32);
+	void (*pTimerUpdateEnd)();
+};
+
+static sched_cpu sched_cpus[SCHED_MAXCPU];
+static INT32 nSchedCpus = 0;
+static INT32 nSchedActive = -1;
+static INT32 bSchedCatchUp = 0;
+
+static INT32 nSchedLines = 1;
+static void (*pSchedLineCallback)(INT32) = NULL;
+
+static INT64 nSchedTicksFrame = 0;
+static INT64 nSchedSliceEnd = 0;
+
+static inline INT64 sched_ticks(sched_cpu *c, INT32 nCycles)
+{
+	return MAKE_TIMER_TICKS(nCycles, c->nClockspeed);
+}
+
+static inline INT32 sched_cycles(sched_cpu *c, INT64 nTicks)
+{
+	if (nTicks >= nSchedTicksFrame) return c->nCyclesFrame;
+
+	return (INT32)MAKE_CPU_CYLES(nTicks, c->nClockspeed);
+}
+
+// cpu must be open
+static inline INT32 sched_cycles_done(sched_cpu *c)
+{
+	return c->nCyclesExtra + c->config->totalcycles();
+}
+
+static void sched_run_cpu(INT32 nSlot, INT32 nTarget)
+{
+	sched_cpu *c = &sched_cpus[nSlot];
+
+	c->config->open(c->nCpu);
+
+	nSchedActive = nSlot;
+
+	if (c->pTimerUpdate) {
+		c->pTimerUpdate(nTarget);
+	} else {
+		INT32 nDone = sched_cycles_done(c);
+		if (nTarget > nDone) {
+			c->config->run(nTarget - nDone);
+		}
+	}
+
+	nSchedActive = -1;
+
+	c->nCyclesDone = sched_cycles_done(c);
+	c->config->close();
+}
+
+// end the slice just past the next timer expiry, so whatever the timer
+// raises is seen by the other cpus from the next slice on
+static INT64 sched_timer_deadline(INT64 nDeadline)
+{
+	for (INT32 i = 0; i < nSchedCpus; i++) {
+		sched_cpu *c = &sched_cpus[i];
+		if (c->pTimerUpdate == NULL) continue;
+
+		c->config->open(c->nCpu);
+		INT32 nDone = sched_cycles_done(c);
+		INT32 nNext = BurnTimerCyclesToNext();
+		c->config->close();
+
+		// + 2 covers the rounding of the cycles -> ticks -> cycles round trip
+		if (nNext < c->nCyclesFrame - nDone) {
+			INT64 nTicks = sched_ticks(c, nDone + nNext + 2);
+			if (nTicks < nDeadline) nDeadline = nTicks;
+		}
+
+		break;
+	}
+
+	return nDeadline;
+}
+
+static void sched_run(INT64 nDeadline)
+{
+	do {
+		nSchedSliceEnd = sched_timer_deadline(nDeadline);
+
+		for (INT32 i = 0; i < nSchedCpus; i++) {
+			sched_cpu *c = &sched_cpus[i];
+
+			INT32 nTarget = sched_cycles(c, nSchedSliceEnd);
+			if (nTarget <= c->nCyclesDone) continue; // ahead already
+
+			sched_run_cpu(i, nTarget);
+		}
+	} while (nSchedSliceEnd < nDeadline);
+}
+
+void BurnSchedSync()
+{
+	if (nSchedActive < 0) return;
+
+	INT32 nActive = nSchedActive;
+	sched_cpu *c = &sched_cpus[nActive];
+
+	INT64 nNow = sched_ticks(c, sched_cycles_done(c));
+	if (nNow >= nSchedSliceEnd) return;
+
+	// run the cpus after this one up to now, a core can't be switched to
+	// another cpu from inside its own run though, and a cpu that is being
+	// caught up doesn't start another catch up
+	INT32 bBehind = 0;
+
+	for (INT32 i = nActive + 1; i < nSchedCpus; i++) {
+		sched_cpu *d = &sched_cpus[i];
+
+		INT32 nTarget = sched_cycles(d, nNow);
+		if (nTarget <= d->nCyclesDone) continue;
+
+		if (bSchedCatchUp || d->config == c->config) {
+			bBehind = 1;
+			continue;
+		}
+
+		bSchedCatchUp = 1;
+		sched_run_cpu(i, nTarget);
+		bSchedCatchUp = 0;
+	}
+
+	nSchedActive = nActive;
+
+	if (!bBehind) return;
+
+	// the rest catch up once this cpu has stopped here
+	nSchedSliceEnd = nNow;
+
+	if (c->pTimerUpdateEnd) {
+		c->pTimerUpdateEnd();
+	} else {
+		c->config->runend();
+	}
+}
+
+INT32 BurnSchedGetLine()
+{
+	INT64 nNow = nSchedSliceEnd;
+
+	if (nSchedActive >= 0) {
+		sched_cpu *c = &sched_cpus[nSchedActive];
+		nNow = sched_ticks(c, sched_cycles_done(c));
+	}
+
+	if (nSchedTicksFrame == 0) return 0;
+
+	INT32 nLine = (INT32)(nNow * nSchedLines / nSchedTicksFrame);
+
+	return (nLine < nSchedLines) ? nLine : (nSchedLines - 1);
+}
+
+INT32 BurnSchedFrame()
+{
+	nSchedTicksFrame = (INT64)TIMER_TICKS_PER_SECOND * 100 / nBurnFPS;
+
+	for (INT32 i = 0; i < nSchedCpus; i++) {
+		sched_cpu *c = &sched_cpus[i];
+
+		// newframe resets every cpu of that type, so only call it once per type
+		INT32 j = 0;
+		while (j < i && sched_cpus[j].config != c->config) j++;
+		if (j == i) c->config->newframe();
+
+		c->nCyclesFrame = (INT32)((INT64)c->nClockspeed * 100 / nBurnFPS);
+		c->nCyclesDone = c->nCyclesExtra;
+	}
+
+	for (INT32 i = 0; i < nSchedLines; i++) {
+		sched_run(nSchedTicksFrame * (i + 1) / nSchedLines);
+
+		if (pSchedLineCallback) {
+			pSchedLineCallback(i);
+		}
+	}
+
+	nSchedSliceEnd = 0;
+
+	for (INT32 i = 0; i < nSchedCpus; i++) {
+		sched_cpu *c = &sched_cpus[i];
+
+		if (c->pTimerEndFrame) {
+			// the timer keeps its own overrun
+			c->config->open(c->nCpu);
+			c->pTimerEndFrame(c->nCyclesFrame);
+			c->config->close();
+		} else {
+			c->nCyclesExtra = c->nCyclesDone - c->nCyclesFrame;
+			if (c->nCyclesExtra < 0) c->nCyclesExtra = 0;
+		}
+	}
+
+	return 0;
+}
+
+INT32 BurnSchedAddCpu(cpu_core_config *config, INT32 nCpu, INT32 nClockspeed)
+{
+	if (nSchedCpus >= SCHED_MAXCPU) {
+		bprintf(PRINT_ERROR, _T("BurnSchedAddCpu called with too many cpus (max %d)\n"), SCHED_MAXCPU);
+		return -1;
+	}
+
+	sched_cpu *c = &sched_cpus[nSchedCpus];
+	memset(c, 0, sizeof(sched_cpu));
+
+	c->config = config;
+	c->nCpu = nCpu;
+	c->nClockspeed = nClockspeed;
+
+	return nSchedCpus++;
+}
+
+void BurnSchedAttachTimer(INT32 nSlot, INT32 (*pUpdate)(INT32), void (*pEndFrame)(INT32), void (*pUpdateEnd)())
+{
+	if (nSlot < 0 || nSlot >= nSchedCpus) return;
+
+	sched_cpu *c = &sched_cpus[nSlot];
+
+	c->pTimerUpdate = pUpdate;
+	c->pTimerEndFrame = pEndFrame;
+	c->pTimerUpdateEnd = pUpdateEnd;
+}
+
+void BurnSchedSetLines(INT32 nLines, void (*pLineCallback)(INT32))
+{
+	nSchedLines = (nLines > 0) ? nLines : 1;
+	pSchedLineCallback = pLineCallback;
+}
+
+void BurnSchedReset()
+{
+	for (INT32 i = 0; i < nSchedCpus; i++) {
+		sched_cpus[i].nCyclesDone = 0;
+		sched_cpus[i].nCyclesExtra = 0;
+	}
+
+	nSchedActive = -1;
+	bSchedCatchUp = 0;
+	nSchedSliceEnd = 0;
+}
+
+void BurnSchedInit()
+{
+	memset(sched_cpus, 0, sizeof(sched_cpus));
+	nSchedCpus = 0;
+
+	nSchedLines = 1;
+	pSchedLineCallback = NULL;
+	nSchedTicksFrame = 0;
+
+	BurnSchedReset();
+}
+
+void BurnSchedExit()
+{
+	BurnSchedInit();
+}
+
+INT32 BurnSchedScan(INT32 nAction, INT32 *pnMin)
+{
+	if (pnMin && *pnMin < 0x029744) {
+		*pnMin = 0x029744;
+	}
+
+	if (nAction & ACB_DRIVER_DATA) {
+		for (INT32 i = 0; i < nSchedCpus; i++) {
+			SCAN_VAR(sched_cpus[i].nCyclesExtra);
+		}
+	}
+
+	return 0;
+}
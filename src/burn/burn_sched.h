@@ -0,0 +1,30 @@
+// Central cpu scheduler
+//
+// Runs every registered cpu to the next deadline (end of a line, or the next
+// BurnTimer expiry) instead of hand-written nInterleave loops.
+// For how-to, search BurnSched in pst90s/d_crospang.cpp
+
+#define SCHED_MAXCPU		8
+
+void BurnSchedInit();
+void BurnSchedReset();
+void BurnSchedExit();
+
+// add a cpu (nCpu is the number passed to config->open), returns its slot
+INT32 BurnSchedAddCpu(cpu_core_config *config, INT32 nCpu, INT32 nClockspeed);
+
+// the cpu in nSlot drives a sound chip timer (BurnTimerUpdate & co)
+void BurnSchedAttachTimer(INT32 nSlot, INT32 (*pUpdate)(INT32), void (*pEndFrame)(INT32), void (*pUpdateEnd)());
+
+// split the frame in nLines deadlines, pLineCallback is called (with no cpu open) after each
+void BurnSchedSetLines(INT32 nLines, void (*pLineCallback)(INT32 nLine));
+
+// call from a cpu's handler on a cross-cpu event (soundlatch etc.) before
+// making the change, the cpus after this one are run up to this point first
+void BurnSchedSync();
+
+// current line, as seen by the running cpu
+INT32 BurnSchedGetLine();
+
+INT32 BurnSchedFrame();
+INT32 BurnSchedScan(INT32 nAction, INT32 *pnMin);
@@ -340,6 +340,8 @@ void BurnShiftRender()
 
 	if (!BurnShiftEnabled) return;
 
+	BurnTransferInvalidate();
+
 	INT32 xpos = shift_xpos;
 	INT32 ypos = shift_ypos;
 	INT32 color = BurnHighCol((shift_color >> 16) & 0xff, (shift_color >> 8) & 0xff, (shift_color >> 0) & 0xff, 0);
@@ -110,6 +110,7 @@ INT32 BurnClearScreen();
 INT32 BurnLoadRomExt(UINT8 *Dest, INT32 i, INT32 nGap, INT32 nFlags);
 INT32 BurnLoadRom(UINT8* Dest, INT32 i, INT32 nGap);
 INT32 BurnXorRom(UINT8 *Dest, INT32 i, INT32 nGap);
+INT32 BurnMapRom(UINT8 **ppData, INT32 i);
 INT32 BurnLoadBitField(UINT8* pDest, UINT8* pSrc, INT32 nField, INT32 nSrcLen);
 
 // ---------------------------------------------------------------------------
@@ -149,16 +150,31 @@ struct cpu_core_config {
 
 	UINT64 nMemorySize;		// how large is our memory range?
 	UINT32 nAddressXor;		// fix endianness for some cpus
+
+	void (*counters)(INT32, UINT64*);	// access counters for a cpu (CPU_COUNTER_MAX values), optional
 };
 
+// cpu_core_config::counters, accesses that had to go through a handler
+#define CPU_COUNTER_READ	0
+#define CPU_COUNTER_WRITE	1
+#define CPU_COUNTER_FETCH	2
+#define CPU_COUNTER_IO		3
+#define CPU_COUNTER_MAX		4
+
 void CpuCheatRegister(INT32 type, cpu_core_config *config);
 
 // burn_memory.cpp
 void BurnInitMemoryManager();
-UINT8 *BurnMalloc(INT32 size);
+UINT8 *_BurnMalloc(INT32 size, const char *file, INT32 line);
+UINT8 *(BurnMalloc)(INT32 size);
+#define BurnMalloc(x) _BurnMalloc(x, __FILE__, __LINE__)
 void _BurnFree(void *ptr);
 #define BurnFree(x) do {_BurnFree(x); x = NULL; } while (0)
 void BurnExitMemoryManager();
+void BurnMemoryReport();
+
+// tiles_generic.cpp
+void BurnTransferInvalidate();		// Call before drawing over pBurnDraw outside of BurnTransferCopy()
 
 // ---------------------------------------------------------------------------
 // Sound clipping macro
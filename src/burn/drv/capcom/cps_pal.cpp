@@ -1,5 +1,6 @@
 #include "cps.h"
 #include "bitswap.h"
+#include "burn_prof.h"
 
 // CPS (palette)
 
@@ -38,6 +39,8 @@ INT32 CpsPalExit()
 // Update CpsPal with the new palette at pNewPal (length 0xc00 bytes)
 INT32 CpsPalUpdate(UINT8* pNewPal)
 {
+	BURN_PROF_SCOPE(BURN_PROF_PALETTE);
+
 	UINT16 *ps, *pn;
 
 	ps = (UINT16*)CpsPalSrc;
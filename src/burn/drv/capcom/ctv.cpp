@@ -19,7 +19,55 @@ static inline UINT32 alpha_blend(UINT32 d, UINT32 s, UINT32 p)
 }
 
 // Include all tile variants:
-#include "ctv.h"
+#include "ctv_do.h"
+
+// Filler function
+static INT32 CtvDo_______() { return 0; }
+
+// Lookup tables, index is (size - 8) | rows << 2 | care << 1 | flipx
+// row scroll is only done for 16x16 tiles without masking
+#define CTV_FOUR(b, s, r, m)	CtvDo<b, s, r, 0, 0, m>, CtvDo<b, s, r, 0, 1, m>, CtvDo<b, s, r, 1, 0, m>, CtvDo<b, s, r, 1, 1, m>
+#define CTV_NONE				CtvDo_______, CtvDo_______, CtvDo_______, CtvDo_______
+#define CTV_TABLE(b, m, r)		{ CTV_FOUR(b, 8, 0, m), CTV_NONE, CTV_FOUR(b, 16, 0, m), r, CTV_NONE, CTV_NONE, CTV_FOUR(b, 32, 0, m), CTV_NONE }
+
+static CtvDoFn CtvDo2[0x20]  = CTV_TABLE(2, 0, CTV_FOUR(2, 16, 1, 0));
+static CtvDoFn CtvDo3[0x20]  = CTV_TABLE(3, 0, CTV_FOUR(3, 16, 1, 0));
+static CtvDoFn CtvDo4[0x20]  = CTV_TABLE(4, 0, CTV_FOUR(4, 16, 1, 0));
+
+// Sprite Masking
+static CtvDoFn CtvDo2m[0x20] = CTV_TABLE(2, 1, CTV_NONE);
+static CtvDoFn CtvDo3m[0x20] = CTV_TABLE(3, 1, CTV_NONE);
+static CtvDoFn CtvDo4m[0x20] = CTV_TABLE(4, 1, CTV_NONE);
+
+// BgHi
+static CtvDoFn CtvDo2b[0x20] = CTV_TABLE(2, 2, CTV_NONE);
+static CtvDoFn CtvDo3b[0x20] = CTV_TABLE(3, 2, CTV_NONE);
+static CtvDoFn CtvDo4b[0x20] = CTV_TABLE(4, 2, CTV_NONE);
+
+#if defined CTV_SSSE3
+// Same with the unclipped 16/32-bit variants replaced
+#define CTV_FOUR_S(b, s, r, m)	CtvDoSsse3<b, s, r, 0, m>, CtvDoSsse3<b, s, r, 1, m>, CtvDo<b, s, r, 1, 0, m>, CtvDo<b, s, r, 1, 1, m>
+#define CTV_TABLE_S(b, m, r)	{ CTV_FOUR_S(b, 8, 0, m), CTV_NONE, CTV_FOUR_S(b, 16, 0, m), r, CTV_NONE, CTV_NONE, CTV_FOUR_S(b, 32, 0, m), CTV_NONE }
+
+static CtvDoFn CtvDo2s[0x20]  = CTV_TABLE_S(2, 0, CTV_FOUR_S(2, 16, 1, 0));
+static CtvDoFn CtvDo4s[0x20]  = CTV_TABLE_S(4, 0, CTV_FOUR_S(4, 16, 1, 0));
+static CtvDoFn CtvDo2ms[0x20] = CTV_TABLE_S(2, 1, CTV_NONE);
+static CtvDoFn CtvDo4ms[0x20] = CTV_TABLE_S(4, 1, CTV_NONE);
+static CtvDoFn CtvDo2bs[0x20] = CTV_TABLE_S(2, 2, CTV_NONE);
+static CtvDoFn CtvDo4bs[0x20] = CTV_TABLE_S(4, 2, CTV_NONE);
+
+#undef CTV_TABLE_S
+#undef CTV_FOUR_S
+#endif
+
+#undef CTV_TABLE
+#undef CTV_NONE
+#undef CTV_FOUR
+
+// Current BPP:
+CtvDoFn CtvDoX[0x20];
+CtvDoFn CtvDoXM[0x20];
+CtvDoFn CtvDoXB[0x20];
 
 static INT32 nLastBpp=0;
 INT32 CtvReady()
@@ -28,6 +76,26 @@ INT32 CtvReady()
   // Must be called before calling CpstOne
   if (nBurnBpp!=nLastBpp)
   {
+#if defined CTV_SSSE3
+	  static INT32 nHaveSSSE3 = -1;
+
+	  if (nHaveSSSE3 < 0) {
+		__builtin_cpu_init();
+		nHaveSSSE3 = __builtin_cpu_supports("ssse3") ? 1 : 0;
+	  }
+
+	  if (nHaveSSSE3 && nBurnBpp==2) {
+		memcpy(CtvDoX,CtvDo2s,sizeof(CtvDoX));
+		memcpy(CtvDoXM,CtvDo2ms,sizeof(CtvDoXM));
+		memcpy(CtvDoXB,CtvDo2bs,sizeof(CtvDoXB));
+	  }
+	  else if (nHaveSSSE3 && nBurnBpp==4) {
+		memcpy(CtvDoX,CtvDo4s,sizeof(CtvDoX));
+		memcpy(CtvDoXM,CtvDo4ms,sizeof(CtvDoXM));
+		memcpy(CtvDoXB,CtvDo4bs,sizeof(CtvDoXB));
+	  }
+	  else
+#endif
 	  if (nBurnBpp==2) {
 		memcpy(CtvDoX,CtvDo2,sizeof(CtvDoX));
 		memcpy(CtvDoXM,CtvDo2m,sizeof(CtvDoXM));
@@ -8,185 +8,242 @@
 // CU_SIZE  is 8, 16 or 32
 // CU_BPP is 1 2 3 4 bytes per pixel
 // CU_MASK CPS1 BgHi CPS2 Sprite Masking
+//
+// Every combination is a template instance (see the tables in ctv.cpp), the
+// parameters are constants so the unused paths compile away.
 
-#ifndef CU_FLIPX
- #error "CU_FLIPX wasn\'t defined"
-#endif
+template <INT32 CU_BPP, INT32 CU_SIZE, INT32 CU_ROWS, INT32 CU_CARE, INT32 CU_FLIPX, INT32 CU_MASK>
+static INT32 CtvDo()
+{
+  UINT32 nBlank = 0;
+  UINT32 *ctp = CpstPal;
+  INT16 *Rows = CpstRowShift;
 
-#ifndef CU_CARE
- #error "CU_CARE wasn\'t defined"
-#endif
+// Plot c at p (z at pz), colour index c is 1-15.  These are macros rather than
+// inline functions so the eight pixels are unrolled at any optimisation level.
+#define PLOT(p, pz) { \
+    if (CU_BPP == 2) { \
+      *((UINT16 *)(p)) = (UINT16)c; \
+    } else if (CU_BPP == 3) { \
+      if (nCpsBlend) { c = alpha_blend((p)[0] | ((p)[1] << 8) | ((p)[2] << 16), c, nCpsBlend); } \
+      (p)[0] = (UINT8)c; (p)[1] = (UINT8)(c >> 8); (p)[2] = (UINT8)(c >> 16); \
+    } else { \
+      if (nCpsBlend) { c = alpha_blend(*((UINT32 *)(p)), c, nCpsBlend); } \
+      *((UINT32 *)(p)) = c; \
+    } \
+    if (CU_MASK == 1 && CU_BPP != 3) *(pz) = ZValue;	/* 24-bit never wrote the z buffer */ \
+  }
+
+// Draw the next pixel of b if it isn't transparent, masked or (CU_CARE) clipped
+#define DO_PIX(i) { \
+    UINT32 c = CU_FLIPX ? (b & 15) : (b >> 28); \
+    if ((CU_CARE == 0 || ((rx + (i) * 0x7fff) & 0x20004000) == 0) && \
+        (CU_MASK == 2 ? (c && (CpstPmsk & (1 << (c ^ 15)))) : (c != 0)) && \
+        (CU_MASK != 1 || pPixZ[i] < ZValue)) { \
+      c = ctp[c]; \
+      PLOT(pPix + (i) * CU_BPP, pPixZ + (i)) \
+    } \
+    if (CU_FLIPX) b >>= 4; else b <<= 4; \
+  }
+
+#define EIGHT(x, n) x((n) + 0) x((n) + 1) x((n) + 2) x((n) + 3) x((n) + 4) x((n) + 5) x((n) + 6) x((n) + 7)
+
+// Eight bit-packed pixels (msb) AAAABBBB CCCCDDDD EEEEFFFF GGGGHHHH (lsb)
+#define DRAW_8(x) { \
+    UINT32 b = *((UINT32 *)(pCtvTile + (CU_FLIPX ? (CU_SIZE / 2 - 4 - (x) * 4) : ((x) * 4)))); \
+    nBlank |= b; \
+    EIGHT(DO_PIX, (x) * 8) \
+  }
+
+  for (INT32 y = 0; y < CU_SIZE; y++, pCtvLine += nBurnPitch, pCtvTile += nCtvTileAdd) {
+    UINT32 rx = nCtvRollX;	// Copy of nCtvRollX
+    UINT16 *pPixZ = NULL;
+
+    if (CU_CARE) {
+      // okay to plot line?
+      UINT32 nSkip = nCtvRollY & 0x20004000;
+      nCtvRollY += 0x7fff;
+      if (nSkip) {
+        if (CU_ROWS) Rows++;
+        if (CU_MASK == 1) pZVal += 384;
+        continue;
+      }
+    }
+
+    // Point to the line to draw
+    UINT8 *pPix = pCtvLine;
+    if (CU_MASK == 1) pPixZ = pZVal;
+
+    if (CU_ROWS) {
+      if (CU_MASK == 1) pPixZ += Rows[0];
+      pPix += Rows[0] * nBurnBpp;
+      if (CU_CARE) rx += Rows[0] * 0x7fff;
+    }
+
+    DRAW_8(0)
+    if (CU_SIZE >= 16) DRAW_8(1)
+    if (CU_SIZE == 32) { DRAW_8(2) DRAW_8(3) }
+
+    if (CU_ROWS) Rows++;
+    if (CU_MASK == 1) pZVal += 384;
+  }
 
-#ifndef CU_ROWS
- #error "CU_ROWS wasn\'t defined"
-#endif
+#undef DRAW_8
+#undef EIGHT
+#undef DO_PIX
+#undef PLOT
 
-#ifndef CU_SIZE
- #error "CU_SIZE wasn\'t defined"
-#endif
+  return nBlank == 0;
+}
 
-#ifndef CU_BPP
- #error "CU_BPP wasn\'t defined"
-#endif
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5))
+#define CTV_SSSE3
+#include <tmmintrin.h>
 
-#ifndef CU_MASK
- #error "CU_MASK wasn\'t defined"
-#endif
+// Unclipped 16 and 32-bit tiles, a row of 16 pixels at a time: the nibbles are
+// unpacked into bytes, looked up in the palette split into byte planes (pshufb
+// does 16 lookups at once), and merged with the destination under the
+// transparency / priority mask.  Clipped tiles, 24-bit and blending go to CtvDo.
 
+// Merge c into 16 bytes at pDest, t is set for the bytes to keep
+__attribute__((target("ssse3"))) static inline void CtvMergeSsse3(UINT8 *pDest, __m128i c, __m128i t)
 {
-  INT32 y;
-  UINT32 *ctp;
-  UINT32 nBlank = 0;
-
-  UINT32 b;      			// Eight bit-packed pixels (msb) AAAABBBB CCCCDDDD EEEEFFFF GGGGHHHH (lsb)
-  UINT32 c;				// 32-bit colour value
-  UINT8 *pPix;			// Pointer to output bitmap
+  INT32 nKeep = _mm_movemask_epi8(t);
 
-#if CU_ROWS == 1
-  INT16 *Rows = CpstRowShift;
-#endif
-
-  ctp = CpstPal;
-
-for (y = 0; y < CU_SIZE; y++, pCtvLine += nBurnPitch, pCtvTile += nCtvTileAdd
-
-#if CU_ROWS==1
-     ,Rows++
-#endif
+  if (nKeep == 0xffff) return;
+  if (nKeep) c = _mm_or_si128(_mm_and_si128(t, _mm_loadu_si128((__m128i *)pDest)), _mm_andnot_si128(t, c));
 
-#if CU_MASK==1
-	 ,pZVal += 384
-#endif
+  _mm_storeu_si128((__m128i *)pDest, c);
+}
 
-)
+// Write nPixels (8 or 16) pixels, n holds the colour indices, t is set for transparent pixels
+template <INT32 CU_BPP, INT32 nPixels>
+__attribute__((target("ssse3"))) static inline void CtvRowSsse3(UINT8 *pPix, __m128i n, __m128i t, const __m128i *pPlane)
 {
-#if CU_CARE==1
-  UINT32 rx = nCtvRollX;	// Copy of nCtvRollX
-#endif
+  if (_mm_movemask_epi8(t) == 0xffff) return;
+
+  if (CU_BPP == 2) {
+    __m128i c0 = _mm_shuffle_epi8(pPlane[0], n);
+    __m128i c1 = _mm_shuffle_epi8(pPlane[1], n);
+
+    CtvMergeSsse3(pPix + 0, _mm_unpacklo_epi8(c0, c1), _mm_unpacklo_epi8(t, t));
+    if (nPixels == 16) CtvMergeSsse3(pPix + 16, _mm_unpackhi_epi8(c0, c1), _mm_unpackhi_epi8(t, t));
+  } else {
+    __m128i c0 = _mm_shuffle_epi8(pPlane[0], n);
+    __m128i c1 = _mm_shuffle_epi8(pPlane[1], n);
+    __m128i c2 = _mm_shuffle_epi8(pPlane[2], n);
+    __m128i c3 = _mm_shuffle_epi8(pPlane[3], n);
+
+    __m128i c01 = _mm_unpacklo_epi8(c0, c1), c23 = _mm_unpacklo_epi8(c2, c3), tt = _mm_unpacklo_epi8(t, t);
+    CtvMergeSsse3(pPix + 0, _mm_unpacklo_epi16(c01, c23), _mm_unpacklo_epi16(tt, tt));
+    CtvMergeSsse3(pPix + 16, _mm_unpackhi_epi16(c01, c23), _mm_unpackhi_epi16(tt, tt));
+
+    if (nPixels == 16) {
+      c01 = _mm_unpackhi_epi8(c0, c1); c23 = _mm_unpackhi_epi8(c2, c3); tt = _mm_unpackhi_epi8(t, t);
+      CtvMergeSsse3(pPix + 32, _mm_unpacklo_epi16(c01, c23), _mm_unpacklo_epi16(tt, tt));
+      CtvMergeSsse3(pPix + 48, _mm_unpackhi_epi16(c01, c23), _mm_unpackhi_epi16(tt, tt));
+    }
+  }
+}
 
-#if CU_MASK==1
-  UINT16 *pPixZ;
-#endif
+// Sprite masking: only draw over lower z values, and write ZValue where we did
+template <INT32 nPixels>
+__attribute__((target("ssse3"))) static inline __m128i CtvZMaskSsse3(UINT16 *pPixZ, __m128i t)
+{
+  const __m128i vSign = _mm_set1_epi16((INT16)0x8000);
+  const __m128i vZ = _mm_set1_epi16((INT16)ZValue);
+  __m128i k[2];
+
+  for (INT32 i = 0; i < nPixels / 8; i++) {
+    __m128i z = _mm_loadu_si128((__m128i *)(pPixZ + i * 8));
+    // unsigned z < ZValue
+    __m128i d = _mm_cmplt_epi16(_mm_xor_si128(z, vSign), _mm_xor_si128(vZ, vSign));
+
+    k[i] = _mm_or_si128(i ? _mm_unpackhi_epi8(t, t) : _mm_unpacklo_epi8(t, t), _mm_cmpeq_epi16(d, _mm_setzero_si128()));
+    if (_mm_movemask_epi8(k[i]) != 0xffff) {
+      _mm_storeu_si128((__m128i *)(pPixZ + i * 8), _mm_or_si128(_mm_and_si128(k[i], z), _mm_andnot_si128(k[i], vZ)));
+    }
+  }
+
+  return (nPixels == 16) ? _mm_packs_epi16(k[0], k[1]) : _mm_packs_epi16(k[0], _mm_set1_epi16(-1));
+}
 
-#if CU_CARE==1
-  if (nCtvRollY & 0x20004000) { nCtvRollY += 0x7fff; continue; } else nCtvRollY += 0x7fff;	// okay to plot line
-#endif
+template <INT32 CU_BPP, INT32 CU_SIZE, INT32 CU_ROWS, INT32 CU_FLIPX, INT32 CU_MASK>
+__attribute__((target("ssse3"))) static INT32 CtvDoSsse3()
+{
+  if (CU_BPP == 4 && nCpsBlend) {
+    return CtvDo<CU_BPP, CU_SIZE, CU_ROWS, 0, CU_FLIPX, CU_MASK>();
+  }
+
+  // Split the palette into byte planes
+  const __m128i vGather = _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+  __m128i q0 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i *)(CpstPal +  0)), vGather);
+  __m128i q1 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i *)(CpstPal +  4)), vGather);
+  __m128i q2 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i *)(CpstPal +  8)), vGather);
+  __m128i q3 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i *)(CpstPal + 12)), vGather);
+  __m128i q01 = _mm_unpacklo_epi32(q0, q1), q23 = _mm_unpacklo_epi32(q2, q3);
+  __m128i vPlane[4];
+  vPlane[0] = _mm_unpacklo_epi64(q01, q23);
+  vPlane[1] = _mm_unpackhi_epi64(q01, q23);
+  q01 = _mm_unpackhi_epi32(q0, q1); q23 = _mm_unpackhi_epi32(q2, q3);
+  vPlane[2] = _mm_unpacklo_epi64(q01, q23);
+  vPlane[3] = _mm_unpackhi_epi64(q01, q23);
+
+  // BgHi: which colours are drawn
+  __m128i vDraw = _mm_setzero_si128();
+  if (CU_MASK == 2) {
+    UINT8 nDraw[16];
+    for (INT32 c = 0; c < 16; c++) {
+      nDraw[c] = (c && (CpstPmsk & (1 << (c ^ 15)))) ? 0xff : 0;
+    }
+    vDraw = _mm_loadu_si128((__m128i *)nDraw);
+  }
+
+  // Pixel order after unpacking the nibbles of 8 bytes (hi nibble first)
+  const __m128i vOrder = _mm_setr_epi8(6, 7, 4, 5, 2, 3, 0, 1, 14, 15, 12, 13, 10, 11, 8, 9);
+  const __m128i vNibble = _mm_set1_epi8(0x0f);
+  __m128i vBlank = _mm_setzero_si128();
+  INT16 *Rows = CpstRowShift;
 
-  // Point to the line to draw
-  pPix = pCtvLine;
-#if CU_MASK==1
-  pPixZ = pZVal;
-#endif
+  for (INT32 y = 0; y < CU_SIZE; y++, pCtvLine += nBurnPitch, pCtvTile += nCtvTileAdd) {
+    UINT8 *pPix = pCtvLine;
+    if (CU_ROWS) pPix += Rows[0] * nBurnBpp;
 
-#if CU_ROWS==1
- #if CU_MASK==1
-  pPixZ += Rows[0];
- #endif
-  pPix += Rows[0] * nBurnBpp;
- #if CU_CARE==1
-  rx += Rows[0] * 0x7fff;
- #endif
-#endif
+    for (INT32 h = 0; h < ((CU_SIZE == 32) ? 2 : 1); h++) {
+      __m128i v;
 
-// Make macros for plotting c and advancing pPix by one pixel
-#if CU_BPP==2
- #if   CU_MASK==1
-  #define PLOT { if(*pPixZ < ZValue) { *((UINT16 *)pPix)=(UINT16)c; *pPixZ=ZValue; } }
-  #define ADV { pPix+=2; pPixZ++; }
- #else
-  #define PLOT { *((UINT16 *)pPix)=(UINT16)c; }
-  #define ADV pPix+=2
- #endif
-#elif CU_BPP==3
- #if   CU_MASK==1
-  #define PLOT { if(*pPixZ < ZValue) { if (nCpsBlend) { c = alpha_blend(pPix[0]|(pPix[1]<<8)|(pPix[2]<<16), c, nCpsBlend); } pPix[0]=(UINT8)c; pPix[1]=(UINT8)(c>>8); pPix[2]=(UINT8)(c>>16); } }
-  #define ADV { pPix+=3; pPixZ++; }
- #else
-  #define PLOT { if (nCpsBlend) { c = alpha_blend(pPix[0]|(pPix[1]<<8)|(pPix[2]<<16), c, nCpsBlend); } pPix[0]=(UINT8)c; pPix[1]=(UINT8)(c>>8); pPix[2]=(UINT8)(c>>16); }
-  #define ADV pPix+=3
- #endif
-#elif CU_BPP==4
- #if   CU_MASK==1
-  #define PLOT { if(*pPixZ < ZValue) { if (nCpsBlend) { c = alpha_blend(*((UINT32 *)pPix), c, nCpsBlend); } *((UINT32 *)pPix)=c; *pPixZ=ZValue; } }
-  #define ADV { pPix+=4; pPixZ++; }
- #else
-  #define PLOT { if (nCpsBlend) { c = alpha_blend(*((UINT32 *)pPix), c, nCpsBlend); } *((UINT32 *)pPix)=c; }
-  #define ADV pPix+=4
- #endif
-#else
- #error Unsupported CU_BPP
-#endif
+      if (CU_SIZE == 8) {
+        v = _mm_cvtsi32_si128(*((INT32 *)pCtvTile));
+      } else {
+        v = _mm_loadl_epi64((__m128i *)(pCtvTile + (CU_FLIPX ? (CU_SIZE / 2 - 8 - h * 8) : (h * 8))));
+      }
+      vBlank = _mm_or_si128(vBlank, v);
 
-// Make macros for plotting the next pixel from 'b' (= 8 packed pixels)
-// or skipping the pixel.
-#if CU_FLIPX==0
- #define NEXTPIXEL ADV; b <<= 4;
- #if CU_MASK==2
-  #define DRAWPIXEL { c = (b >> 28); if (c && CpstPmsk & (1 << (c ^ 15))) { c = ctp[c]; PLOT } }
- #else
-  #define DRAWPIXEL { if (b & 0xf0000000) { c = ctp[b >> 28]; PLOT } }
- #endif
-#else
- #define NEXTPIXEL ADV; b >>= 4;
- #if CU_MASK==2
-  #define DRAWPIXEL { c = (b & 15); if (c && CpstPmsk & (1 << (c ^ 15))) { c = ctp[c]; PLOT } }
- #else
-  #define DRAWPIXEL { if (b & 0x0000000f) { c = ctp[b & 15]; PLOT } }
- #endif
-#endif
+      __m128i lo = _mm_and_si128(v, vNibble);
+      __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), vNibble);
+      __m128i n;
 
-#define EIGHT(x) x x x x x x x x
+      if (CU_FLIPX) {
+        // lo nibble first, and the second word holds the leftmost pixels
+        n = _mm_unpacklo_epi8(lo, hi);
+        if (CU_SIZE != 8) n = _mm_shuffle_epi32(n, 0x4e);
+      } else {
+        n = _mm_shuffle_epi8(_mm_unpacklo_epi8(hi, lo), vOrder);
+      }
 
-#if CU_CARE==1
- // If we need to clip left or right, check nCtvRollX before plotting
- #define DO_PIX if ((rx & 0x20004000) == 0) DRAWPIXEL NEXTPIXEL rx += 0x7fff;
-#else
- // Always plot
- #define DO_PIX DRAWPIXEL NEXTPIXEL
-#endif
+      __m128i t = _mm_cmpeq_epi8((CU_MASK == 2) ? _mm_shuffle_epi8(vDraw, n) : n, _mm_setzero_si128());
 
-#define DRAW_8 nBlank |= b; EIGHT(DO_PIX)
-
-#if   CU_SIZE==8
-  // 8x8 tiles
-  b=*((UINT32 *)(pCtvTile+0)); DRAW_8
-#elif CU_SIZE==16
- // 16x16 tiles
- #if CU_FLIPX==0
-  b=*((UINT32 *)(pCtvTile+0)); DRAW_8
-  b=*((UINT32 *)(pCtvTile+4)); DRAW_8
- #else
-  b=*((UINT32 *)(pCtvTile+4)); DRAW_8
-  b=*((UINT32 *)(pCtvTile+0)); DRAW_8
- #endif
-
-#elif CU_SIZE==32
- // 32x32 tiles
- #if CU_FLIPX==0
-  b=*((UINT32 *)(pCtvTile+ 0)); DRAW_8
-  b=*((UINT32 *)(pCtvTile+ 4)); DRAW_8
-  b=*((UINT32 *)(pCtvTile+ 8)); DRAW_8
-  b=*((UINT32 *)(pCtvTile+12)); DRAW_8
- #else
-  b=*((UINT32 *)(pCtvTile+12)); DRAW_8
-  b=*((UINT32 *)(pCtvTile+ 8)); DRAW_8
-  b=*((UINT32 *)(pCtvTile+ 4)); DRAW_8
-  b=*((UINT32 *)(pCtvTile+ 0)); DRAW_8
- #endif
-
-#else
- #error Unsupported CU_SIZE
-#endif
+      if (CU_MASK == 1) {
+        t = CtvZMaskSsse3<(CU_SIZE == 8) ? 8 : 16>(pZVal + h * 16, t);
+      }
 
-#undef DRAW_8
-#undef DO_PIX
-#undef EIGHT
-#undef DRAWPIXEL
-#undef NEXTPIXEL
+      CtvRowSsse3<CU_BPP, (CU_SIZE == 8) ? 8 : 16>(pPix + h * 16 * CU_BPP, n, t, vPlane);
+    }
 
-#undef ADV
-#undef PLOT
-}
+    if (CU_ROWS) Rows++;
+    if (CU_MASK == 1) pZVal += 384;
+  }
 
-  return nBlank == 0;
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(vBlank, _mm_setzero_si128())) == 0xffff;
 }
+#endif
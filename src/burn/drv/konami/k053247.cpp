@@ -577,38 +577,148 @@ static inline UINT32 highlight_blend(UINT32 d)
 #define GX_ZBUFW     512
 #define GX_ZBUFH     256
 
-void zdrawgfxzoom32GP(UINT32 code, UINT32 color, INT32 flipx, INT32 flipy, INT32 sx, INT32 sy,
-		INT32 scalex, INT32 scaley, INT32 alpha, INT32 drawmode, INT32 zcode, INT32 pri, UINT8* gx_objzbuf, UINT8* gx_shdzbuf)
-{
 #define FP     19
 #define FPONE  (1<<FP)
 #define FPHALF (1<<(FP-1))
 #define FPENT  0
 
-	// inner loop
-	const UINT8  *src_ptr;
-	INT32 src_x;
+// Source column (or row, tiles are square) for each pixel of a 16 pixel tile drawn
+// dst_w pixels wide (16 is the unzoomed 0 - 15). The common sizes are cached, zoom factors top out at 0x800000
+// so the rest (up to ~2048 pixels) are built in the scratch buffers as needed.
+#define GX_ZOOM_CACHE	256
+
+static UINT8 *gx_zoom_span_table[2][GX_ZOOM_CACHE + 1];
+static UINT8 gx_zoom_span_data[2][(GX_ZOOM_CACHE * (GX_ZOOM_CACHE + 1)) / 2];
+static UINT8 gx_zoom_span_temp[2][0x1000];
+
+static void gx_zoom_span_fill(UINT8 *span, INT32 dst_w, INT32 flip)
+{
+	INT32 src_f, src_fd;
+
+	src_fd = (16 << FP) / dst_w;
+
+	if (!flip) src_f = FPENT; else { src_f = (16 << FP) - FPENT - 1; src_fd = -src_fd; }
+
+	for (INT32 i = 0; i < dst_w; i++, src_f += src_fd) span[i] = src_f >> FP;
+}
+
+static const UINT8 *gx_zoom_span(INT32 dst_w, INT32 flip, INT32 temp)
+{
+	if (dst_w > GX_ZOOM_CACHE) {
+		gx_zoom_span_fill(gx_zoom_span_temp[temp], dst_w, flip);
+		return gx_zoom_span_temp[temp];
+	}
+
+	UINT8 *span = gx_zoom_span_table[flip][dst_w];
+
+	if (span == NULL) {
+		span = gx_zoom_span_data[flip] + ((dst_w * (dst_w - 1)) / 2);
+		gx_zoom_span_fill(span, dst_w, flip);
+		gx_zoom_span_table[flip][dst_w] = span;
+	}
+
+	return span;
+}
+
+#define GX_DRAW_PLAIN	-1 // no shadow, alpha or z-buffering
+
+// dst_w is negative, the pointers point just past the end of the first line
+template <INT32 mode>
+static void zdrawgfxzoom32GP_draw(const UINT8 *src_base, const UINT8 *src_xspan, const UINT8 *src_yspan, INT32 dst_w, INT32 dst_h,
+		UINT32 *dst_ptr, UINT8 *ozbuf_ptr, UINT8 *szbuf_ptr, const UINT32 *pal_base, INT32 shdpen, INT32 alpha,
+		UINT8 z8, UINT8 p8, INT32 highlight_enable)
+{
+	const UINT8 *src_ptr;
+	const UINT8 *src_x;
 	INT32 eax, ecx;
-	INT32 src_fx, src_fdx;
+
+	do {
+		src_ptr = src_base + (*src_yspan++ << 4);
+		src_x = src_xspan;
+		ecx = dst_w;
+
+		// pen 0 is never drawn, skip empty source lines
+		const UINT32 *src_line = (const UINT32 *)src_ptr;
+		if (src_line[0] | src_line[1] | src_line[2] | src_line[3])
+		{
+			do {
+				eax = src_ptr[*src_x++];
+
+				switch (mode)
+				{
+					case GX_DRAW_PLAIN:
+						if (!eax || eax >= shdpen) continue;
+						dst_ptr[ecx] = pal_base[eax];
+						break;
+
+					case 0: // all pens solid
+						if (!eax || ozbuf_ptr[ecx] < z8) continue;
+						ozbuf_ptr[ecx] = z8;
+						dst_ptr[ecx] = pal_base[eax];
+						break;
+
+					case 1: // solid pens only
+						if (!eax || eax >= shdpen || ozbuf_ptr[ecx] < z8) continue;
+						ozbuf_ptr[ecx] = z8;
+						dst_ptr[ecx] = pal_base[eax];
+						break;
+
+					case 2: // all pens solid with alpha blending
+						if (!eax || ozbuf_ptr[ecx] < z8) continue;
+						ozbuf_ptr[ecx] = z8;
+						dst_ptr[ecx] = alpha_blend_r32(pal_base[eax], dst_ptr[ecx], alpha);
+						break;
+
+					case 3: // solid pens only with alpha blending
+						if (!eax || eax >= shdpen || ozbuf_ptr[ecx] < z8) continue;
+						ozbuf_ptr[ecx] = z8;
+						dst_ptr[ecx] = alpha_blend_r32(pal_base[eax], dst_ptr[ecx], alpha);
+						break;
+
+					case 4: // shadow pens only
+						if (eax < shdpen || szbuf_ptr[ecx*2] < z8 || szbuf_ptr[ecx*2+1] <= p8) continue;
+						szbuf_ptr[ecx*2] = z8;
+						szbuf_ptr[ecx*2+1] = p8;
+
+						// the shadow tables are 15-bit lookup tables which accept RGB15... lossy, nasty, yuck!
+						if (highlight_enable) {
+							dst_ptr[ecx] = highlight_blend(dst_ptr[ecx]);
+						} else {
+							dst_ptr[ecx] = shadow_blend(dst_ptr[ecx], highlight_enable); //shd_base[pix.as_rgb15()];
+						}
+						break;
+				}
+			}
+			while (++ecx);
+		}
+
+		dst_ptr += nScreenWidth;
+		if (mode >= 0 && mode < 4) ozbuf_ptr += GX_ZBUFW;
+		if (mode == 4) szbuf_ptr += (GX_ZBUFW<<1);
+	}
+	while (--dst_h);
+}
+
+void zdrawgfxzoom32GP(UINT32 code, UINT32 color, INT32 flipx, INT32 flipy, INT32 sx, INT32 sy,
+		INT32 scalex, INT32 scaley, INT32 alpha, INT32 drawmode, INT32 zcode, INT32 pri, UINT8* gx_objzbuf, UINT8* gx_shdzbuf)
+{
+	INT32 eax;
 	INT32 shdpen;
 	UINT8  z8 = 0, p8 = 0;
 	UINT8  *ozbuf_ptr;
 	UINT8  *szbuf_ptr;
 	const UINT32 *pal_base;
-	const UINT32 *shd_base;
 	UINT32 *dst_ptr;
 
-	// outter loop
-	INT32 src_fby, src_fdy, src_fbx;
 	const UINT8 *src_base;
+	const UINT8 *src_xspan, *src_yspan;
 	INT32 dst_w, dst_h;
 
 	// one-time
-	INT32 nozoom, granularity;
-	INT32 src_fw, src_fh;
+	INT32 granularity;
 	INT32 dst_minx, dst_maxx, dst_miny, dst_maxy;
 	INT32 dst_skipx, dst_skipy, dst_x, dst_y, dst_lastx, dst_lasty;
-	INT32 src_pitch, dst_pitch;
+	INT32 dst_pitch;
 
 	INT32 highlight_enable = (drawmode >> 4) && (K053247Flags & 2);// for fba
 	if (highlight_enable) highlight_enable = (drawmode >> 4) & 0x7;
@@ -640,13 +750,9 @@ void zdrawgfxzoom32GP(UINT32 code, UINT32 color, INT32 flipx, INT32 flipy, INT32
 	ozbuf_ptr  = gx_objzbuf;
 	szbuf_ptr  = gx_shdzbuf;
 
-	src_pitch = 16;
-	src_fw    = 16;
-	src_fh    = 16;
 	src_base  = K053246GfxExp + (code * 0x100);
 
 	pal_base  = konami_palette32 + (color << nBpp);
-	shd_base  = konami_palette32; // m_palette->shadow_table(); // iq_132
 
 	dst_ptr   = konami_bitmap32;
 	dst_pitch = nScreenWidth;
@@ -659,28 +765,25 @@ void zdrawgfxzoom32GP(UINT32 code, UINT32 color, INT32 flipx, INT32 flipy, INT32
 
 	// cull off-screen objects
 	if (dst_x > dst_maxx || dst_y > dst_maxy) return;
-	nozoom = (scalex == 0x10000 && scaley == 0x10000);
-	if (nozoom)
+	if (scalex == 0x10000 && scaley == 0x10000)
 	{
 		dst_h = dst_w = 16;
-		src_fdy = src_fdx = 1;
 	}
 	else
 	{
 		dst_w = ((scalex<<4)+0x8000)>>16;
 		dst_h = ((scaley<<4)+0x8000)>>16;
 		if (!dst_w || !dst_h) return;
-
-		src_fw <<= FP;
-		src_fh <<= FP;
-		src_fdx = src_fw / dst_w;
-		src_fdy = src_fh / dst_h;
 	}
 	dst_lastx = dst_x + dst_w - 1;
 	if (dst_lastx < dst_minx) return;
 	dst_lasty = dst_y + dst_h - 1;
 	if (dst_lasty < dst_miny) return;
 
+	// source columns and rows for the whole sprite
+	src_xspan = gx_zoom_span(dst_w, flipx ? 1 : 0, 0);
+	src_yspan = gx_zoom_span(dst_h, flipy ? 1 : 0, 1);
+
 	// clip destination
 	dst_skipx = 0;
 	eax = dst_minx;  if ((eax -= dst_x) > 0) { dst_skipx = eax;  dst_w -= eax;  dst_x = dst_minx; }
@@ -689,19 +792,9 @@ void zdrawgfxzoom32GP(UINT32 code, UINT32 color, INT32 flipx, INT32 flipy, INT32
 	eax = dst_miny;  if ((eax -= dst_y) > 0) { dst_skipy = eax;  dst_h -= eax;  dst_y = dst_miny; }
 	eax = dst_lasty; if ((eax -= dst_maxy) > 0) dst_h -= eax;
 
-	// calculate zoom factors and clip source
-	if (nozoom)
-	{
-		if (!flipx) src_fbx = 0; else { src_fbx = src_fw - 1; src_fdx = -src_fdx; }
-		if (!flipy) src_fby = 0; else { src_fby = src_fh - 1; src_fdy = -src_fdy; src_pitch = -src_pitch; }
-	}
-	else
-	{
-		if (!flipx) src_fbx = FPENT; else { src_fbx = src_fw - FPENT - 1; src_fdx = -src_fdx; }
-		if (!flipy) src_fby = FPENT; else { src_fby = src_fh - FPENT - 1; src_fdy = -src_fdy; }
-	}
-	src_fbx += dst_skipx * src_fdx;
-	src_fby += dst_skipy * src_fdy;
+	// clip source
+	src_xspan += dst_skipx;
+	src_yspan += dst_skipy;
 
 	// adjust insertion points and pre-entry constants
 	eax = (dst_y - dst_miny) * GX_ZBUFW + (dst_x - dst_minx) + dst_w;
@@ -712,324 +805,31 @@ void zdrawgfxzoom32GP(UINT32 code, UINT32 color, INT32 flipx, INT32 flipy, INT32
 	dst_ptr += dst_y * dst_pitch + dst_x + dst_w;
 	dst_w = -dst_w;
 
-	if (!nozoom)
-	{
-		ecx = src_fby;   src_fby += src_fdy;
-		ecx >>= FP;      src_fx = src_fbx;
-		src_x = src_fbx; src_fx += src_fdx;
-		ecx <<= 4;       src_ptr = src_base;
-		src_x >>= FP;    src_ptr += ecx;
-		ecx = dst_w;
+#define DRAW(mode)	zdrawgfxzoom32GP_draw<mode>(src_base, src_xspan, src_yspan, dst_w, dst_h, dst_ptr, ozbuf_ptr, szbuf_ptr, pal_base, shdpen, alpha, z8, p8, highlight_enable)
 
-		if (zcode < 0) // no shadow and z-buffering
-		{
-			do {
-				do {
-					eax = src_ptr[src_x];
-					src_x = src_fx;
-					src_fx += src_fdx;
-					src_x >>= FP;
-					if (!eax || eax >= shdpen) continue;
-					dst_ptr [ecx] = pal_base[eax];
-				}
-				while (++ecx);
-
-				ecx = src_fby;   src_fby += src_fdy;
-				dst_ptr += dst_pitch;
-				ecx >>= FP;      src_fx = src_fbx;
-				src_x = src_fbx; src_fx += src_fdx;
-				ecx <<= 4;       src_ptr = src_base;
-				src_x >>= FP;    src_ptr += ecx;
-				ecx = dst_w;
-			}
-			while (--dst_h);
-		}
-		else
-		{
-			switch (drawmode)
-			{
-				case 0: // all pens solid
-					do {
-						do {
-							eax = src_ptr[src_x];
-							src_x = src_fx;
-							src_fx += src_fdx;
-							src_x >>= FP;
-							if (!eax || ozbuf_ptr[ecx] < z8) continue;
-							eax = pal_base[eax];
-							ozbuf_ptr[ecx] = z8;
-							dst_ptr [ecx] = eax;
-						}
-						while (++ecx);
-
-						ecx = src_fby;   src_fby += src_fdy;
-						ozbuf_ptr += GX_ZBUFW;
-						dst_ptr += dst_pitch;
-						ecx >>= FP;      src_fx = src_fbx;
-						src_x = src_fbx; src_fx += src_fdx;
-						ecx <<= 4;       src_ptr = src_base;
-						src_x >>= FP;    src_ptr += ecx;
-						ecx = dst_w;
-					}
-					while (--dst_h);
-					break;
-
-				case 1: // solid pens only
-					do {
-						do {
-							eax = src_ptr[src_x];
-							src_x = src_fx;
-							src_fx += src_fdx;
-							src_x >>= FP;
-							if (!eax || eax >= shdpen || ozbuf_ptr[ecx] < z8) continue;
-							eax = pal_base[eax];
-							ozbuf_ptr[ecx] = z8;
-							dst_ptr [ecx] = eax;
-						}
-						while (++ecx);
-
-						ecx = src_fby;   src_fby += src_fdy;
-						ozbuf_ptr += GX_ZBUFW;
-						dst_ptr += dst_pitch;
-						ecx >>= FP;      src_fx = src_fbx;
-						src_x = src_fbx; src_fx += src_fdx;
-						ecx <<= 4;       src_ptr = src_base;
-						src_x >>= FP;    src_ptr += ecx;
-						ecx = dst_w;
-					}
-					while (--dst_h);
-					break;
-
-				case 2: // all pens solid with alpha blending
-					do {
-						do {
-							eax = src_ptr[src_x];
-							src_x = src_fx;
-							src_fx += src_fdx;
-							src_x >>= FP;
-							if (!eax || ozbuf_ptr[ecx] < z8) continue;
-							ozbuf_ptr[ecx] = z8;
-
-							dst_ptr[ecx] = alpha_blend_r32(pal_base[eax], dst_ptr[ecx], alpha);
-						}
-						while (++ecx);
-
-						ecx = src_fby;   src_fby += src_fdy;
-						ozbuf_ptr += GX_ZBUFW;
-						dst_ptr += dst_pitch;
-						ecx >>= FP;      src_fx = src_fbx;
-						src_x = src_fbx; src_fx += src_fdx;
-						ecx <<= 4;       src_ptr = src_base;
-						src_x >>= FP;    src_ptr += ecx;
-						ecx = dst_w;
-					}
-					while (--dst_h);
-					break;
-
-				case 3: // solid pens only with alpha blending
-					do {
-						do {
-							eax = src_ptr[src_x];
-							src_x = src_fx;
-							src_fx += src_fdx;
-							src_x >>= FP;
-							if (!eax || eax >= shdpen || ozbuf_ptr[ecx] < z8) continue;
-							ozbuf_ptr[ecx] = z8;
-
-							dst_ptr[ecx] = alpha_blend_r32(pal_base[eax], dst_ptr[ecx], alpha);
-						}
-						while (++ecx);
-
-						ecx = src_fby;   src_fby += src_fdy;
-						ozbuf_ptr += GX_ZBUFW;
-						dst_ptr += dst_pitch;
-						ecx >>= FP;      src_fx = src_fbx;
-						src_x = src_fbx; src_fx += src_fdx;
-						ecx <<= 4;       src_ptr = src_base;
-						src_x >>= FP;    src_ptr += ecx;
-						ecx = dst_w;
-					}
-					while (--dst_h);
-					break;
-
-				case 4: // shadow pens only
-					do {
-						do {
-							eax = src_ptr[src_x];
-							src_x = src_fx;
-							src_fx += src_fdx;
-							src_x >>= FP;
-							if (eax < shdpen || szbuf_ptr[ecx*2] < z8 || szbuf_ptr[ecx*2+1] <= p8) continue;
-							//UINT32 pix = dst_ptr[ecx];
-							szbuf_ptr[ecx*2] = z8;
-							szbuf_ptr[ecx*2+1] = p8;
-
-							// the shadow tables are 15-bit lookup tables which accept RGB15... lossy, nasty, yuck!
-							if (highlight_enable) {
-								dst_ptr[ecx] = highlight_blend(dst_ptr[ecx]); 
-							} else {
-								dst_ptr[ecx] = shadow_blend(dst_ptr[ecx], highlight_enable); //shd_base[pix.as_rgb15()];
-							}
-							//dst_ptr[ecx] =(eax>>3&0x001f);lend_r32( eax, 0x00000000, 128);
-						}
-						while (++ecx);
-
-						ecx = src_fby;   src_fby += src_fdy;
-						szbuf_ptr += (GX_ZBUFW<<1);
-						dst_ptr += dst_pitch;
-						ecx >>= FP;      src_fx = src_fbx;
-						src_x = src_fbx; src_fx += src_fdx;
-						ecx <<= 4;       src_ptr = src_base;
-						src_x >>= FP;    src_ptr += ecx;
-						ecx = dst_w;
-					}
-					while (--dst_h);
-					break;
-			}   // switch (drawmode)
-		}   // if (zcode < 0)
-	}   // if (!nozoom)
+	if (zcode < 0) // no shadow and z-buffering
+	{
+		DRAW(GX_DRAW_PLAIN);
+	}
 	else
 	{
-		src_ptr = src_base + (src_fby<<4) + src_fbx;
-		src_fdy = src_fdx * dst_w + src_pitch;
-		ecx = dst_w;
-
-		if (zcode < 0) // no shadow and z-buffering
+		switch (drawmode)
 		{
-			do {
-				do {
-					eax = *src_ptr;
-					src_ptr += src_fdx;
-					if (!eax || eax >= shdpen) continue;
-					dst_ptr[ecx] = pal_base[eax];
-				}
-				while (++ecx);
-
-				src_ptr += src_fdy;
-				dst_ptr += dst_pitch;
-				ecx = dst_w;
-			}
-			while (--dst_h);
+			case 0: DRAW(0); break;
+			case 1: DRAW(1); break;
+			case 2: DRAW(2); break;
+			case 3: DRAW(3); break;
+			case 4: DRAW(4); break;
 		}
-		else
-		{
-			switch (drawmode)
-			{
-				case 0: // all pens solid
-					do {
-						do {
-							eax = *src_ptr;
-							src_ptr += src_fdx;
-							if (!eax || ozbuf_ptr[ecx] < z8) continue;
-							eax = pal_base[eax];
-							ozbuf_ptr[ecx] = z8;
-							dst_ptr[ecx] = eax;
-						}
-						while (++ecx);
-
-						src_ptr += src_fdy;
-						ozbuf_ptr += GX_ZBUFW;
-						dst_ptr += dst_pitch;
-						ecx = dst_w;
-					}
-					while (--dst_h);
-					break;
-
-				case 1:  // solid pens only
-					do {
-						do {
-							eax = *src_ptr;
-							src_ptr += src_fdx;
-							if (!eax || eax >= shdpen || ozbuf_ptr[ecx] < z8) continue;
-							eax = pal_base[eax];
-							ozbuf_ptr[ecx] = z8;
-							dst_ptr[ecx] = eax;
-						}
-						while (++ecx);
-
-						src_ptr += src_fdy;
-						ozbuf_ptr += GX_ZBUFW;
-						dst_ptr += dst_pitch;
-						ecx = dst_w;
-					}
-					while (--dst_h);
-					break;
-
-				case 2: // all pens solid with alpha blending
-					do {
-						do {
-							eax = *src_ptr;
-							src_ptr += src_fdx;
-							if (!eax || ozbuf_ptr[ecx] < z8) continue;
-							ozbuf_ptr[ecx] = z8;
-
-							dst_ptr[ecx] = alpha_blend_r32(pal_base[eax], dst_ptr[ecx], alpha);
-						}
-						while (++ecx);
-
-						src_ptr += src_fdy;
-						ozbuf_ptr += GX_ZBUFW;
-						dst_ptr += dst_pitch;
-						ecx = dst_w;
-					}
-					while (--dst_h);
-					break;
-
-				case 3: // solid pens only with alpha blending
-					do {
-						do {
-							eax = *src_ptr;
-							src_ptr += src_fdx;
-							if (!eax || eax >= shdpen || ozbuf_ptr[ecx] < z8) continue;
-							ozbuf_ptr[ecx] = z8;
-
-							dst_ptr[ecx] = alpha_blend_r32(pal_base[eax], dst_ptr[ecx], alpha);
-						}
-						while (++ecx);
+	}
 
-						src_ptr += src_fdy;
-						ozbuf_ptr += GX_ZBUFW;
-						dst_ptr += dst_pitch;
-						ecx = dst_w;
-					}
-					while (--dst_h);
-					break;
-
-				case 4: // shadow pens only
-					do {
-						do {
-							eax = *src_ptr;
-							src_ptr += src_fdx;
-							if (eax < shdpen || szbuf_ptr[ecx*2] < z8 || szbuf_ptr[ecx*2+1] <= p8) continue;
-							//UINT32 pix = dst_ptr[ecx];
-							szbuf_ptr[ecx*2] = z8;
-							szbuf_ptr[ecx*2+1] = p8;
-
-							// the shadow tables are 15-bit lookup tables which accept RGB15... lossy, nasty, yuck!
-							if (highlight_enable) {
-								dst_ptr[ecx] = highlight_blend(dst_ptr[ecx]); 
-							} else {
-								dst_ptr[ecx] = shadow_blend(dst_ptr[ecx], highlight_enable); //shd_base[pix.as_rgb15()];
-							}
-						}
-						while (++ecx);
+#undef DRAW
+}
 
-						src_ptr += src_fdy;
-						szbuf_ptr += (GX_ZBUFW<<1);
-						dst_ptr += dst_pitch;
-						ecx = dst_w;
-					}
-					while (--dst_h);
-					break;
-			}
-		}
-	}
 #undef FP
 #undef FPONE
 #undef FPHALF
 #undef FPENT
-}
-
 
 
 
@@ -1,5 +1,6 @@
 #include "tiles_generic.h"
 #include "konamiic.h"
+#include "burn_prof.h"
 
 UINT32 KonamiIC_K051960InUse = 0;
 UINT32 KonamiIC_K052109InUse = 0;
@@ -112,6 +113,8 @@ void konami_rom_deinterleave_4(UINT8 *src, INT32 len)
 
 void KonamiRecalcPalette(UINT8 *src, UINT32 *dst, INT32 len)
 {
+	BURN_PROF_SCOPE(BURN_PROF_PALETTE);
+
 	konami_palette32 = dst;
 
 	UINT8 r,g,b;
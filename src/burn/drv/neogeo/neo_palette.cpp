@@ -1,4 +1,5 @@
 #include "neogeo.h"
+#include "burn_prof.h"
 // Neo Geo -- palette functions
 
 UINT8* NeoPalSrc[2];		// Pointer to input palettes
@@ -54,6 +55,8 @@ inline static UINT32 CalcCol(UINT16 nColour)
 
 INT32 NeoUpdatePalette()
 {
+	BURN_PROF_SCOPE(BURN_PROF_PALETTE);
+
 	if (NeoRecalcPalette) {
 		INT32 i;
 		UINT16* ps;
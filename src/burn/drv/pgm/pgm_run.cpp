@@ -581,8 +581,6 @@ static void expand_tile_gfx()
 		PGMTileROM[i * 2 + 0] = d & 0x0f;
 		PGMTileROM[i * 2 + 1] = d >> 4;
 	}
-
-	PGMTileROM = (UINT8*)realloc(PGMTileROM, 0x400000);
 }
 
 static void expand_colourdata()
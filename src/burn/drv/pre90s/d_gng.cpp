@@ -42,6 +42,10 @@ static INT32 RomLoadOffset = 0;
 
 static INT32 nExtraCycles = 0;
 
+// the sound cpu gets an irq 4 times per frame
+#define SOUND_IRQ_PERIOD	((UINT64)(TIMER_TICKS_PER_SECOND / (59.59 * 4)))
+static INT32 nSoundIrqTimer = -1;
+
 static INT32 Diamond;
 
 static struct BurnInputInfo DrvInputList[] =
@@ -705,6 +709,13 @@ static INT32 MemIndex()
 	return 0;
 }
 
+static INT32 DrvSoundIrq(INT32, INT32)
+{
+	ZetSetIRQLine(0, CPU_IRQSTATUS_HOLD);
+
+	return 0;
+}
+
 static INT32 DrvDoReset()
 {
 	M6809Open(0);
@@ -714,6 +725,7 @@ static INT32 DrvDoReset()
 	ZetOpen(0);
 	BurnYM2203Reset();
 	ZetReset();
+	BurnTimerStart(nSoundIrqTimer, SOUND_IRQ_PERIOD, SOUND_IRQ_PERIOD);
 	ZetClose();
 	
 	HiscoreReset();
@@ -978,6 +990,7 @@ static INT32 DrvInit()
 	
 	BurnYM2203Init(2, 1500000, NULL, 0);
 	BurnTimerAttachZet(3000000);
+	nSoundIrqTimer = BurnTimerAdd(DrvSoundIrq, 0, 0);
 	BurnYM2203SetRoute(0, BURN_SND_YM2203_YM2203_ROUTE, 0.20, BURN_SND_ROUTE_BOTH);
 	BurnYM2203SetRoute(0, BURN_SND_YM2203_AY8910_ROUTE_1, 0.40, BURN_SND_ROUTE_BOTH);
 	BurnYM2203SetRoute(0, BURN_SND_YM2203_AY8910_ROUTE_2, 0.40, BURN_SND_ROUTE_BOTH);
@@ -1072,6 +1085,7 @@ static INT32 DiamondInit()
 	
 	BurnYM2203Init(2, 1500000, NULL, 0);
 	BurnTimerAttachZet(3000000);
+	nSoundIrqTimer = BurnTimerAdd(DrvSoundIrq, 0, 0);
 	BurnYM2203SetRoute(0, BURN_SND_YM2203_YM2203_ROUTE, 0.20, BURN_SND_ROUTE_BOTH);
 	BurnYM2203SetRoute(0, BURN_SND_YM2203_AY8910_ROUTE_1, 0.40, BURN_SND_ROUTE_BOTH);
 	BurnYM2203SetRoute(0, BURN_SND_YM2203_AY8910_ROUTE_2, 0.40, BURN_SND_ROUTE_BOTH);
@@ -1116,6 +1130,7 @@ static INT32 DrvExit()
 	
 	RomLoadOffset = 0;
 	Diamond = 0;
+	nSoundIrqTimer = -1;
 
 	return 0;
 }
@@ -1387,7 +1402,6 @@ static INT32 DrvFrame()
 		// Run Z80
 		ZetOpen(0);
 		BurnTimerUpdate((i + 1) * (nCyclesTotal[1] / nInterleave));
-		if (i % 64 == 63) ZetSetIRQLine(0, CPU_IRQSTATUS_HOLD);
 		ZetClose();
 	}
 
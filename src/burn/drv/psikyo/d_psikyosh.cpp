@@ -17,6 +17,7 @@ static UINT8 *AllRam;
 static UINT8 *RamEnd;
 static UINT8 *DrvSh2ROM;
 static UINT8 *DrvSndROM;
+static UINT8 *DrvSndMap; // DrvSndROM when it's mapped straight from the rom set
 static UINT8 *DrvEEPROM;
 static UINT8 *DrvSh2RAM;
 static UINT8 *DrvZoomRAM;
@@ -641,7 +642,11 @@ static INT32 MemIndex(INT32 gfxsize)
 
 	pPsikyoshTiles		= Next; Next += gfxsize + 0x20000 /* empty banking */;
 
-	DrvSndROM		= Next; Next += 0x0400000;
+	if (DrvSndMap) {
+		DrvSndROM	= DrvSndMap;
+	} else {
+		DrvSndROM	= Next; Next += 0x0400000;
+	}
 
 	DrvEEPROM		= Next; Next += 0x0000100;
 
@@ -716,8 +721,29 @@ static void DrvGfxDecode(INT32 size)
 	}
 }
 
+static INT32 DrvSampleRomIndex()
+{
+	struct BurnRomInfo ri;
+
+	for (INT32 i = 0; BurnDrvGetRomInfo(&ri, i) == 0; i++) {
+		if (ri.nType & BRF_SND) return i;
+	}
+
+	return -1;
+}
+
 static INT32 DrvInit(INT32 (*LoadCallback)(), INT32 type, INT32 gfx_max, INT32 gfx_min)
 {
+	struct BurnRomInfo ri;
+	INT32 nSndRom = DrvSampleRomIndex();
+
+	// The samples are only ever read, so use the rom file's own (shared) pages when they
+	// can be mapped. Sets with a smaller sample rom still need the full 4mb buffer.
+	DrvSndMap = NULL;
+	if (nSndRom >= 0 && BurnDrvGetRomInfo(&ri, nSndRom) == 0 && ri.nLen == 0x400000) {
+		if (BurnMapRom(&DrvSndMap, nSndRom)) DrvSndMap = NULL;
+	}
+
 	AllMem = NULL;
 	MemIndex(gfx_max - gfx_min);
 	INT32 nLen = MemEnd - (UINT8 *)0;
@@ -730,6 +756,10 @@ static INT32 DrvInit(INT32 (*LoadCallback)(), INT32 type, INT32 gfx_max, INT32 g
 			if (LoadCallback()) return 1;
 		}
 
+		if (DrvSndMap == NULL && nSndRom >= 0) {
+			if (BurnLoadRom(DrvSndROM, nSndRom, 1)) return 1;
+		}
+
 		BurnSwap32(DrvSh2ROM, 0x100000);
 #ifndef LSB_FIRST
 		le_to_be(DrvSh2ROM,0x200000);
@@ -799,6 +829,7 @@ static INT32 DrvExit()
 	EEPROMExit();
 
 	BurnFree(AllMem);
+	DrvSndMap = NULL;
 
 	speedhack_address = ~0;
 	memset (speedhack_pc, 0, 4 * sizeof(UINT32));
@@ -901,8 +932,6 @@ static int SoldividLoadCallback()
 	if (BurnLoadRom(pPsikyoshTiles + 0x3000000 - 0x2000000,  6, 2)) return 1;
 	if (BurnLoadRom(pPsikyoshTiles + 0x3000001 - 0x2000000,  7, 2)) return 1;
 
-	if (BurnLoadRom(DrvSndROM  + 0x0000000,  8, 1)) return 1;
-
 	return 0;
 }
 
@@ -1006,8 +1035,6 @@ static INT32 S1945iiLoadCallback()
 	if (BurnLoadRom(pPsikyoshTiles + 0x1800000,  8, 2)) return 1;
 	if (BurnLoadRom(pPsikyoshTiles + 0x1800001,  9, 2)) return 1;
 
-	if (BurnLoadRom(DrvSndROM  + 0x0000000, 10, 1)) return 1;
-
 	memcpy (DrvEEPROM, factory_eeprom, 0x10);
 
 	return 0;
@@ -1090,8 +1117,6 @@ static INT32 DarakuLoadCallback()
 	if (BurnLoadRom(pPsikyoshTiles + 0x3000000, 15, 2)) return 1;
 	if (BurnLoadRom(pPsikyoshTiles + 0x3000001, 16, 2)) return 1;
 
-	if (BurnLoadRom(DrvSndROM  + 0x0000000, 17, 1)) return 1;
-
 	memcpy (DrvEEPROM, daraku_eeprom, 0x10);
 
 	return 0;
@@ -1158,8 +1183,6 @@ static INT32 SbomberLoadCallback()
 	if (BurnLoadRom(pPsikyoshTiles + 0x2000000, 10, 2)) return 1;
 	if (BurnLoadRom(pPsikyoshTiles + 0x2000001, 11, 2)) return 1;
 
-	if (BurnLoadRom(DrvSndROM  + 0x0000000, 12, 1)) return 1;
-
 	memcpy (DrvEEPROM, factory_eeprom, 0x10);
 
 	return 0;
@@ -1262,8 +1285,6 @@ static INT32 Gunbird2LoadCallback()
 	if (BurnLoadRom(pPsikyoshTiles + 0x3000000,  9, 2)) return 1;
 	if (BurnLoadRom(pPsikyoshTiles + 0x3000001, 10, 2)) return 1;
 
-	if (BurnLoadRom(DrvSndROM  + 0x0000000, 11, 1)) return 1;
-
 	memcpy (DrvEEPROM, factory_eeprom, 0x10);
 
 	return 0;
@@ -1453,8 +1474,6 @@ static INT32 DragnblzLoadCallback()
 	if (BurnLoadRom(pPsikyoshTiles + 0x2800000 - 0x0400000, 20, 2)) return 1;
 	if (BurnLoadRom(pPsikyoshTiles + 0x2800001 - 0x0400000, 21, 2)) return 1;
 
-	if (BurnLoadRom(DrvSndROM  + 0x0000000, 22, 1)) return 1;
-
 	memcpy (DrvEEPROM + 0x00, factory_eeprom,  0x10);
 	memcpy (DrvEEPROM + 0xf0, dragnblz_eeprom, 0x10);
 
@@ -1525,8 +1544,6 @@ static INT32 GnbarichLoadCallback()
 	if (BurnLoadRom(pPsikyoshTiles + 0x2400000 - 0x1800000,  8, 2)) return 1;
 	if (BurnLoadRom(pPsikyoshTiles + 0x2400001 - 0x1800000,  9, 2)) return 1;
 
-	if (BurnLoadRom(DrvSndROM  + 0x0000000, 10, 1)) return 1;
-
 	memcpy (DrvEEPROM + 0x00, factory_eeprom, 0x10);
 	memcpy (DrvEEPROM + 0xf0, gnbarich_eeprom, 0x10);
 
@@ -1597,8 +1614,6 @@ static INT32 MjgtasteLoadCallback()
 	if (BurnLoadRom(pPsikyoshTiles + 0x1000000 - 0x0400000,  8, 2)) return 1;
 	if (BurnLoadRom(pPsikyoshTiles + 0x1000001 - 0x0400000,  9, 2)) return 1;
 
-	if (BurnLoadRom(DrvSndROM  + 0x0000000, 10, 1)) return 1;
-
 	memcpy (DrvEEPROM + 0x00, mjgtaste_eeprom, 0x10);
 	memcpy (DrvEEPROM + 0xf0, mjgtaste_eeprom, 0x10);
 
@@ -1678,8 +1693,6 @@ static INT32 Tgm2LoadCallback()
 	if (BurnLoadRom(pPsikyoshTiles + 0x2800000 - 0x0c00000, 16, 2)) return 1;
 	if (BurnLoadRom(pPsikyoshTiles + 0x2800001 - 0x0c00000, 17, 2)) return 1;
 
-	if (BurnLoadRom(DrvSndROM  + 0x0000000, 18, 1)) return 1;
-
 	if (BurnLoadRom(DrvEEPROM  + 0x0000000, 19, 1)) return 1;
 
 	return 0;
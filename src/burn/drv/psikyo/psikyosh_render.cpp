@@ -14,11 +14,14 @@ UINT32  *pPsikyoshPalRAM;
 UINT32  *pPsikyoshZoomRAM;
 
 static UINT8 *DrvTransTab;
+static UINT8 *DrvAlphaTab; // 8bpp tiles using pens blended through alphatable
 static UINT8 alphatable[0x100];
 
 static UINT16 *DrvPriBmp;
 static UINT8 *DrvZoomBmp;
 static INT32 nDrvZoomPrev = -1;
+static INT32 nDrvZoomOpaque = 0; // DrvZoomBmp needs no alphatable within
+static INT32 nDrvZoomWide, nDrvZoomHigh; // the last wide x high tiles filled
 static UINT32  *DrvTmpDraw;
 static UINT32  *DrvTmpDraw_ptr;
 
@@ -40,6 +43,137 @@ static inline UINT32 alpha_blend(UINT32 d, UINT32 s, UINT32 p)
 		((((s & 0x00ff00) * p) + ((d & 0x00ff00) * a)) & 0x00ff0000)) >> 8;
 }
 
+// Only pens 0xc0-0xff have an entry in alphatable, so 4bpp tiles and 8bpp tiles
+// that don't use those pens can be drawn as if they were opaque.
+static INT32 tiles_opaque(INT32 tileno, INT32 count)
+{
+	if (tileno + count - 1 > nGraphicsSize1) return 0;
+
+	for (INT32 i = tileno; i < tileno + count; i++) {
+		if (DrvAlphaTab[i >> 3] & (1 << (i & 7))) return 0;
+	}
+
+	return 1;
+}
+
+//--------------------------------------------------------------------------------
+// SSE2 blending, 8 pixels at a time. Everything drawn here has a clear top byte
+// (the palette and line colours are shifted down by 8), so blending it along with
+// the other channels gives exactly what alpha_blend() does.
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5))
+#define PSIKYOSH_SSE2
+#include <emmintrin.h>
+
+static INT32 nHaveSSE2 = -1;
+
+// (s * p + d * (256 - p)) >> 8 for two pixels unpacked to 16 bits per channel
+#define BLEND_LANES_SSE2(d, s, p)	\
+	_mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(s, p), _mm_mullo_epi16(d, _mm_sub_epi16(_mm_set1_epi16(256), p))), 8)
+
+__attribute__((target("sse2"))) static void blend_line_sse2(UINT32 *dest, UINT32 colour, INT32 p, INT32 len)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i s = _mm_unpacklo_epi8(_mm_set1_epi32(colour), zero);
+	const __m128i w = _mm_set1_epi16(p);
+	INT32 x = 0;
+
+	for (; x + 8 <= len; x += 8) {
+		__m128i d0 = _mm_loadu_si128((__m128i*)(dest + x + 0));
+		__m128i d1 = _mm_loadu_si128((__m128i*)(dest + x + 4));
+
+		d0 = _mm_packus_epi16(BLEND_LANES_SSE2(_mm_unpacklo_epi8(d0, zero), s, w), BLEND_LANES_SSE2(_mm_unpackhi_epi8(d0, zero), s, w));
+		d1 = _mm_packus_epi16(BLEND_LANES_SSE2(_mm_unpacklo_epi8(d1, zero), s, w), BLEND_LANES_SSE2(_mm_unpackhi_epi8(d1, zero), s, w));
+
+		_mm_storeu_si128((__m128i*)(dest + x + 0), d0);
+		_mm_storeu_si128((__m128i*)(dest + x + 4), d1);
+	}
+
+	for (; x < len; x++) {
+		dest[x] = alpha_blend(dest[x], colour, p);
+	}
+}
+
+// Zoomed sprite with a fixed alpha level (alpha >= 0) or the per pen alphatable (alpha < 0),
+// z > 0 also checks and updates the priority bitmap
+__attribute__((target("sse2"))) static void draw_zoom_blend_sse2(const UINT32 *pal, INT32 sx, INT32 ex, INT32 sy, INT32 ey,
+				 INT32 x_index_base, INT32 y_index, INT32 dx, INT32 dy, INT32 alpha, INT32 z)
+{
+	const __m128i zero = _mm_setzero_si128();
+
+	for (INT32 y = sy; y < ey; y++, y_index += dy)
+	{
+		UINT8 *source = DrvZoomBmp + (y_index >> 10) * 256;
+		UINT32 *dest = DrvTmpDraw + y * nScreenWidth;
+		UINT16 *pri = DrvPriBmp + y * nScreenWidth;
+		INT32 x_index = x_index_base;
+
+		for (INT32 x = sx; x < ex; x += 8)
+		{
+			// weight 0 leaves the pixel alone, 256 is opaque, anything else blends
+			UINT32 col[8];
+			UINT16 weight[8];
+			INT32 n = (ex - x < 8) ? (ex - x) : 8;
+			INT32 opaque = 0, drawn = 0;
+
+			for (INT32 i = 0; i < n; i++, x_index += dx)
+			{
+				INT32 c = source[x_index >> 10];
+
+				col[i] = 0;
+				weight[i] = 0;
+
+				if (c && (z <= 0 || z >= pri[x + i]))
+				{
+					INT32 p = alpha;
+					if (p < 0) {
+						p = alphatable[c];
+						if (p == 0xff) {
+							p = 256;
+							opaque++;
+						}
+					}
+
+					col[i] = pal[c];
+					weight[i] = p;
+					drawn++;
+
+					if (z > 0) pri[x + i] = z;
+				}
+			}
+
+			if (n < 8) {
+				for (INT32 i = 0; i < n; i++) {
+					if (weight[i] == 256) dest[x + i] = col[i];
+					else if (weight[i]) dest[x + i] = alpha_blend(dest[x + i], col[i], weight[i]);
+				}
+			} else if (opaque == 8) {
+				_mm_storeu_si128((__m128i*)(dest + x + 0), _mm_loadu_si128((__m128i*)(col + 0)));
+				_mm_storeu_si128((__m128i*)(dest + x + 4), _mm_loadu_si128((__m128i*)(col + 4)));
+			} else if (drawn) {
+				__m128i w = _mm_loadu_si128((__m128i*)weight);
+				__m128i wl = _mm_unpacklo_epi16(w, w);
+				__m128i wh = _mm_unpackhi_epi16(w, w);
+				__m128i s0 = _mm_loadu_si128((__m128i*)(col + 0));
+				__m128i s1 = _mm_loadu_si128((__m128i*)(col + 4));
+				__m128i d0 = _mm_loadu_si128((__m128i*)(dest + x + 0));
+				__m128i d1 = _mm_loadu_si128((__m128i*)(dest + x + 4));
+
+				d0 = _mm_packus_epi16(BLEND_LANES_SSE2(_mm_unpacklo_epi8(d0, zero), _mm_unpacklo_epi8(s0, zero), _mm_unpacklo_epi32(wl, wl)),
+						      BLEND_LANES_SSE2(_mm_unpackhi_epi8(d0, zero), _mm_unpackhi_epi8(s0, zero), _mm_unpackhi_epi32(wl, wl)));
+				d1 = _mm_packus_epi16(BLEND_LANES_SSE2(_mm_unpacklo_epi8(d1, zero), _mm_unpacklo_epi8(s1, zero), _mm_unpacklo_epi32(wh, wh)),
+						      BLEND_LANES_SSE2(_mm_unpackhi_epi8(d1, zero), _mm_unpackhi_epi8(s1, zero), _mm_unpackhi_epi32(wh, wh)));
+
+				_mm_storeu_si128((__m128i*)(dest + x + 0), d0);
+				_mm_storeu_si128((__m128i*)(dest + x + 4), d1);
+			}
+		}
+	}
+}
+
+#undef BLEND_LANES_SSE2
+#endif
+
 //--------------------------------------------------------------------------------
 
 static void draw_blendy_tile(INT32 gfx, INT32 code, INT32 color, INT32 sx, INT32 sy, INT32 fx, INT32 fy, INT32 alpha, INT32 z)
@@ -54,6 +188,8 @@ static void draw_blendy_tile(INT32 gfx, INT32 code, INT32 color, INT32 sx, INT32
 
 		if (DrvTransTab[code >> 3] & (1 << (code & 7))) return;
 
+		if (alpha < 0) alpha = 0xff; // no 4bpp pen is in alphatable
+
 		UINT8 *src = pPsikyoshTiles + (code << 7);
 	
 		INT32 inc = 8;
@@ -146,6 +282,8 @@ static void draw_blendy_tile(INT32 gfx, INT32 code, INT32 color, INT32 sx, INT32
 
 		if (DrvTransTab[(code >> 3) + 0x10000] & (1 << (code & 7))) return;
 
+		if (alpha < 0 && code <= nGraphicsSize1 && (~DrvAlphaTab[code >> 3] & (1 << (code & 7)))) alpha = 0xff;
+
 		UINT8 *src = pPsikyoshTiles + (code << 8);
 
 		INT32 inc = 16;
@@ -244,6 +382,9 @@ static void draw_prezoom(INT32 gfx, INT32 code, INT32 high, INT32 wide)
 		if (tileno < 0 || tileno > nGraphicsSize1) tileno = 0;
 		if (nDrvZoomPrev == tileno) return;
 		nDrvZoomPrev = tileno;
+		nDrvZoomOpaque = tiles_opaque(tileno, wide * high);
+		nDrvZoomWide = wide;
+		nDrvZoomHigh = high;
 		UINT32 *gfxptr = (UINT32*)(pPsikyoshTiles + (tileno << 8));
 
 		for (INT32 ytile = 0; ytile < high; ytile++)
@@ -268,6 +409,9 @@ static void draw_prezoom(INT32 gfx, INT32 code, INT32 high, INT32 wide)
 		if (tileno < 0 || tileno > nGraphicsSize0) tileno = 0;
 		if (nDrvZoomPrev == tileno) return;
 		nDrvZoomPrev = tileno;
+		nDrvZoomOpaque = 1;
+		nDrvZoomWide = wide;
+		nDrvZoomHigh = high;
 		UINT8 *gfxptr = pPsikyoshTiles + (tileno << 7);
 		for (INT32 ytile = 0; ytile < high; ytile++)
 		{
@@ -322,6 +466,9 @@ static void psikyosh_drawgfxzoom(INT32 gfx, UINT32 code, INT32 color, INT32 flip
 	{
 		draw_prezoom(gfx, code, high, wide);
 
+		// the zoom bitmap is only refilled for a new tile number, so check what was filled last
+		if (alpha < 0 && nDrvZoomOpaque && wide <= nDrvZoomWide && high <= nDrvZoomHigh) alpha = 0xff;
+
 		{
 			UINT32 *pal = pBurnDrvPalette + (color << 4);
 
@@ -369,6 +516,11 @@ static void psikyosh_drawgfxzoom(INT32 gfx, UINT32 code, INT32 color, INT32 flip
 
 				if (ex > sx)
 				{
+#if defined PSIKYOSH_SSE2
+					if (alpha != 0xff && nHaveSSE2) {
+						draw_zoom_blend_sse2(pal, sx, ex, sy, ey, x_index_base, y_index, dx, dy, alpha, z);
+					} else
+#endif
 					if (alpha == 0xff) {
 						if (z > 0) {
 							PUTPIXEL_ZOOM_NORMAL_PRIO()
@@ -620,6 +772,12 @@ static void postlineblend()
 			}
 		}
 		else if (lineblend[y] & 0x7f) {
+#if defined PSIKYOSH_SSE2
+			if (nHaveSSE2) {
+				blend_line_sse2(destline, lineblend[y] >> 8, (lineblend[y] & 0x7f) << 1, nScreenWidth);
+				continue;
+			}
+#endif
 			for (INT32 x = 0; x < nScreenWidth; x++) {
 				destline[x] = alpha_blend(destline[x], lineblend[y] >> 8, (lineblend[y] & 0x7f) << 1);
 			}
@@ -677,8 +835,10 @@ static void fill_alphatable()
 static void calculate_transtab()
 {
 	DrvTransTab = (UINT8*)BurnMalloc(0x18000);
+	DrvAlphaTab = (UINT8*)BurnMalloc(0x8000);
 
 	memset (DrvTransTab, 0xff, 0x18000);
+	memset (DrvAlphaTab, 0x00, 0x8000);
 
 	// first calculate all 4bpp tiles
 	for (INT32 i = 0; i < nGraphicsSize; i+= 0x80) {
@@ -699,6 +859,16 @@ static void calculate_transtab()
 			}
 		}
 	}
+
+	// and the 8bpp tiles that need alphatable
+	for (INT32 i = 0; i < nGraphicsSize; i+= 0x100) {
+		for (INT32 j = 0; j < 0x100; j++) {
+			if (pPsikyoshTiles[i + j] >= 0xc0) {
+				DrvAlphaTab[i>>11] |= 1 << ((i >> 8) & 7);
+				break;
+			}
+		}
+	}
 }
 
 void PsikyoshVideoInit(INT32 gfx_max, INT32 gfx_min)
@@ -721,6 +891,13 @@ void PsikyoshVideoInit(INT32 gfx_max, INT32 gfx_min)
 
 	calculate_transtab();
 	fill_alphatable();
+
+#if defined PSIKYOSH_SSE2
+	if (nHaveSSE2 < 0) {
+		__builtin_cpu_init();
+		nHaveSSE2 = __builtin_cpu_supports("sse2") ? 1 : 0;
+	}
+#endif
 }
 
 void PsikyoshVideoExit()
@@ -730,8 +907,10 @@ void PsikyoshVideoExit()
 	BurnFree (DrvTmpDraw_ptr);
 	DrvTmpDraw = NULL;
 	BurnFree (DrvTransTab);
+	BurnFree (DrvAlphaTab);
 	
 	nDrvZoomPrev		= -1;
+	nDrvZoomOpaque		= 0;
 	pPsikyoshTiles		= NULL;
 	pPsikyoshSpriteBuffer	= NULL;
 	pPsikyoshBgRAM		= NULL;
@@ -6,6 +6,9 @@
 #include "z80_intf.h"
 #include "msm6295.h"
 #include "burn_ym3812.h"
+#include "burn_sched.h"
+#include "burn_idle.h"
+#include "burn_prof.h"
 
 static UINT8 DrvJoy1[16];
 static UINT8 DrvJoy2[16];
@@ -174,6 +177,7 @@ void __fastcall crospang_write_word(UINT32 address, UINT16 data)
 			return;
 			
 			case 0x270000:
+				BurnSchedSync();
 				*soundlatch = data & 0xff;
 			return;
 		}
@@ -197,6 +201,7 @@ void __fastcall crospang_write_word(UINT32 address, UINT16 data)
 			return;
 	
 			case 0x270000:
+				BurnSchedSync();
 				*soundlatch = data & 0xff;
 			return;
 		}
@@ -276,6 +281,13 @@ void crospangYM3812IrqHandler(INT32, INT32 nStatus)
 	}
 }
 
+static void DrvVBlank(INT32)
+{
+	SekOpen(0);
+	SekSetIRQLine(6, CPU_IRQSTATUS_AUTO);
+	SekClose();
+}
+
 static INT32 DrvDoReset()
 {
 	DrvReset = 0;
@@ -293,6 +305,8 @@ static INT32 DrvDoReset()
 	BurnYM3812Reset();
 	MSM6295Reset(0);
 
+	BurnSchedReset();
+
 	return 0;
 }
 
@@ -464,6 +478,15 @@ static INT32 DrvInit(INT32 (*pRomLoadCallback)())
 	MSM6295Init(0, 1056000 / 132, 1);
 	MSM6295SetRoute(0, 1.00, BURN_SND_ROUTE_BOTH);
 
+	BurnSchedInit();
+	BurnSchedAddCpu(&SekConfig, 0, 7159090);
+	BurnSchedAttachTimer(BurnSchedAddCpu(&ZetConfig, 0, 3579545), BurnTimerUpdateYM3812, BurnTimerEndFrameYM3812, BurnTimerUpdateEndYM3812);
+	BurnSchedSetLines(1, DrvVBlank);
+
+	// the sound cpu only ever waits on the latch or the ym3812 timers, neither
+	// of which can change in the middle of one of its runs
+	BurnIdleEnable(IDLE_CPU_Z80, 0, 1);
+
 	GenericTilesInit();
 
 	DrvDoReset();
@@ -480,6 +503,8 @@ static INT32 DrvExit()
 	SekExit();
 	ZetExit();
 
+	BurnSchedExit();
+
 	BurnFree (AllMem);
 
 	MSM6295ROM = NULL;
@@ -619,28 +644,21 @@ static INT32 DrvFrame()
 		DrvInputs[2] = (DrvDips[1] << 8) | DrvDips[0];
 	}
 
-	INT32 nTotalCycles[2] = { 7159090 / 60, 3579545 / 60 };
-
-	SekNewFrame();
-	ZetNewFrame();
-
-	SekOpen(0);
-	ZetOpen(0);
-
-	SekRun(nTotalCycles[0]);
-	SekSetIRQLine(6, CPU_IRQSTATUS_AUTO);
+	BurnSchedFrame();
 
 	if (pBurnSoundOut) {
-		BurnTimerEndFrameYM3812(nTotalCycles[1]);
+		BURN_PROF_BEGIN(BURN_PROF_SOUND);
+		ZetOpen(0);
 		BurnYM3812Update(pBurnSoundOut, nBurnSoundLen);
 		MSM6295Render(0, pBurnSoundOut, nBurnSoundLen);
+		ZetClose();
+		BURN_PROF_END(BURN_PROF_SOUND);
 	}
 
-	ZetClose();
-	SekClose();
-
 	if (pBurnDraw) {
+		BURN_PROF_BEGIN(BURN_PROF_DRAW);
 		DrvDraw();
+		BURN_PROF_END(BURN_PROF_DRAW);
 	}
 
 	return 0;
@@ -667,6 +685,8 @@ static INT32 DrvScan(INT32 nAction,INT32 *pnMin)
 
 		BurnYM3812Scan(nAction, pnMin);
 		MSM6295Scan(nAction, pnMin);
+
+		BurnSchedScan(nAction, pnMin);
 	}
 
 	return 0;
@@ -68,62 +68,6 @@ static INT32 m_twidth_mask_bit=7;
 #define ORIENTATION_FLIP_Y	1
 
 
-static UINT16 *m_src0;
-static UINT16 *m_src_s0;
-static UINT16 *m_src_e0;
-static UINT16 m_clip_al0;
-static UINT16 m_clip_ar0;
-static UINT16 m_clip_bl0;
-static UINT16 m_clip_br0;
-static UINT8 *m_tsrc0;
-static UINT8 *m_tsrc_s0;
-static UINT32 m_x_count0;
-static UINT32 m_x_zoom0;
-static UINT16 *m_src1;
-static UINT16 *m_src_s1;
-static UINT16 *m_src_e1;
-static UINT16 m_clip_al1;
-static UINT16 m_clip_ar1;
-static UINT16 m_clip_bl1;
-static UINT16 m_clip_br1;
-static UINT8 *m_tsrc1;
-static UINT8 *m_tsrc_s1;
-static UINT32 m_x_count1;
-static UINT32 m_x_zoom1;
-static UINT16 *m_src2;
-static UINT16 *m_src_s2;
-static UINT16 *m_src_e2;
-static UINT16 m_clip_al2;
-static UINT16 m_clip_ar2;
-static UINT16 m_clip_bl2;
-static UINT16 m_clip_br2;
-static UINT8 *m_tsrc2;
-static UINT8 *m_tsrc_s2;
-static UINT32 m_x_count2;
-static UINT32 m_x_zoom2;
-static UINT16 *m_src3;
-static UINT16 *m_src_s3;
-static UINT16 *m_src_e3;
-static UINT16 m_clip_al3;
-static UINT16 m_clip_ar3;
-static UINT16 m_clip_bl3;
-static UINT16 m_clip_br3;
-static UINT8 *m_tsrc3;
-static UINT8 *m_tsrc_s3;
-static UINT32 m_x_count3;
-static UINT32 m_x_zoom3;
-static UINT16 *m_src4;
-static UINT16 *m_src_s4;
-static UINT16 *m_src_e4;
-static UINT16 m_clip_al4;
-static UINT16 m_clip_ar4;
-static UINT16 m_clip_bl4;
-static UINT16 m_clip_br4;
-static UINT8 *m_tsrc4;
-static UINT8 *m_tsrc_s4;
-static UINT32 m_x_count4;
-static UINT32 m_x_zoom4;
-
 static UINT8 m_add_sat[256][256];
 
 static INT32 m_f3_alpha_level_2as;
@@ -136,37 +80,36 @@ static INT32 m_f3_alpha_level_3bs;
 static INT32 m_f3_alpha_level_3bd;
 static INT32 m_alpha_level_last;
 
-static INT32 m_alpha_s_1_1;
-static INT32 m_alpha_s_1_2;
-static INT32 m_alpha_s_1_4;
-static INT32 m_alpha_s_1_5;
-static INT32 m_alpha_s_1_6;
-static INT32 m_alpha_s_1_8;
-static INT32 m_alpha_s_1_9;
-static INT32 m_alpha_s_1_a;
-static INT32 m_alpha_s_2a_0;
-static INT32 m_alpha_s_2a_4;
-static INT32 m_alpha_s_2a_8;
-static INT32 m_alpha_s_2b_0;
-static INT32 m_alpha_s_2b_4;
-static INT32 m_alpha_s_2b_8;
-static INT32 m_alpha_s_3a_0;
-static INT32 m_alpha_s_3a_1;
-static INT32 m_alpha_s_3a_2;
-static INT32 m_alpha_s_3b_0;
-static INT32 m_alpha_s_3b_1;
-static INT32 m_alpha_s_3b_2;
-static UINT32 m_dval;
-static UINT8 m_pval;
-static UINT8 m_tval;
-static UINT8 m_pdest_2a;
-static UINT8 m_pdest_2b;
-static INT32 m_tr_2a;
-static INT32 m_tr_2b;
-static UINT8 m_pdest_3a;
-static UINT8 m_pdest_3b;
-static INT32 m_tr_3a;
-static INT32 m_tr_3b;
+// Blend factors for one alpha level setting, see f3_alpha_set_level()
+struct f3_alpha_blend
+{
+	INT32 s_1_1, s_1_2, s_1_4, s_1_5, s_1_6, s_1_8, s_1_9, s_1_a;
+	INT32 s_2a_0, s_2a_4, s_2a_8;
+	INT32 s_2b_0, s_2b_4, s_2b_8;
+	INT32 s_3a_0, s_3a_1, s_3a_2;
+	INT32 s_3b_0, s_3b_1, s_3b_2;
+	UINT8 pdest_2a, pdest_2b, pdest_3a, pdest_3b;
+	INT32 tr_2a, tr_2b, tr_3a, tr_3b;
+};
+
+static struct f3_alpha_blend m_alpha;
+
+// Pixel being composited
+struct f3_pixel
+{
+	UINT32 dval;
+	UINT8 pval;
+	UINT8 tval;
+};
+
+// Playfield source of the scanline being composited
+struct f3_pf_cursor
+{
+	UINT16 *src, *src_s, *src_e;
+	UINT8 *tsrc, *tsrc_s;
+	UINT32 x_count, x_zoom;
+	UINT16 clip_al, clip_ar, clip_bl, clip_br;
+};
 
 #define BYTE4_XOR_LE(x)	x
 
@@ -210,11 +153,6 @@ static void clear_f3_stuff()
 }
 
 
-static INT32 (*m_dpix_n[8][16])(UINT32 s_pix);
-static INT32 (**m_dpix_lp[5])(UINT32 s_pix);
-static INT32 (**m_dpix_sp[9])(UINT32 s_pix);
-
-
 static void draw_pf_layer(INT32 layer)
 {
 	INT32 offset = (layer * (0x1000 << extended_layers));
@@ -1038,36 +976,36 @@ static void draw_sprites()
 
 static inline void f3_alpha_set_level()
 {
-//  SET_ALPHA_LEVEL(m_alpha_s_1_1, m_f3_alpha_level_2ad)
-	SET_ALPHA_LEVEL(m_alpha_s_1_1, 255-m_f3_alpha_level_2as)
-//  SET_ALPHA_LEVEL(m_alpha_s_1_2, m_f3_alpha_level_2bd)
-	SET_ALPHA_LEVEL(m_alpha_s_1_2, 255-m_f3_alpha_level_2bs)
-	SET_ALPHA_LEVEL(m_alpha_s_1_4, m_f3_alpha_level_3ad)
-//  SET_ALPHA_LEVEL(m_alpha_s_1_5, m_f3_alpha_level_3ad*m_f3_alpha_level_2ad/255)
-	SET_ALPHA_LEVEL(m_alpha_s_1_5, m_f3_alpha_level_3ad*(255-m_f3_alpha_level_2as)/255)
-//  SET_ALPHA_LEVEL(m_alpha_s_1_6, m_f3_alpha_level_3ad*m_f3_alpha_level_2bd/255)
-	SET_ALPHA_LEVEL(m_alpha_s_1_6, m_f3_alpha_level_3ad*(255-m_f3_alpha_level_2bs)/255)
-	SET_ALPHA_LEVEL(m_alpha_s_1_8, m_f3_alpha_level_3bd)
-//  SET_ALPHA_LEVEL(m_alpha_s_1_9, m_f3_alpha_level_3bd*m_f3_alpha_level_2ad/255)
-	SET_ALPHA_LEVEL(m_alpha_s_1_9, m_f3_alpha_level_3bd*(255-m_f3_alpha_level_2as)/255)
-//  SET_ALPHA_LEVEL(m_alpha_s_1_a, m_f3_alpha_level_3bd*m_f3_alpha_level_2bd/255)
-	SET_ALPHA_LEVEL(m_alpha_s_1_a, m_f3_alpha_level_3bd*(255-m_f3_alpha_level_2bs)/255)
-
-	SET_ALPHA_LEVEL(m_alpha_s_2a_0, m_f3_alpha_level_2as)
-	SET_ALPHA_LEVEL(m_alpha_s_2a_4, m_f3_alpha_level_2as*m_f3_alpha_level_3ad/255)
-	SET_ALPHA_LEVEL(m_alpha_s_2a_8, m_f3_alpha_level_2as*m_f3_alpha_level_3bd/255)
-
-	SET_ALPHA_LEVEL(m_alpha_s_2b_0, m_f3_alpha_level_2bs)
-	SET_ALPHA_LEVEL(m_alpha_s_2b_4, m_f3_alpha_level_2bs*m_f3_alpha_level_3ad/255)
-	SET_ALPHA_LEVEL(m_alpha_s_2b_8, m_f3_alpha_level_2bs*m_f3_alpha_level_3bd/255)
-
-	SET_ALPHA_LEVEL(m_alpha_s_3a_0, m_f3_alpha_level_3as)
-	SET_ALPHA_LEVEL(m_alpha_s_3a_1, m_f3_alpha_level_3as*m_f3_alpha_level_2ad/255)
-	SET_ALPHA_LEVEL(m_alpha_s_3a_2, m_f3_alpha_level_3as*m_f3_alpha_level_2bd/255)
-
-	SET_ALPHA_LEVEL(m_alpha_s_3b_0, m_f3_alpha_level_3bs)
-	SET_ALPHA_LEVEL(m_alpha_s_3b_1, m_f3_alpha_level_3bs*m_f3_alpha_level_2ad/255)
-	SET_ALPHA_LEVEL(m_alpha_s_3b_2, m_f3_alpha_level_3bs*m_f3_alpha_level_2bd/255)
+//  SET_ALPHA_LEVEL(m_alpha.s_1_1, m_f3_alpha_level_2ad)
+	SET_ALPHA_LEVEL(m_alpha.s_1_1, 255-m_f3_alpha_level_2as)
+//  SET_ALPHA_LEVEL(m_alpha.s_1_2, m_f3_alpha_level_2bd)
+	SET_ALPHA_LEVEL(m_alpha.s_1_2, 255-m_f3_alpha_level_2bs)
+	SET_ALPHA_LEVEL(m_alpha.s_1_4, m_f3_alpha_level_3ad)
+//  SET_ALPHA_LEVEL(m_alpha.s_1_5, m_f3_alpha_level_3ad*m_f3_alpha_level_2ad/255)
+	SET_ALPHA_LEVEL(m_alpha.s_1_5, m_f3_alpha_level_3ad*(255-m_f3_alpha_level_2as)/255)
+//  SET_ALPHA_LEVEL(m_alpha.s_1_6, m_f3_alpha_level_3ad*m_f3_alpha_level_2bd/255)
+	SET_ALPHA_LEVEL(m_alpha.s_1_6, m_f3_alpha_level_3ad*(255-m_f3_alpha_level_2bs)/255)
+	SET_ALPHA_LEVEL(m_alpha.s_1_8, m_f3_alpha_level_3bd)
+//  SET_ALPHA_LEVEL(m_alpha.s_1_9, m_f3_alpha_level_3bd*m_f3_alpha_level_2ad/255)
+	SET_ALPHA_LEVEL(m_alpha.s_1_9, m_f3_alpha_level_3bd*(255-m_f3_alpha_level_2as)/255)
+//  SET_ALPHA_LEVEL(m_alpha.s_1_a, m_f3_alpha_level_3bd*m_f3_alpha_level_2bd/255)
+	SET_ALPHA_LEVEL(m_alpha.s_1_a, m_f3_alpha_level_3bd*(255-m_f3_alpha_level_2bs)/255)
+
+	SET_ALPHA_LEVEL(m_alpha.s_2a_0, m_f3_alpha_level_2as)
+	SET_ALPHA_LEVEL(m_alpha.s_2a_4, m_f3_alpha_level_2as*m_f3_alpha_level_3ad/255)
+	SET_ALPHA_LEVEL(m_alpha.s_2a_8, m_f3_alpha_level_2as*m_f3_alpha_level_3bd/255)
+
+	SET_ALPHA_LEVEL(m_alpha.s_2b_0, m_f3_alpha_level_2bs)
+	SET_ALPHA_LEVEL(m_alpha.s_2b_4, m_f3_alpha_level_2bs*m_f3_alpha_level_3ad/255)
+	SET_ALPHA_LEVEL(m_alpha.s_2b_8, m_f3_alpha_level_2bs*m_f3_alpha_level_3bd/255)
+
+	SET_ALPHA_LEVEL(m_alpha.s_3a_0, m_f3_alpha_level_3as)
+	SET_ALPHA_LEVEL(m_alpha.s_3a_1, m_f3_alpha_level_3as*m_f3_alpha_level_2ad/255)
+	SET_ALPHA_LEVEL(m_alpha.s_3a_2, m_f3_alpha_level_3as*m_f3_alpha_level_2bd/255)
+
+	SET_ALPHA_LEVEL(m_alpha.s_3b_0, m_f3_alpha_level_3bs)
+	SET_ALPHA_LEVEL(m_alpha.s_3b_1, m_f3_alpha_level_3bs*m_f3_alpha_level_2ad/255)
+	SET_ALPHA_LEVEL(m_alpha.s_3b_2, m_f3_alpha_level_3bs*m_f3_alpha_level_2bd/255)
 }
 #undef SET_ALPHA_LEVEL
 
@@ -1075,19 +1013,19 @@ static inline void f3_alpha_set_level()
 #define COLOR2 BYTE4_XOR_LE(1)
 #define COLOR3 BYTE4_XOR_LE(2)
 
-static inline void f3_alpha_blend32_s(INT32 alphas, UINT32 s)
+static inline void f3_alpha_blend32_s(struct f3_pixel *p, INT32 alphas, UINT32 s)
 {
 	UINT8 *sc = (UINT8 *)&s;
-	UINT8 *dc = (UINT8 *)&m_dval;
+	UINT8 *dc = (UINT8 *)&p->dval;
 	dc[COLOR1] = (alphas * sc[COLOR1]) >> 8;
 	dc[COLOR2] = (alphas * sc[COLOR2]) >> 8;
 	dc[COLOR3] = (alphas * sc[COLOR3]) >> 8;
 }
 
-static inline void f3_alpha_blend32_d(INT32 alphas, UINT32 s)
+static inline void f3_alpha_blend32_d(struct f3_pixel *p, INT32 alphas, UINT32 s)
 {
 	UINT8 *sc = (UINT8 *)&s;
-	UINT8 *dc = (UINT8 *)&m_dval;
+	UINT8 *dc = (UINT8 *)&p->dval;
 	dc[COLOR1] = m_add_sat[dc[COLOR1]][(alphas * sc[COLOR1]) >> 8];
 	dc[COLOR2] = m_add_sat[dc[COLOR2]][(alphas * sc[COLOR2]) >> 8];
 	dc[COLOR3] = m_add_sat[dc[COLOR3]][(alphas * sc[COLOR3]) >> 8];
@@ -1095,391 +1033,203 @@ static inline void f3_alpha_blend32_d(INT32 alphas, UINT32 s)
 
 /*============================================================================*/
 
-static inline void f3_alpha_blend_1_1(UINT32 s){f3_alpha_blend32_d(m_alpha_s_1_1,s);}
-static inline void f3_alpha_blend_1_2(UINT32 s){f3_alpha_blend32_d(m_alpha_s_1_2,s);}
-static inline void f3_alpha_blend_1_4(UINT32 s){f3_alpha_blend32_d(m_alpha_s_1_4,s);}
-static inline void f3_alpha_blend_1_5(UINT32 s){f3_alpha_blend32_d(m_alpha_s_1_5,s);}
-static inline void f3_alpha_blend_1_6(UINT32 s){f3_alpha_blend32_d(m_alpha_s_1_6,s);}
-static inline void f3_alpha_blend_1_8(UINT32 s){f3_alpha_blend32_d(m_alpha_s_1_8,s);}
-static inline void f3_alpha_blend_1_9(UINT32 s){f3_alpha_blend32_d(m_alpha_s_1_9,s);}
-static inline void f3_alpha_blend_1_a(UINT32 s){f3_alpha_blend32_d(m_alpha_s_1_a,s);}
-
-static inline void f3_alpha_blend_2a_0(UINT32 s){f3_alpha_blend32_s(m_alpha_s_2a_0,s);}
-static inline void f3_alpha_blend_2a_4(UINT32 s){f3_alpha_blend32_d(m_alpha_s_2a_4,s);}
-static inline void f3_alpha_blend_2a_8(UINT32 s){f3_alpha_blend32_d(m_alpha_s_2a_8,s);}
+// The compositor state (blend levels, current pixel) is passed around instead of
+// living in statics, so several scanlines can be drawn at the same time.
+#define F3_DPIX_ARGS	const struct f3_alpha_blend *a, struct f3_pixel *p, UINT32 s_pix
 
-static inline void f3_alpha_blend_2b_0(UINT32 s){f3_alpha_blend32_s(m_alpha_s_2b_0,s);}
-static inline void f3_alpha_blend_2b_4(UINT32 s){f3_alpha_blend32_d(m_alpha_s_2b_4,s);}
-static inline void f3_alpha_blend_2b_8(UINT32 s){f3_alpha_blend32_d(m_alpha_s_2b_8,s);}
-
-static inline void f3_alpha_blend_3a_0(UINT32 s){f3_alpha_blend32_s(m_alpha_s_3a_0,s);}
-static inline void f3_alpha_blend_3a_1(UINT32 s){f3_alpha_blend32_d(m_alpha_s_3a_1,s);}
-static inline void f3_alpha_blend_3a_2(UINT32 s){f3_alpha_blend32_d(m_alpha_s_3a_2,s);}
-
-static inline void f3_alpha_blend_3b_0(UINT32 s){f3_alpha_blend32_s(m_alpha_s_3b_0,s);}
-static inline void f3_alpha_blend_3b_1(UINT32 s){f3_alpha_blend32_d(m_alpha_s_3b_1,s);}
-static inline void f3_alpha_blend_3b_2(UINT32 s){f3_alpha_blend32_d(m_alpha_s_3b_2,s);}
-
-/*============================================================================*/
+static inline INT32 dpix_1_noalpha(struct f3_pixel *p, UINT32 s_pix) {p->dval = s_pix; return 1;}
+static inline INT32 dpix_1_x(struct f3_pixel *p, INT32 alphas, UINT32 s_pix) {if(s_pix) f3_alpha_blend32_d(p,alphas,s_pix); return 1;}
 
-static INT32 dpix_1_noalpha(UINT32 s_pix) {m_dval = s_pix; return 1;}
-static INT32 dpix_ret1(UINT32 /*s_pix*/) {return 1;}
-static INT32 dpix_ret0(UINT32 /*s_pix*/) {return 0;}
-static INT32 dpix_1_1(UINT32 s_pix) {if(s_pix) f3_alpha_blend_1_1(s_pix); return 1;}
-static INT32 dpix_1_2(UINT32 s_pix) {if(s_pix) f3_alpha_blend_1_2(s_pix); return 1;}
-static INT32 dpix_1_4(UINT32 s_pix) {if(s_pix) f3_alpha_blend_1_4(s_pix); return 1;}
-static INT32 dpix_1_5(UINT32 s_pix) {if(s_pix) f3_alpha_blend_1_5(s_pix); return 1;}
-static INT32 dpix_1_6(UINT32 s_pix) {if(s_pix) f3_alpha_blend_1_6(s_pix); return 1;}
-static INT32 dpix_1_8(UINT32 s_pix) {if(s_pix) f3_alpha_blend_1_8(s_pix); return 1;}
-static INT32 dpix_1_9(UINT32 s_pix) {if(s_pix) f3_alpha_blend_1_9(s_pix); return 1;}
-static INT32 dpix_1_a(UINT32 s_pix) {if(s_pix) f3_alpha_blend_1_a(s_pix); return 1;}
-
-static INT32 dpix_2a_0(UINT32 s_pix)
+static inline INT32 dpix_2a_0(F3_DPIX_ARGS)
 {
-	if(s_pix) f3_alpha_blend_2a_0(s_pix);
-	else      m_dval = 0;
-	if(m_pdest_2a) {m_pval |= m_pdest_2a;return 0;}
+	if(s_pix) f3_alpha_blend32_s(p,a->s_2a_0,s_pix);
+	else      p->dval = 0;
+	if(a->pdest_2a) {p->pval |= a->pdest_2a;return 0;}
 	return 1;
 }
-static INT32 dpix_2a_4(UINT32 s_pix)
+static inline INT32 dpix_2a_x(F3_DPIX_ARGS, INT32 alphas)
 {
-	if(s_pix) f3_alpha_blend_2a_4(s_pix);
-	if(m_pdest_2a) {m_pval |= m_pdest_2a;return 0;}
-	return 1;
-}
-static INT32 dpix_2a_8(UINT32 s_pix)
-{
-	if(s_pix) f3_alpha_blend_2a_8(s_pix);
-	if(m_pdest_2a) {m_pval |= m_pdest_2a;return 0;}
+	if(s_pix) f3_alpha_blend32_d(p,alphas,s_pix);
+	if(a->pdest_2a) {p->pval |= a->pdest_2a;return 0;}
 	return 1;
 }
 
-static INT32 dpix_3a_0(UINT32 s_pix)
-{
-	if(s_pix) f3_alpha_blend_3a_0(s_pix);
-	else      m_dval = 0;
-	if(m_pdest_3a) {m_pval |= m_pdest_3a;return 0;}
-	return 1;
-}
-static INT32 dpix_3a_1(UINT32 s_pix)
+static inline INT32 dpix_3a_0(F3_DPIX_ARGS)
 {
-	if(s_pix) f3_alpha_blend_3a_1(s_pix);
-	if(m_pdest_3a) {m_pval |= m_pdest_3a;return 0;}
+	if(s_pix) f3_alpha_blend32_s(p,a->s_3a_0,s_pix);
+	else      p->dval = 0;
+	if(a->pdest_3a) {p->pval |= a->pdest_3a;return 0;}
 	return 1;
 }
-static INT32 dpix_3a_2(UINT32 s_pix)
+static inline INT32 dpix_3a_x(F3_DPIX_ARGS, INT32 alphas)
 {
-	if(s_pix) f3_alpha_blend_3a_2(s_pix);
-	if(m_pdest_3a) {m_pval |= m_pdest_3a;return 0;}
+	if(s_pix) f3_alpha_blend32_d(p,alphas,s_pix);
+	if(a->pdest_3a) {p->pval |= a->pdest_3a;return 0;}
 	return 1;
 }
 
-static INT32 dpix_2b_0(UINT32 s_pix)
-{
-	if(s_pix) f3_alpha_blend_2b_0(s_pix);
-	else      m_dval = 0;
-	if(m_pdest_2b) {m_pval |= m_pdest_2b;return 0;}
-	return 1;
-}
-static INT32 dpix_2b_4(UINT32 s_pix)
+static inline INT32 dpix_2b_0(F3_DPIX_ARGS)
 {
-	if(s_pix) f3_alpha_blend_2b_4(s_pix);
-	if(m_pdest_2b) {m_pval |= m_pdest_2b;return 0;}
+	if(s_pix) f3_alpha_blend32_s(p,a->s_2b_0,s_pix);
+	else      p->dval = 0;
+	if(a->pdest_2b) {p->pval |= a->pdest_2b;return 0;}
 	return 1;
 }
-static INT32 dpix_2b_8(UINT32 s_pix)
+static inline INT32 dpix_2b_x(F3_DPIX_ARGS, INT32 alphas)
 {
-	if(s_pix) f3_alpha_blend_2b_8(s_pix);
-	if(m_pdest_2b) {m_pval |= m_pdest_2b;return 0;}
+	if(s_pix) f3_alpha_blend32_d(p,alphas,s_pix);
+	if(a->pdest_2b) {p->pval |= a->pdest_2b;return 0;}
 	return 1;
 }
 
-static INT32 dpix_3b_0(UINT32 s_pix)
-{
-	if(s_pix) f3_alpha_blend_3b_0(s_pix);
-	else      m_dval = 0;
-	if(m_pdest_3b) {m_pval |= m_pdest_3b;return 0;}
-	return 1;
-}
-static INT32 dpix_3b_1(UINT32 s_pix)
+static inline INT32 dpix_3b_0(F3_DPIX_ARGS)
 {
-	if(s_pix) f3_alpha_blend_3b_1(s_pix);
-	if(m_pdest_3b) {m_pval |= m_pdest_3b;return 0;}
+	if(s_pix) f3_alpha_blend32_s(p,a->s_3b_0,s_pix);
+	else      p->dval = 0;
+	if(a->pdest_3b) {p->pval |= a->pdest_3b;return 0;}
 	return 1;
 }
-static INT32 dpix_3b_2(UINT32 s_pix)
+static inline INT32 dpix_3b_x(F3_DPIX_ARGS, INT32 alphas)
 {
-	if(s_pix) f3_alpha_blend_3b_2(s_pix);
-	if(m_pdest_3b) {m_pval |= m_pdest_3b;return 0;}
+	if(s_pix) f3_alpha_blend32_d(p,alphas,s_pix);
+	if(a->pdest_3b) {p->pval |= a->pdest_3b;return 0;}
 	return 1;
 }
 
-static INT32 dpix_2_0(UINT32 s_pix)
-{
-	UINT8 tr2=m_tval&1;
-	if(s_pix)
-	{
-		if(tr2==m_tr_2b)     {f3_alpha_blend_2b_0(s_pix);if(m_pdest_2b) m_pval |= m_pdest_2b;else return 1;}
-		else if(tr2==m_tr_2a)    {f3_alpha_blend_2a_0(s_pix);if(m_pdest_2a) m_pval |= m_pdest_2a;else return 1;}
-	}
-	else
-	{
-		if(tr2==m_tr_2b)     {m_dval = 0;if(m_pdest_2b) m_pval |= m_pdest_2b;else return 1;}
-		else if(tr2==m_tr_2a)    {m_dval = 0;if(m_pdest_2a) m_pval |= m_pdest_2a;else return 1;}
-	}
-	return 0;
-}
-static INT32 dpix_2_4(UINT32 s_pix)
+// n is 0 when nothing was blended under the pixel yet: source-only blend, cleared when transparent
+static inline INT32 dpix_2_x(F3_DPIX_ARGS, INT32 alphas_a, INT32 alphas_b, INT32 n)
 {
-	UINT8 tr2=m_tval&1;
+	UINT8 tr2=p->tval&1;
 	if(s_pix)
 	{
-		if(tr2==m_tr_2b)     {f3_alpha_blend_2b_4(s_pix);if(m_pdest_2b) m_pval |= m_pdest_2b;else return 1;}
-		else if(tr2==m_tr_2a)    {f3_alpha_blend_2a_4(s_pix);if(m_pdest_2a) m_pval |= m_pdest_2a;else return 1;}
+		if(tr2==a->tr_2b)        {if(n) f3_alpha_blend32_d(p,alphas_b,s_pix); else f3_alpha_blend32_s(p,alphas_b,s_pix);if(a->pdest_2b) p->pval |= a->pdest_2b;else return 1;}
+		else if(tr2==a->tr_2a)   {if(n) f3_alpha_blend32_d(p,alphas_a,s_pix); else f3_alpha_blend32_s(p,alphas_a,s_pix);if(a->pdest_2a) p->pval |= a->pdest_2a;else return 1;}
 	}
 	else
 	{
-		if(tr2==m_tr_2b)     {if(m_pdest_2b) m_pval |= m_pdest_2b;else return 1;}
-		else if(tr2==m_tr_2a)    {if(m_pdest_2a) m_pval |= m_pdest_2a;else return 1;}
-	}
-	return 0;
-}
-static INT32 dpix_2_8(UINT32 s_pix)
-{
-	UINT8 tr2=m_tval&1;
-	if(s_pix)
-	{
-		if(tr2==m_tr_2b)     {f3_alpha_blend_2b_8(s_pix);if(m_pdest_2b) m_pval |= m_pdest_2b;else return 1;}
-		else if(tr2==m_tr_2a)    {f3_alpha_blend_2a_8(s_pix);if(m_pdest_2a) m_pval |= m_pdest_2a;else return 1;}
-	}
-	else
-	{
-		if(tr2==m_tr_2b)     {if(m_pdest_2b) m_pval |= m_pdest_2b;else return 1;}
-		else if(tr2==m_tr_2a)    {if(m_pdest_2a) m_pval |= m_pdest_2a;else return 1;}
+		if(tr2==a->tr_2b)        {if(!n) p->dval = 0;if(a->pdest_2b) p->pval |= a->pdest_2b;else return 1;}
+		else if(tr2==a->tr_2a)   {if(!n) p->dval = 0;if(a->pdest_2a) p->pval |= a->pdest_2a;else return 1;}
 	}
 	return 0;
 }
 
-static INT32 dpix_3_0(UINT32 s_pix)
+static inline INT32 dpix_3_x(F3_DPIX_ARGS, INT32 alphas_a, INT32 alphas_b, INT32 n)
 {
-	UINT8 tr2=m_tval&1;
+	UINT8 tr2=p->tval&1;
 	if(s_pix)
 	{
-		if(tr2==m_tr_3b)     {f3_alpha_blend_3b_0(s_pix);if(m_pdest_3b) m_pval |= m_pdest_3b;else return 1;}
-		else if(tr2==m_tr_3a)    {f3_alpha_blend_3a_0(s_pix);if(m_pdest_3a) m_pval |= m_pdest_3a;else return 1;}
+		if(tr2==a->tr_3b)        {if(n) f3_alpha_blend32_d(p,alphas_b,s_pix); else f3_alpha_blend32_s(p,alphas_b,s_pix);if(a->pdest_3b) p->pval |= a->pdest_3b;else return 1;}
+		else if(tr2==a->tr_3a)   {if(n) f3_alpha_blend32_d(p,alphas_a,s_pix); else f3_alpha_blend32_s(p,alphas_a,s_pix);if(a->pdest_3a) p->pval |= a->pdest_3a;else return 1;}
 	}
 	else
 	{
-		if(tr2==m_tr_3b)     {m_dval = 0;if(m_pdest_3b) m_pval |= m_pdest_3b;else return 1;}
-		else if(tr2==m_tr_3a)    {m_dval = 0;if(m_pdest_3a) m_pval |= m_pdest_3a;else return 1;}
+		if(tr2==a->tr_3b)        {if(!n) p->dval = 0;if(a->pdest_3b) p->pval |= a->pdest_3b;else return 1;}
+		else if(tr2==a->tr_3a)   {if(!n) p->dval = 0;if(a->pdest_3a) p->pval |= a->pdest_3a;else return 1;}
 	}
 	return 0;
 }
-static INT32 dpix_3_1(UINT32 s_pix)
+
+// Blend onto the layers already drawn, selected by the alpha destination bits of the pixel
+static inline INT32 dpix_1(F3_DPIX_ARGS)
 {
-	UINT8 tr2=m_tval&1;
-	if(s_pix)
+	switch(p->pval>>4)
 	{
-		if(tr2==m_tr_3b)     {f3_alpha_blend_3b_1(s_pix);if(m_pdest_3b) m_pval |= m_pdest_3b;else return 1;}
-		else if(tr2==m_tr_3a)    {f3_alpha_blend_3a_1(s_pix);if(m_pdest_3a) m_pval |= m_pdest_3a;else return 1;}
+		case 0x0: return dpix_1_noalpha(p,s_pix);
+		case 0x1: return dpix_1_x(p,a->s_1_1,s_pix);
+		case 0x2: return dpix_1_x(p,a->s_1_2,s_pix);
+		case 0x4: return dpix_1_x(p,a->s_1_4,s_pix);
+		case 0x5: return dpix_1_x(p,a->s_1_5,s_pix);
+		case 0x6: return dpix_1_x(p,a->s_1_6,s_pix);
+		case 0x8: return dpix_1_x(p,a->s_1_8,s_pix);
+		case 0x9: return dpix_1_x(p,a->s_1_9,s_pix);
+		case 0xa: return dpix_1_x(p,a->s_1_a,s_pix);
 	}
-	else
-	{
-		if(tr2==m_tr_3b)     {if(m_pdest_3b) m_pval |= m_pdest_3b;else return 1;}
-		else if(tr2==m_tr_3a)    {if(m_pdest_3a) m_pval |= m_pdest_3a;else return 1;}
-	}
-	return 0;
+	return 1;
 }
-static INT32 dpix_3_2(UINT32 s_pix)
+
+// Layer / sprite blend modes, what used to be the rows of the dpix_n function table:
+// 0 opaque, 1 opaque over blended layers, 2 / 3 blend mode 2 / 3 with level A,
+// 4 / 5 the same with level B, 6 / 7 with level A or B picked per tile
+static INT32 dpix_n(F3_DPIX_ARGS, INT32 mode)
 {
-	UINT8 tr2=m_tval&1;
-	if(s_pix)
-	{
-		if(tr2==m_tr_3b)     {f3_alpha_blend_3b_2(s_pix);if(m_pdest_3b) m_pval |= m_pdest_3b;else return 1;}
-		else if(tr2==m_tr_3a)    {f3_alpha_blend_3a_2(s_pix);if(m_pdest_3a) m_pval |= m_pdest_3a;else return 1;}
-	}
-	else
+	switch(mode)
 	{
-		if(tr2==m_tr_3b)     {if(m_pdest_3b) m_pval |= m_pdest_3b;else return 1;}
-		else if(tr2==m_tr_3a)    {if(m_pdest_3a) m_pval |= m_pdest_3a;else return 1;}
+		case 0: return dpix_1_noalpha(p,s_pix);
+		case 1: return dpix_1(a,p,s_pix);
+
+		case 2:
+			switch(p->pval>>4)
+			{
+				case 0x0: return dpix_2a_0(a,p,s_pix);
+				case 0x4: return dpix_2a_x(a,p,s_pix,a->s_2a_4);
+				case 0x8: return dpix_2a_x(a,p,s_pix,a->s_2a_8);
+			}
+			return 0;
+
+		case 3:
+			switch(p->pval>>4)
+			{
+				case 0x0: return dpix_3a_0(a,p,s_pix);
+				case 0x1: return dpix_3a_x(a,p,s_pix,a->s_3a_1);
+				case 0x2: return dpix_3a_x(a,p,s_pix,a->s_3a_2);
+			}
+			return 0;
+
+		case 4:
+			switch(p->pval>>4)
+			{
+				case 0x0: return dpix_2b_0(a,p,s_pix);
+				case 0x4: return dpix_2b_x(a,p,s_pix,a->s_2b_4);
+				case 0x8: return dpix_2b_x(a,p,s_pix,a->s_2b_8);
+			}
+			return 0;
+
+		case 5:
+			switch(p->pval>>4)
+			{
+				case 0x0: return dpix_3b_0(a,p,s_pix);
+				case 0x1: return dpix_3b_x(a,p,s_pix,a->s_3b_1);
+				case 0x2: return dpix_3b_x(a,p,s_pix,a->s_3b_2);
+			}
+			return 0;
+
+		case 6:
+			switch(p->pval>>4)
+			{
+				case 0x0: return dpix_2_x(a,p,s_pix,a->s_2a_0,a->s_2b_0,0);
+				case 0x4: return dpix_2_x(a,p,s_pix,a->s_2a_4,a->s_2b_4,1);
+				case 0x8: return dpix_2_x(a,p,s_pix,a->s_2a_8,a->s_2b_8,1);
+			}
+			return 0;
+
+		case 7:
+			switch(p->pval>>4)
+			{
+				case 0x0: return dpix_3_x(a,p,s_pix,a->s_3a_0,a->s_3b_0,0);
+				case 0x1: return dpix_3_x(a,p,s_pix,a->s_3a_1,a->s_3b_1,1);
+				case 0x2: return dpix_3_x(a,p,s_pix,a->s_3a_2,a->s_3b_2,1);
+			}
+			return 0;
 	}
 	return 0;
 }
 
-static inline void dpix_1_sprite(UINT32 s_pix)
+static inline void dpix_1_sprite(F3_DPIX_ARGS)
 {
-	if(s_pix)
-	{
-		UINT8 p1 = m_pval&0xf0;
-		if     (p1==0x10)   f3_alpha_blend_1_1(s_pix);
-		else if(p1==0x20)   f3_alpha_blend_1_2(s_pix);
-		else if(p1==0x40)   f3_alpha_blend_1_4(s_pix);
-		else if(p1==0x50)   f3_alpha_blend_1_5(s_pix);
-		else if(p1==0x60)   f3_alpha_blend_1_6(s_pix);
-		else if(p1==0x80)   f3_alpha_blend_1_8(s_pix);
-		else if(p1==0x90)   f3_alpha_blend_1_9(s_pix);
-		else if(p1==0xa0)   f3_alpha_blend_1_a(s_pix);
-	}
+	if(s_pix && (p->pval&0xf0)) dpix_1(a,p,s_pix);
 }
 
-static inline void dpix_bg(UINT32 bgcolor)
+static inline void dpix_bg(F3_DPIX_ARGS)
 {
-	UINT8 p1 = m_pval&0xf0;
-	if(!p1)         m_dval = bgcolor;
-	else if(p1==0x10)   f3_alpha_blend_1_1(bgcolor);
-	else if(p1==0x20)   f3_alpha_blend_1_2(bgcolor);
-	else if(p1==0x40)   f3_alpha_blend_1_4(bgcolor);
-	else if(p1==0x50)   f3_alpha_blend_1_5(bgcolor);
-	else if(p1==0x60)   f3_alpha_blend_1_6(bgcolor);
-	else if(p1==0x80)   f3_alpha_blend_1_8(bgcolor);
-	else if(p1==0x90)   f3_alpha_blend_1_9(bgcolor);
-	else if(p1==0xa0)   f3_alpha_blend_1_a(bgcolor);
+	dpix_1(a,p,s_pix);
 }
 
-/******************************************************************************/
+#undef F3_DPIX_ARGS
 
-static INT32 alpha_blend_inited = 0;
+/******************************************************************************/
 
 static void init_alpha_blend_func()
 {
-	alpha_blend_inited = 1;
-
-	m_dpix_n[0][0x0]=&dpix_1_noalpha;
-	m_dpix_n[0][0x1]=&dpix_1_noalpha;
-	m_dpix_n[0][0x2]=&dpix_1_noalpha;
-	m_dpix_n[0][0x3]=&dpix_1_noalpha;
-	m_dpix_n[0][0x4]=&dpix_1_noalpha;
-	m_dpix_n[0][0x5]=&dpix_1_noalpha;
-	m_dpix_n[0][0x6]=&dpix_1_noalpha;
-	m_dpix_n[0][0x7]=&dpix_1_noalpha;
-	m_dpix_n[0][0x8]=&dpix_1_noalpha;
-	m_dpix_n[0][0x9]=&dpix_1_noalpha;
-	m_dpix_n[0][0xa]=&dpix_1_noalpha;
-	m_dpix_n[0][0xb]=&dpix_1_noalpha;
-	m_dpix_n[0][0xc]=&dpix_1_noalpha;
-	m_dpix_n[0][0xd]=&dpix_1_noalpha;
-	m_dpix_n[0][0xe]=&dpix_1_noalpha;
-	m_dpix_n[0][0xf]=&dpix_1_noalpha;
-
-	m_dpix_n[1][0x0]=&dpix_1_noalpha;
-	m_dpix_n[1][0x1]=&dpix_1_1;
-	m_dpix_n[1][0x2]=&dpix_1_2;
-	m_dpix_n[1][0x3]=&dpix_ret1;
-	m_dpix_n[1][0x4]=&dpix_1_4;
-	m_dpix_n[1][0x5]=&dpix_1_5;
-	m_dpix_n[1][0x6]=&dpix_1_6;
-	m_dpix_n[1][0x7]=&dpix_ret1;
-	m_dpix_n[1][0x8]=&dpix_1_8;
-	m_dpix_n[1][0x9]=&dpix_1_9;
-	m_dpix_n[1][0xa]=&dpix_1_a;
-	m_dpix_n[1][0xb]=&dpix_ret1;
-	m_dpix_n[1][0xc]=&dpix_ret1;
-	m_dpix_n[1][0xd]=&dpix_ret1;
-	m_dpix_n[1][0xe]=&dpix_ret1;
-	m_dpix_n[1][0xf]=&dpix_ret1;
-
-	m_dpix_n[2][0x0]=&dpix_2a_0;
-	m_dpix_n[2][0x1]=&dpix_ret0;
-	m_dpix_n[2][0x2]=&dpix_ret0;
-	m_dpix_n[2][0x3]=&dpix_ret0;
-	m_dpix_n[2][0x4]=&dpix_2a_4;
-	m_dpix_n[2][0x5]=&dpix_ret0;
-	m_dpix_n[2][0x6]=&dpix_ret0;
-	m_dpix_n[2][0x7]=&dpix_ret0;
-	m_dpix_n[2][0x8]=&dpix_2a_8;
-	m_dpix_n[2][0x9]=&dpix_ret0;
-	m_dpix_n[2][0xa]=&dpix_ret0;
-	m_dpix_n[2][0xb]=&dpix_ret0;
-	m_dpix_n[2][0xc]=&dpix_ret0;
-	m_dpix_n[2][0xd]=&dpix_ret0;
-	m_dpix_n[2][0xe]=&dpix_ret0;
-	m_dpix_n[2][0xf]=&dpix_ret0;
-
-	m_dpix_n[3][0x0]=&dpix_3a_0;
-	m_dpix_n[3][0x1]=&dpix_3a_1;
-	m_dpix_n[3][0x2]=&dpix_3a_2;
-	m_dpix_n[3][0x3]=&dpix_ret0;
-	m_dpix_n[3][0x4]=&dpix_ret0;
-	m_dpix_n[3][0x5]=&dpix_ret0;
-	m_dpix_n[3][0x6]=&dpix_ret0;
-	m_dpix_n[3][0x7]=&dpix_ret0;
-	m_dpix_n[3][0x8]=&dpix_ret0;
-	m_dpix_n[3][0x9]=&dpix_ret0;
-	m_dpix_n[3][0xa]=&dpix_ret0;
-	m_dpix_n[3][0xb]=&dpix_ret0;
-	m_dpix_n[3][0xc]=&dpix_ret0;
-	m_dpix_n[3][0xd]=&dpix_ret0;
-	m_dpix_n[3][0xe]=&dpix_ret0;
-	m_dpix_n[3][0xf]=&dpix_ret0;
-
-	m_dpix_n[4][0x0]=&dpix_2b_0;
-	m_dpix_n[4][0x1]=&dpix_ret0;
-	m_dpix_n[4][0x2]=&dpix_ret0;
-	m_dpix_n[4][0x3]=&dpix_ret0;
-	m_dpix_n[4][0x4]=&dpix_2b_4;
-	m_dpix_n[4][0x5]=&dpix_ret0;
-	m_dpix_n[4][0x6]=&dpix_ret0;
-	m_dpix_n[4][0x7]=&dpix_ret0;
-	m_dpix_n[4][0x8]=&dpix_2b_8;
-	m_dpix_n[4][0x9]=&dpix_ret0;
-	m_dpix_n[4][0xa]=&dpix_ret0;
-	m_dpix_n[4][0xb]=&dpix_ret0;
-	m_dpix_n[4][0xc]=&dpix_ret0;
-	m_dpix_n[4][0xd]=&dpix_ret0;
-	m_dpix_n[4][0xe]=&dpix_ret0;
-	m_dpix_n[4][0xf]=&dpix_ret0;
-
-	m_dpix_n[5][0x0]=&dpix_3b_0;
-	m_dpix_n[5][0x1]=&dpix_3b_1;
-	m_dpix_n[5][0x2]=&dpix_3b_2;
-	m_dpix_n[5][0x3]=&dpix_ret0;
-	m_dpix_n[5][0x4]=&dpix_ret0;
-	m_dpix_n[5][0x5]=&dpix_ret0;
-	m_dpix_n[5][0x6]=&dpix_ret0;
-	m_dpix_n[5][0x7]=&dpix_ret0;
-	m_dpix_n[5][0x8]=&dpix_ret0;
-	m_dpix_n[5][0x9]=&dpix_ret0;
-	m_dpix_n[5][0xa]=&dpix_ret0;
-	m_dpix_n[5][0xb]=&dpix_ret0;
-	m_dpix_n[5][0xc]=&dpix_ret0;
-	m_dpix_n[5][0xd]=&dpix_ret0;
-	m_dpix_n[5][0xe]=&dpix_ret0;
-	m_dpix_n[5][0xf]=&dpix_ret0;
-
-	m_dpix_n[6][0x0]=&dpix_2_0;
-	m_dpix_n[6][0x1]=&dpix_ret0;
-	m_dpix_n[6][0x2]=&dpix_ret0;
-	m_dpix_n[6][0x3]=&dpix_ret0;
-	m_dpix_n[6][0x4]=&dpix_2_4;
-	m_dpix_n[6][0x5]=&dpix_ret0;
-	m_dpix_n[6][0x6]=&dpix_ret0;
-	m_dpix_n[6][0x7]=&dpix_ret0;
-	m_dpix_n[6][0x8]=&dpix_2_8;
-	m_dpix_n[6][0x9]=&dpix_ret0;
-	m_dpix_n[6][0xa]=&dpix_ret0;
-	m_dpix_n[6][0xb]=&dpix_ret0;
-	m_dpix_n[6][0xc]=&dpix_ret0;
-	m_dpix_n[6][0xd]=&dpix_ret0;
-	m_dpix_n[6][0xe]=&dpix_ret0;
-	m_dpix_n[6][0xf]=&dpix_ret0;
-
-	m_dpix_n[7][0x0]=&dpix_3_0;
-	m_dpix_n[7][0x1]=&dpix_3_1;
-	m_dpix_n[7][0x2]=&dpix_3_2;
-	m_dpix_n[7][0x3]=&dpix_ret0;
-	m_dpix_n[7][0x4]=&dpix_ret0;
-	m_dpix_n[7][0x5]=&dpix_ret0;
-	m_dpix_n[7][0x6]=&dpix_ret0;
-	m_dpix_n[7][0x7]=&dpix_ret0;
-	m_dpix_n[7][0x8]=&dpix_ret0;
-	m_dpix_n[7][0x9]=&dpix_ret0;
-	m_dpix_n[7][0xa]=&dpix_ret0;
-	m_dpix_n[7][0xb]=&dpix_ret0;
-	m_dpix_n[7][0xc]=&dpix_ret0;
-	m_dpix_n[7][0xd]=&dpix_ret0;
-	m_dpix_n[7][0xe]=&dpix_ret0;
-	m_dpix_n[7][0xf]=&dpix_ret0;
-
 	for(INT32 i = 0; i < 256; i++)
 		for(INT32 j = 0; j < 256; j++)
 			m_add_sat[i][j] = (i + j < 256) ? i + j : 255;
@@ -1487,180 +1237,180 @@ static void init_alpha_blend_func()
 
 /******************************************************************************/
 
+// One batch of scanlines sharing the same layer order and alpha setup, set up by
+// scanline_draw() and drawn by the f3_draw_line() variant picked for it
+struct f3_line_job
+{
+	const struct f3_playfield_line_inf *line_t[5];
+	INT32 sprite[6];
+	UINT8 mode_lp[5];		// dpix_n() mode of each layer
+	UINT8 mode_sp[16];		// dpix_n() mode of each sprite priority bit, 0 if it isn't blended
+	struct f3_alpha_blend alpha;
+	void (*draw)(const struct f3_line_job *job, INT32 y);
+};
+
+static struct f3_line_job m_line_job[256];
+static UINT8 m_line_job_num[256];			// Job of each scanline, 0xff if it isn't drawn
+static INT32 m_line_start, m_line_end;
+static UINT32 m_line_orient;
+
+#define F3_LINE_BANDS	8
+
 #define GET_PIXMAP_POINTER(pf_num) \
 { \
-	const struct f3_playfield_line_inf *line_tmp=line_t[pf_num]; \
-	m_src##pf_num=line_tmp->src[y]; \
-	m_src_s##pf_num=line_tmp->src_s[y]; \
-	m_src_e##pf_num=line_tmp->src_e[y]; \
-	m_tsrc##pf_num=line_tmp->tsrc[y]; \
-	m_tsrc_s##pf_num=line_tmp->tsrc_s[y]; \
-	m_x_count##pf_num=line_tmp->x_count[y]; \
-	m_x_zoom##pf_num=line_tmp->x_zoom[y]; \
-	m_clip_al##pf_num=line_tmp->clip0[y]&0xffff; \
-	m_clip_ar##pf_num=line_tmp->clip0[y]>>16; \
-	m_clip_bl##pf_num=line_tmp->clip1[y]&0xffff; \
-	m_clip_br##pf_num=line_tmp->clip1[y]>>16; \
+	const struct f3_playfield_line_inf *line_tmp=job->line_t[pf_num]; \
+	pf[pf_num].src=line_tmp->src[y]; \
+	pf[pf_num].src_s=line_tmp->src_s[y]; \
+	pf[pf_num].src_e=line_tmp->src_e[y]; \
+	pf[pf_num].tsrc=line_tmp->tsrc[y]; \
+	pf[pf_num].tsrc_s=line_tmp->tsrc_s[y]; \
+	pf[pf_num].x_count=line_tmp->x_count[y]; \
+	pf[pf_num].x_zoom=line_tmp->x_zoom[y]; \
+	pf[pf_num].clip_al=line_tmp->clip0[y]&0xffff; \
+	pf[pf_num].clip_ar=line_tmp->clip0[y]>>16; \
+	pf[pf_num].clip_bl=line_tmp->clip1[y]&0xffff; \
+	pf[pf_num].clip_br=line_tmp->clip1[y]>>16; \
 }
 
 #define CULC_PIXMAP_POINTER(pf_num) \
 { \
-	m_x_count##pf_num += m_x_zoom##pf_num; \
-	if(m_x_count##pf_num>>16) \
+	pf[pf_num].x_count += pf[pf_num].x_zoom; \
+	if(pf[pf_num].x_count>>16) \
 	{ \
-		m_x_count##pf_num &= 0xffff; \
-		m_src##pf_num++; \
-		m_tsrc##pf_num++; \
-		if(m_src##pf_num==m_src_e##pf_num) {m_src##pf_num=m_src_s##pf_num; m_tsrc##pf_num=m_tsrc_s##pf_num;} \
+		pf[pf_num].x_count &= 0xffff; \
+		pf[pf_num].src++; \
+		pf[pf_num].tsrc++; \
+		if(pf[pf_num].src==pf[pf_num].src_e) {pf[pf_num].src=pf[pf_num].src_s; pf[pf_num].tsrc=pf[pf_num].tsrc_s;} \
 	} \
 }
 
 #define UPDATE_PIXMAP_SP(pf_num)	\
 if(cx>=clip_als && cx<clip_ars-1 && !(cx>=clip_bls && cx<clip_brs)) \
 	{ \
-		sprite_pri=sprite[pf_num]&m_pval; \
+		sprite_pri=sprite[pf_num]&px.pval; \
 		if(sprite_pri) \
 		{ \
-			if(sprite[pf_num]&0x100) break; \
-			if(!m_dpix_sp[sprite_pri]) \
+			if(!ALPHA || (sprite[pf_num]&0x100)) break; \
+			if(!job->mode_sp[sprite_pri]) \
 			{ \
-				if(!(m_pval&0xf0)) break; \
-				else {dpix_1_sprite(*dsti);*dsti=m_dval;break;} \
+				if(!(px.pval&0xf0)) break; \
+				else {dpix_1_sprite(a,&px,*dsti);*dsti=px.dval;break;} \
 			} \
-			if((*m_dpix_sp[sprite_pri][m_pval>>4])(*dsti)) {*dsti=m_dval;break;} \
+			if(dpix_n(a,&px,*dsti,job->mode_sp[sprite_pri])) {*dsti=px.dval;break;} \
 		} \
 	}
 
 #define UPDATE_PIXMAP_LP(pf_num) \
-	if (cx>=m_clip_al##pf_num && cx<m_clip_ar##pf_num-1 && !(cx>=m_clip_bl##pf_num && cx<m_clip_br##pf_num)) 	\
+	if (cx>=pf[pf_num].clip_al && cx<pf[pf_num].clip_ar-1 && !(cx>=pf[pf_num].clip_bl && cx<pf[pf_num].clip_br)) 	\
 	{ \
-		m_tval=*m_tsrc##pf_num; \
-		if(m_tval&0xf0) \
-			if((*m_dpix_lp[pf_num][m_pval>>4])(clut[*m_src##pf_num])) {*dsti=m_dval;break;} \
+		px.tval=*pf[pf_num].tsrc; \
+		if(px.tval&0xf0) \
+		{ \
+			if(!ALPHA) {*dsti=clut[*pf[pf_num].src];break;} \
+			if(dpix_n(a,&px,clut[*pf[pf_num].src],job->mode_lp[pf_num])) {*dsti=px.dval;break;} \
+		} \
 	}
 
-
-static void draw_scanlines(INT32 xsize,INT16 *draw_line_num,
-							const struct f3_playfield_line_inf **line_t,
-							const INT32 *sprite,
-							UINT32 orient,
-							INT32 skip_layer_num)
+// Composite one scanline. SKIP is the number of layers left out, ALPHA is 0 when
+// nothing on the line is blended so every layer and sprite is simply opaque.
+template <INT32 SKIP, INT32 ALPHA>
+static void f3_draw_line(const struct f3_line_job *job, INT32 y)
 {
-	UINT32 *clut = TaitoPalette;
-	UINT32 bgcolor=clut[0];
-	INT32 length;
+	const UINT32 *clut = TaitoPalette;
+	const UINT32 bgcolor = clut[0];
+	const struct f3_alpha_blend *a = &job->alpha;
+	const INT32 *sprite = job->sprite;
+	struct f3_pf_cursor pf[5];
+	struct f3_pixel px;
 
 	const INT32 x=46;
 
-	UINT16 clip_als=0, clip_ars=0, clip_bls=0, clip_brs=0;
-
-	UINT8 *dstp0,*dstp;
-
-	INT32 yadv = 512;
-	INT32 yadvp = 1024;
-	INT32 i=0,y=draw_line_num[0];
+	INT32 length=320;
+	INT32 cx=0;
 	INT32 ty = y;
 
-#if 1
-	if (orient & ORIENTATION_FLIP_Y)
-	{
+	if (m_line_orient & ORIENTATION_FLIP_Y)
 		ty = 512 - 1 - ty;
-		yadv = -yadv;
-		yadvp = -yadvp;
-	}
-#endif
-
-	dstp0 = TaitoPriorityMap + (ty * 1024) + x;
 
-	m_pdest_2a = m_f3_alpha_level_2ad ? 0x10 : 0;
-	m_pdest_2b = m_f3_alpha_level_2bd ? 0x20 : 0;
-	m_tr_2a =(m_f3_alpha_level_2as==0 && m_f3_alpha_level_2ad==255) ? -1 : 0;
-	m_tr_2b =(m_f3_alpha_level_2bs==0 && m_f3_alpha_level_2bd==255) ? -1 : 1;
-	m_pdest_3a = m_f3_alpha_level_3ad ? 0x40 : 0;
-	m_pdest_3b = m_f3_alpha_level_3bd ? 0x80 : 0;
-	m_tr_3a =(m_f3_alpha_level_3as==0 && m_f3_alpha_level_3ad==255) ? -1 : 0;
-	m_tr_3b =(m_f3_alpha_level_3bs==0 && m_f3_alpha_level_3bd==255) ? -1 : 1;
+	UINT32 *dsti = output_bitmap + (ty * 512) + x;
+	UINT8 *dstp = TaitoPriorityMap + (ty * 1024) + x;
 
-	{
-		UINT32 *dsti0,*dsti;
-		dsti0 = output_bitmap + (ty * 512) + x;
-		while(1)
-		{
-			INT32 cx=0;
+	UINT16 clip_als=m_sa_line_inf[0].sprite_clip0[y]&0xffff;
+	UINT16 clip_ars=m_sa_line_inf[0].sprite_clip0[y]>>16;
+	UINT16 clip_bls=m_sa_line_inf[0].sprite_clip1[y]&0xffff;
+	UINT16 clip_brs=m_sa_line_inf[0].sprite_clip1[y]>>16;
 
-			clip_als=m_sa_line_inf[0].sprite_clip0[y]&0xffff;
-			clip_ars=m_sa_line_inf[0].sprite_clip0[y]>>16;
-			clip_bls=m_sa_line_inf[0].sprite_clip1[y]&0xffff;
-			clip_brs=m_sa_line_inf[0].sprite_clip1[y]>>16;
+	px.dval = 0;
 
-			length=xsize;
-			dsti = dsti0;
-			dstp = dstp0;
+	switch(SKIP)
+	{
+		case 0: GET_PIXMAP_POINTER(0)
+		case 1: GET_PIXMAP_POINTER(1)
+		case 2: GET_PIXMAP_POINTER(2)
+		case 3: GET_PIXMAP_POINTER(3)
+		case 4: GET_PIXMAP_POINTER(4)
+	}
 
-			switch(skip_layer_num)
+	while (1)
+	{
+		px.pval=*dstp;
+		if (px.pval!=0xff)
+		{
+			UINT8 sprite_pri;
+			switch(SKIP)
 			{
-				case 0: GET_PIXMAP_POINTER(0)
-				case 1: GET_PIXMAP_POINTER(1)
-				case 2: GET_PIXMAP_POINTER(2)
-				case 3: GET_PIXMAP_POINTER(3)
-				case 4: GET_PIXMAP_POINTER(4)
+				case 0: UPDATE_PIXMAP_SP(0) UPDATE_PIXMAP_LP(0)
+				case 1: UPDATE_PIXMAP_SP(1) UPDATE_PIXMAP_LP(1)
+				case 2: UPDATE_PIXMAP_SP(2) UPDATE_PIXMAP_LP(2)
+				case 3: UPDATE_PIXMAP_SP(3) UPDATE_PIXMAP_LP(3)
+				case 4: UPDATE_PIXMAP_SP(4) UPDATE_PIXMAP_LP(4)
+				case 5: UPDATE_PIXMAP_SP(5)
+						if(!bgcolor) {if(!(px.pval&0xf0)) {*dsti=0;break;}}
+						else dpix_bg(a,&px,bgcolor);
+						*dsti=px.dval;
 			}
+		}
 
-			while (1)
-			{
-				m_pval=*dstp;
-				if (m_pval!=0xff)
-				{
-					UINT8 sprite_pri;
-					switch(skip_layer_num)
-					{
-						case 0: UPDATE_PIXMAP_SP(0) UPDATE_PIXMAP_LP(0)
-						case 1: UPDATE_PIXMAP_SP(1) UPDATE_PIXMAP_LP(1)
-						case 2: UPDATE_PIXMAP_SP(2) UPDATE_PIXMAP_LP(2)
-						case 3: UPDATE_PIXMAP_SP(3) UPDATE_PIXMAP_LP(3)
-						case 4: UPDATE_PIXMAP_SP(4) UPDATE_PIXMAP_LP(4)
-						case 5: UPDATE_PIXMAP_SP(5)
-								if(!bgcolor) {if(!(m_pval&0xf0)) {*dsti=0;break;}}
-								else dpix_bg(bgcolor);
-								*dsti=m_dval;
-					}
-				}
-
-				if(!(--length)) break;
-				dsti++;
-				dstp++;
-				cx++;
-
-				switch(skip_layer_num)
-				{
-					case 0: CULC_PIXMAP_POINTER(0)
-					case 1: CULC_PIXMAP_POINTER(1)
-					case 2: CULC_PIXMAP_POINTER(2)
-					case 3: CULC_PIXMAP_POINTER(3)
-					case 4: CULC_PIXMAP_POINTER(4)
-				}
-			}
+		if(!(--length)) break;
+		dsti++;
+		dstp++;
+		cx++;
 
-			i++;
-			if(draw_line_num[i]<0) break;
-			if(draw_line_num[i]==y+1)
-			{
-				dsti0 += yadv;
-				dstp0 += yadvp;
-				y++;
-				continue;
-			}
-			else
-			{
-				dsti0 += (draw_line_num[i]-y)*yadv;
-				dstp0 += (draw_line_num[i]-y)*yadvp;
-				y=draw_line_num[i];
-			}
+		switch(SKIP)
+		{
+			case 0: CULC_PIXMAP_POINTER(0)
+			case 1: CULC_PIXMAP_POINTER(1)
+			case 2: CULC_PIXMAP_POINTER(2)
+			case 3: CULC_PIXMAP_POINTER(3)
+			case 4: CULC_PIXMAP_POINTER(4)
 		}
 	}
 }
 #undef GET_PIXMAP_POINTER
 #undef CULC_PIXMAP_POINTER
+#undef UPDATE_PIXMAP_SP
+#undef UPDATE_PIXMAP_LP
+
+static void (*const f3_draw_line_variant[2][6])(const struct f3_line_job *job, INT32 y) = {
+	{ f3_draw_line<0, 0>, f3_draw_line<1, 0>, f3_draw_line<2, 0>, f3_draw_line<3, 0>, f3_draw_line<4, 0>, f3_draw_line<5, 0> },
+	{ f3_draw_line<0, 1>, f3_draw_line<1, 1>, f3_draw_line<2, 1>, f3_draw_line<3, 1>, f3_draw_line<4, 1>, f3_draw_line<5, 1> }
+};
+
+// Scanlines don't depend on each other once the jobs are set up, the screen is
+// split into bands that BurnParallelFor() may hand to several threads.
+static void draw_line_band(void * /*param*/, INT32 band)
+{
+	INT32 lines = m_line_end - m_line_start;
+	INT32 y_end = m_line_start + (lines * (band + 1)) / F3_LINE_BANDS;
+
+	for (INT32 y = m_line_start + (lines * band) / F3_LINE_BANDS; y < y_end; y++)
+	{
+		if (m_line_job_num[y] == 0xff) continue;
+
+		const struct f3_line_job *job = &m_line_job[m_line_job_num[y]];
+		job->draw(job, y);
+	}
+}
 
 static void visible_tile_check(
 						struct f3_playfield_line_inf *line_t,
@@ -2185,6 +1935,7 @@ static void scanline_draw()
 	INT32 y_start,y_end,y_start_next,y_end_next;
 	UINT8 draw_line[256];
 	INT16 draw_line_num[256];
+	INT32 job_num=0;
 
 	UINT32 rot=0;
 
@@ -2203,6 +1954,10 @@ static void scanline_draw()
 	y_start=ys;
 	y_end=ye;
 	memset(draw_line,0,256);
+	memset(m_line_job_num,0xff,256);
+	m_line_start=ys;
+	m_line_end=ye;
+	m_line_orient=rot;
 
 	while(1)
 	{
@@ -2218,7 +1973,8 @@ static void scanline_draw()
 		struct f3_spritealpha_line_inf *sa_line_inf = m_sa_line_inf;
 		INT32 count_skip_layer=0;
 		INT32 sprite[6]={0,0,0,0,0,0};
-		const struct f3_playfield_line_inf *line_t[5];
+		UINT8 mode_sp[16];
+		struct f3_line_job *job = &m_line_job[job_num];
 
 
 		/* find same status of scanlines */
@@ -2325,10 +2081,7 @@ static void scanline_draw()
 			/* set sprite alpha mode */
 			sprite_alpha_check=0;
 			sprite_alpha_all_2a=1;
-			m_dpix_sp[1]=NULL;
-			m_dpix_sp[2]=NULL;
-			m_dpix_sp[4]=NULL;
-			m_dpix_sp[8]=NULL;
+			memset(mode_sp,0,sizeof(mode_sp));
 			for(i=0;i<4;i++)    /* i = sprite priority offset */
 			{
 				UINT8 sprite_alpha_mode=(sprite_alpha>>(i*2))&3;
@@ -2341,7 +2094,7 @@ static void scanline_draw()
 							sprite_pri_usage&=~sftbit;  // Disable sprite priority block
 						else
 						{
-							m_dpix_sp[sftbit]=m_dpix_n[2];
+							mode_sp[sftbit]=2;
 							sprite_alpha_check|=sftbit;
 						}
 					}
@@ -2352,7 +2105,7 @@ static void scanline_draw()
 							if(m_f3_alpha_level_3as==0 && m_f3_alpha_level_3ad==255) sprite_pri_usage&=~sftbit;
 							else
 							{
-								m_dpix_sp[sftbit]=m_dpix_n[3];
+								mode_sp[sftbit]=3;
 								sprite_alpha_check|=sftbit;
 								sprite_alpha_all_2a=0;
 							}
@@ -2362,7 +2115,7 @@ static void scanline_draw()
 							if(m_f3_alpha_level_3bs==0 && m_f3_alpha_level_3bd==255) sprite_pri_usage&=~sftbit;
 							else
 							{
-								m_dpix_sp[sftbit]=m_dpix_n[5];
+								mode_sp[sftbit]=5;
 								sprite_alpha_check|=sftbit;
 								sprite_alpha_all_2a=0;
 							}
@@ -2442,20 +2195,14 @@ static void scanline_draw()
 					if(alpha_mode[3]>1) alpha_mode[3]=1;
 					if(alpha_mode[4]>1) alpha_mode[4]=1;
 					sprite_alpha_check=0;
-					m_dpix_sp[1]=NULL;
-					m_dpix_sp[2]=NULL;
-					m_dpix_sp[4]=NULL;
-					m_dpix_sp[8]=NULL;
+					memset(mode_sp,0,sizeof(mode_sp));
 				}
 			}
 		}
 		else
 		{
 			sprite_alpha_check=0;
-			m_dpix_sp[1]=NULL;
-			m_dpix_sp[2]=NULL;
-			m_dpix_sp[4]=NULL;
-			m_dpix_sp[8]=NULL;
+			memset(mode_sp,0,sizeof(mode_sp));
 		}
 
 
@@ -2549,12 +2296,12 @@ static void scanline_draw()
 		}
 
 
-		/* draw scanlines */
+		/* set up the line job */
 		alpha=0;
 		for(i=count_skip_layer;i<5;i++)
 		{
 			pos=layer_tmp[i]&7;
-			line_t[i]=&pf_line_inf[pos];
+			job->line_t[i]=&pf_line_inf[pos];
 
 			if(sprite[i]&sprite_alpha_check) alpha=1;
 			else if(!alpha) sprite[i]|=0x100;
@@ -2562,21 +2309,39 @@ static void scanline_draw()
 			if(alpha_mode[pos]>1)
 			{
 				INT32 alpha_type=(((alpha_mode_flag[pos]>>4)&3)-1)*2;
-				m_dpix_lp[i]=m_dpix_n[alpha_mode[pos]+alpha_type];
+				job->mode_lp[i]=alpha_mode[pos]+alpha_type;
 				alpha=1;
 			}
 			else
 			{
-				if(alpha) m_dpix_lp[i]=m_dpix_n[1];
-				else      m_dpix_lp[i]=m_dpix_n[0];
+				job->mode_lp[i]=alpha ? 1 : 0;
 			}
 		}
 		if(sprite[5]&sprite_alpha_check) alpha=1;
 		else if(!alpha) sprite[5]|=0x100;
 
-		draw_scanlines(320,draw_line_num,line_t,sprite,rot,count_skip_layer);
+		memcpy(job->sprite,sprite,sizeof(job->sprite));
+		memcpy(job->mode_sp,mode_sp,sizeof(job->mode_sp));
+		job->alpha=m_alpha;
+		job->alpha.pdest_2a = m_f3_alpha_level_2ad ? 0x10 : 0;
+		job->alpha.pdest_2b = m_f3_alpha_level_2bd ? 0x20 : 0;
+		job->alpha.tr_2a =(m_f3_alpha_level_2as==0 && m_f3_alpha_level_2ad==255) ? -1 : 0;
+		job->alpha.tr_2b =(m_f3_alpha_level_2bs==0 && m_f3_alpha_level_2bd==255) ? -1 : 1;
+		job->alpha.pdest_3a = m_f3_alpha_level_3ad ? 0x40 : 0;
+		job->alpha.pdest_3b = m_f3_alpha_level_3bd ? 0x80 : 0;
+		job->alpha.tr_3a =(m_f3_alpha_level_3as==0 && m_f3_alpha_level_3ad==255) ? -1 : 0;
+		job->alpha.tr_3b =(m_f3_alpha_level_3bs==0 && m_f3_alpha_level_3bd==255) ? -1 : 1;
+		job->draw=f3_draw_line_variant[alpha][count_skip_layer];
+
+		for(i=0;draw_line_num[i]>=0;i++)
+			m_line_job_num[draw_line_num[i]]=job_num;
+		job_num++;
+
 		if(y_start<0) break;
 	}
+
+	/* draw scanlines */
+	BurnParallelFor(draw_line_band, NULL, F3_LINE_BANDS);
 }
 
 
@@ -2690,15 +2455,6 @@ void TaitoF3VideoInit()
 	m_f3_alpha_level_3bd=127;
 	m_alpha_level_last = -1;
 
-	m_pdest_2a = 0x10;
-	m_pdest_2b = 0x20;
-	m_tr_2a = 0;
-	m_tr_2b = 1;
-	m_pdest_3a = 0x40;
-	m_pdest_3b = 0x80;
-	m_tr_3a = 0;
-	m_tr_3b = 1;
-
 	m_width_mask=(extended_layers) ? 0x3ff : 0x1ff;
 	m_twidth_mask=(extended_layers) ? 0x7f : 0x3f;
 	m_twidth_mask_bit=(extended_layers) ? 7 : 6;
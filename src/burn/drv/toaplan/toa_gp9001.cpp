@@ -37,12 +37,27 @@ INT32 GP9001Regnum[2];
 static UINT32* pTileQueue[32];
 static UINT32* pTileQueueData[2] = {NULL, };
 
-static UINT8** pSpriteQueue[32];
-static UINT8** pSpriteQueueData[2] = {NULL, };
+// A sprite as it is drawn this frame, clipped to the tiles that are on the screen
+struct GP9001Sprite {
+	UINT32* pPalette;
+	UINT32 nNumber;						// first tile
+	INT32 nXPos, nYPos;
+	INT32 nFlip;
+	INT32 nWidth;						// tiles per row
+	INT32 nFirstX, nLastX;				// visible tile columns
+	INT32 nFirstY, nLastY;				// visible tile rows
+};
+
+static INT32 nSpriteQueueCount[32];
+static GP9001Sprite* pSpriteQueueData[2] = {NULL, };
 
 static UINT8* pSpriteBuffer[2];
 static UINT8* pSpriteBufferData[2] = {NULL, };
 
+// The enabled sprites in each half of pSpriteBufferData, element 0 is the count
+static UINT16* pSpriteList[2];
+static UINT16 SpriteListData[2][2][0x0101];
+
 static INT32 nSpriteBuffer = 0;
 
 INT32 nSpriteXOffset = 0, nSpriteYOffset = 0, nSpritePriority = 0;
@@ -66,106 +81,152 @@ static INT32 nLastBPP = 0;
 // Include the tile rendering functions
 #include "toa_gp9001_func.h"
 
-static void PrepareSprites()
+// Tiles n = 0 - nSize at nPos + n * nStep that are (partly) inside 0 - nLimit
+static inline INT32 SpriteSpan(INT32 nPos, INT32 nStep, INT32 nSize, INT32 nLimit, INT32* pnFirst, INT32* pnLast)
 {
-	UINT8* pSpriteInfo;
-	INT32 nSprite, nAttrib;
+	INT32 nFirst, nLast;
 
-	for (INT32 i = 0; i < nControllers; i++) {
-		UINT8*** pMySpriteQueue = &pSpriteQueue[i << 4];
+	if (nStep > 0) {
+		nFirst = (-nPos) >> 3;
+		nLast = (nLimit - 1 - nPos) >> 3;
+	} else {
+		nFirst = (nPos - nLimit + 8) >> 3;
+		nLast = (nPos + 7) >> 3;
+	}
 
-		for (INT32 nPriority = 0; nPriority < 16; nPriority++) {
-			pMySpriteQueue[nPriority] = &pSpriteQueueData[i][(nPriority << 8) + nPriority];
-		}
+	*pnFirst = (nFirst < 0) ? 0 : nFirst;
+	*pnLast = (nLast > nSize) ? nSize : nLast;
 
-		for (nSprite = 0, pSpriteInfo = pSpriteBuffer[i]; nSprite < 0x0100; nSprite++, pSpriteInfo += 8) {
-			nAttrib = pSpriteInfo[1];
-			if (nAttrib & 0x80) {				// Sprite is enabled
-				*pMySpriteQueue[nAttrib & 0x0F]++ = pSpriteInfo;
-			}
-		}
-	}
+	return *pnFirst <= *pnLast;
 }
 
-static void RenderSpriteQueue(INT32 i, INT32 nPriority)
+static void PrepareSprites()
 {
 	UINT8* pSpriteInfo;
-	UINT8* pSpriteData;
+	GP9001Sprite* pSprite;
 	INT32 nSpriteXPos, nSpriteYPos;
 	INT32 nSpriteXSize, nSpriteYSize;
 	UINT32 nSpriteNumber;
-	INT32 x, y, xoff, yoff;
-	INT32 nFlip;
-	INT32 nMultiConnectorX = GP9001Reg[i][6] & 0x1ff;
-	INT32 nMultiConnectorY = GP9001Reg[i][7] & 0x1ff;
+	INT32 nPriority, nFlip;
+	INT32 nMultiConnectorX[16], nMultiConnectorY[16];
 
-	UINT8*** pMySpriteQueue = &pSpriteQueue[i << 4];
+	for (INT32 i = 0; i < nControllers; i++) {
+		INT32* pMyQueueCount = &nSpriteQueueCount[i << 4];
 
-	*pMySpriteQueue[nPriority] = NULL;
-	pMySpriteQueue[nPriority] = &pSpriteQueueData[i][(nPriority << 8) + nPriority];
+		// Multi-connected sprites follow the previous sprite in the same queue
+		for (nPriority = 0; nPriority < 16; nPriority++) {
+			pMyQueueCount[nPriority] = 0;
+			nMultiConnectorX[nPriority] = GP9001Reg[i][6] & 0x1ff;
+			nMultiConnectorY[nPriority] = GP9001Reg[i][7] & 0x1ff;
+		}
 
-	while ((pSpriteInfo = *pMySpriteQueue[nPriority]++) != NULL) {
-		nFlip = ((pSpriteInfo[1] & 0x30) >> 3);
+		for (INT32 n = 1; n <= pSpriteList[i][0]; n++) {
+			pSpriteInfo = pSpriteBuffer[i] + (pSpriteList[i][n] << 3);
+			nPriority = pSpriteInfo[1] & 0x0F;
+			nFlip = ((pSpriteInfo[1] & 0x30) >> 3);
+
+			nSpriteXSize = pSpriteInfo[4] & 0x0F;
+			nSpriteXPos = ((pSpriteInfo[5] << 1) | (pSpriteInfo[4] >> 7)) + GP9001Reg[i][6] + nSpriteXOffset;
+			nSpriteXPos &= 0x01FF;
+			nSpriteYSize = pSpriteInfo[6] & 0x0F;
+			nSpriteYPos = ((pSpriteInfo[7] << 1) | (pSpriteInfo[6] >> 7)) + GP9001Reg[i][7] + nSpriteYOffset;
+			nSpriteYPos &= 0x01FF;
+
+			if (pSpriteInfo[1] & 0x40) { // Multi-Connected sprite mode.
+				nSpriteXPos = (nMultiConnectorX[nPriority] + (((pSpriteInfo[5] << 1) | (pSpriteInfo[4] >> 7)))) & 0x1ff;
+				nSpriteYPos = (nMultiConnectorY[nPriority] + (((pSpriteInfo[7] << 1) | (pSpriteInfo[6] >> 7)))) & 0x1ff;
+			}
 
-		pTilePalette = &ToaPalette[((pSpriteInfo[0] & 0xFC) << 2)];
-		nSpriteNumber = (((pSpriteInfo[3] << 8) | pSpriteInfo[2]) & 0x7FFF);
-		nSpriteNumber += GP9001TileBank[(((pSpriteInfo[0] & 3) << 1) | (pSpriteInfo[3] >> 7))];
+			nMultiConnectorX[nPriority] = nSpriteXPos;
+			nMultiConnectorY[nPriority] = nSpriteYPos;
 
-		pSpriteData = GP9001ROM[i] + (nSpriteNumber << 5);
+			if (nFlip & 2) {
+				nSpriteXPos -= 7;
+				if (nSpriteXPos > (320 + 128)) {
+					nSpriteXPos -= 0x0200;
+				}
+			} else {
+				if (nSpriteXPos > (512 - 128)) {
+					nSpriteXPos -= 0x0200;
+				}
+			}
+			if (nFlip & 4) {
+				nSpriteYPos -= 7;
+			}
 
-		nSpriteXSize = pSpriteInfo[4] & 0x0F;
-		nSpriteXPos = ((pSpriteInfo[5] << 1) | (pSpriteInfo[4] >> 7)) + GP9001Reg[i][6] + nSpriteXOffset;
-		nSpriteXPos &= 0x01FF;
-		nSpriteYSize = pSpriteInfo[6] & 0x0F;
-		nSpriteYPos = ((pSpriteInfo[7] << 1) | (pSpriteInfo[6] >> 7)) + GP9001Reg[i][7] + nSpriteYOffset;
-		nSpriteYPos &= 0x01FF;
+			if (nSpriteYPos > 384) {
+				nSpriteYPos -= 0x0200;
+			}
 
-		if (pSpriteInfo[1] & 0x40) { // Multi-Connected sprite mode.
-			nSpriteXPos = (nMultiConnectorX + (((pSpriteInfo[5] << 1) | (pSpriteInfo[4] >> 7)))) & 0x1ff;
-			nSpriteYPos = (nMultiConnectorY + (((pSpriteInfo[7] << 1) | (pSpriteInfo[6] >> 7)))) & 0x1ff;
-		}
+			nSpriteNumber = (((pSpriteInfo[3] << 8) | pSpriteInfo[2]) & 0x7FFF);
+			nSpriteNumber += GP9001TileBank[(((pSpriteInfo[0] & 3) << 1) | (pSpriteInfo[3] >> 7))];
+			if (nSpriteNumber > nMaxSprite[i]) {
+				continue;
+			}
 
-		nMultiConnectorX = nSpriteXPos;
-		nMultiConnectorY = nSpriteYPos;
+			pSprite = &pSpriteQueueData[i][(nPriority << 8) + pMyQueueCount[nPriority]];
 
-		if (nFlip & 2) {
-			xoff = -8;
-			nSpriteXPos -= 7;
-			if (nSpriteXPos > (320 + 128)) {
-				nSpriteXPos -= 0x0200;
+			// Skip sprites that are completely off the screen
+			if (!SpriteSpan(nSpriteXPos, (nFlip & 2) ? -8 : 8, nSpriteXSize, 320, &pSprite->nFirstX, &pSprite->nLastX)) {
+				continue;
 			}
-		} else {
-			xoff = 8;
-			if (nSpriteXPos > (512 - 128)) {
-				nSpriteXPos -= 0x0200;
+			if (!SpriteSpan(nSpriteYPos, (nFlip & 4) ? -8 : 8, nSpriteYSize, 240, &pSprite->nFirstY, &pSprite->nLastY)) {
+				continue;
 			}
-		}
-		if (nFlip & 4) {
-			yoff = -8;
-			nSpriteYPos -= 7;
-		} else {
-			yoff = 8;
-		}
 
-		if (nSpriteYPos > 384) {
-			nSpriteYPos -= 0x0200;
+			pSprite->pPalette = &ToaPalette[((pSpriteInfo[0] & 0xFC) << 2)];
+			pSprite->nNumber = nSpriteNumber;
+			pSprite->nXPos = nSpriteXPos;
+			pSprite->nYPos = nSpriteYPos;
+			pSprite->nFlip = nFlip;
+			pSprite->nWidth = nSpriteXSize + 1;
+
+			pMyQueueCount[nPriority]++;
 		}
+	}
+}
 
-		for (y = 0, nTileYPos = nSpriteYPos; y <= nSpriteYSize; y++, nTileYPos += yoff) {
-			for (x = 0, nTileXPos = nSpriteXPos; x <= nSpriteXSize; x++, nTileXPos += xoff, nSpriteNumber++, pSpriteData += 32) {
-				if (nSpriteNumber > nMaxSprite[i]) {
-					break;
-				}
-				if (GP9001TileAttrib[i][nSpriteNumber]) {
-					// Skip tile if it's completely off the screen
-					if (!(nTileXPos <= -8 || nTileXPos >= 320 || nTileYPos <= -8 || nTileYPos >= 240)) {
-						pTileData = (UINT32*)pSpriteData;
-						pTile = pBurnBitmap + (nTileXPos * nBurnColumn) + (nTileYPos * nBurnRow);
-						if (nTileXPos < 0 || nTileXPos > 312 || nTileYPos < 0 || nTileYPos > 232) {
-							RenderTile[nFlip + 1]();
-						} else {
-							RenderTile[nFlip]();
-						}
+static void RenderSpriteQueue(INT32 i, INT32 nPriority)
+{
+	GP9001Sprite* pSprite = &pSpriteQueueData[i][nPriority << 8];
+	GP9001Sprite* pSpriteEnd = pSprite + nSpriteQueueCount[(i << 4) + nPriority];
+	UINT8* pTileAttrib = GP9001TileAttrib[i];
+	UINT8* pSpriteROM = GP9001ROM[i];
+	UINT32 nSpriteNumber, nLastNumber;
+	INT32 nXPos, nYPos;
+	INT32 x, y, xoff, yoff;
+	INT32 nFirstX, nLastX, nLastY;
+	INT32 nFlip;
+
+	for ( ; pSprite < pSpriteEnd; pSprite++) {
+		nFlip = pSprite->nFlip;
+		xoff = (nFlip & 2) ? -8 : 8;
+		yoff = (nFlip & 4) ? -8 : 8;
+		nFirstX = pSprite->nFirstX;
+		nLastX = pSprite->nLastX;
+		nLastY = pSprite->nLastY;
+		nXPos = pSprite->nXPos + nFirstX * xoff;
+		nYPos = pSprite->nYPos + pSprite->nFirstY * yoff;
+
+		pTilePalette = pSprite->pPalette;
+
+		for (y = pSprite->nFirstY; y <= nLastY; y++, nYPos += yoff) {
+			nSpriteNumber = pSprite->nNumber + y * pSprite->nWidth + nFirstX;
+			nLastNumber = nSpriteNumber + nLastX - nFirstX;
+			if (nLastNumber > nMaxSprite[i]) {
+				nLastNumber = nMaxSprite[i];
+			}
+
+			for (x = nXPos; nSpriteNumber <= nLastNumber; x += xoff, nSpriteNumber++) {
+				if (pTileAttrib[nSpriteNumber]) {
+					nTileXPos = x;
+					nTileYPos = nYPos;
+					pTileData = (UINT32*)(pSpriteROM + (nSpriteNumber << 5));
+					pTile = pBurnBitmap + (x * nBurnColumn) + (nYPos * nBurnRow);
+					if (x < 0 || x > 312 || nYPos < 0 || nYPos > 232) {
+						RenderTile[nFlip + 1]();
+					} else {
+						RenderTile[nFlip]();
 					}
 				}
 			}
@@ -370,28 +431,34 @@ static void RenderTileQueue(INT32 i, INT32 nPriority)
 	}
 }
 
-INT32 ToaBufferGP9001Sprites()
+static void ListGP9001Sprites(INT32 i)
 {
+	UINT8* pSpriteInfo = pSpriteBufferData[i] + 0x0800 * nSpriteBuffer;
+	UINT16* pList = SpriteListData[i][nSpriteBuffer];
+	INT32 nCount = 0;
 
-#if 0
-	pSpriteBuffer[0] = GP9001RAM[0] + 0x3000;
-	if (nControllers > 1) {
-		pSpriteBuffer[1] = GP9001RAM[1] + 0x3000;
+	for (INT32 nSprite = 0; nSprite < 0x0100; nSprite++, pSpriteInfo += 8) {
+		if (pSpriteInfo[1] & 0x80) {			// Sprite is enabled
+			pList[++nCount] = nSprite;
+		}
 	}
-#else
 
-	pSpriteBuffer[0] = pSpriteBufferData[0] + 0x0800 * nSpriteBuffer;
-	if (nControllers > 1) {
-		pSpriteBuffer[1] = pSpriteBufferData[1] + 0x0800 * nSpriteBuffer;
+	pList[0] = nCount;
+}
+
+INT32 ToaBufferGP9001Sprites()
+{
+	for (INT32 i = 0; i < nControllers; i++) {
+		pSpriteBuffer[i] = pSpriteBufferData[i] + 0x0800 * nSpriteBuffer;
+		pSpriteList[i] = SpriteListData[i][nSpriteBuffer];
 	}
 
 	nSpriteBuffer ^= 1;
 
-	memcpy(pSpriteBufferData[0] + 0x0800 * nSpriteBuffer, GP9001RAM[0] + 0x3000, 0x0800);
-	if (nControllers > 1) {
-		memcpy(pSpriteBufferData[1] + 0x0800 * nSpriteBuffer, GP9001RAM[1] + 0x3000, 0x0800);
+	for (INT32 i = 0; i < nControllers; i++) {
+		memcpy(pSpriteBufferData[i] + 0x0800 * nSpriteBuffer, GP9001RAM[i] + 0x3000, 0x0800);
+		ListGP9001Sprites(i);
 	}
-#endif
 
 	return 0;
 }
@@ -502,8 +569,8 @@ INT32 ToaInitGP9001(INT32 n)
 		pTileQueueData[i] = (UINT32*)BurnMalloc(nSize);
 		memset(pTileQueueData[i], 0, nSize);
 
-		nSize = 0x10 * 0x101 * sizeof(UINT8*);
-		pSpriteQueueData[i] = (UINT8**)BurnMalloc(nSize);
+		nSize = 0x10 * 0x100 * sizeof(GP9001Sprite);
+		pSpriteQueueData[i] = (GP9001Sprite*)BurnMalloc(nSize);
 		memset(pSpriteQueueData[i], 0, nSize);
 
 		nSize = 0x0800 * 2;
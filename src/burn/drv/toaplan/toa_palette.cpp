@@ -1,4 +1,5 @@
 #include "toaplan.h"
+#include "burn_prof.h"
 // Toaplan -- palette functions
 
 UINT8* ToaPalSrc;			// Pointer to input palette
@@ -35,6 +36,8 @@ inline static UINT32 CalcCol(UINT16 nColour)
 
 INT32 ToaPalUpdate()
 {
+	BURN_PROF_SCOPE(BURN_PROF_PALETTE);
+
 	UINT16* ps = (UINT16*)ToaPalSrc;
 	UINT32* pd = ToaPalette;
 	
@@ -1,6 +1,19 @@
 // Burn - Rom Loading module
 #include "burnint.h"
 
+// Ask the application for a read-only view of rom i (e.g. a stored file in a mapped zip)
+static INT32 BurnLoadRomMapped(UINT8 **ppData, INT32 *pnLen, INT32 i)
+{
+	if (BurnExtMapRom == NULL || bDoIpsPatch) return 1;
+
+	*ppData = NULL;
+	*pnLen = 0;
+
+	if (BurnExtMapRom(ppData, pnLen, i) != 0 || *ppData == NULL) return 1;
+
+	return 0;
+}
+
 // Load a rom and separate out the bytes by nGap
 // Dest is the memory block to insert the rom into
 INT32 BurnLoadRomExt(UINT8 *Dest, INT32 i, INT32 nGap, INT32 nFlags)
@@ -26,14 +39,22 @@ INT32 BurnLoadRomExt(UINT8 *Dest, INT32 i, INT32 nGap, INT32 nFlags)
 	if ((nGap>1) || (nFlags & LD_NIBBLES) || (nFlags & LD_XOR))
 	{
 		INT32 nLoadLen=0;
-		UINT8 *Load=(UINT8 *)BurnMalloc(nLen);
-		if (Load==NULL) return 1;
-		memset(Load,0,nLen);
-
-		// Load in the file
-		nRet=BurnExtLoadRom(Load,&nLoadLen,i);
-		if (bDoIpsPatch) IpsApplyPatches(Load, RomName);
-		if (nRet!=0) { if (Load) { BurnFree(Load); Load = NULL; } return 1; }
+		UINT8 *Load=NULL;
+		bool bMapped = false;
+
+		// Read straight from the mapped file if we can, saves loading the rom twice
+		if (BurnLoadRomMapped(&Load, &nLoadLen, i) == 0) {
+			bMapped = true;
+		} else {
+			Load=(UINT8 *)BurnMalloc(nLen);
+			if (Load==NULL) return 1;
+			memset(Load,0,nLen);
+
+			// Load in the file
+			nRet=BurnExtLoadRom(Load,&nLoadLen,i);
+			if (bDoIpsPatch) IpsApplyPatches(Load, RomName);
+			if (nRet!=0) { if (Load) { BurnFree(Load); Load = NULL; } return 1; }
+		}
 
 		if (nLoadLen<0) nLoadLen=0;
 		if (nLoadLen>nLen) nLoadLen=nLen;
@@ -69,16 +90,24 @@ INT32 BurnLoadRomExt(UINT8 *Dest, INT32 i, INT32 nGap, INT32 nFlags)
 			}
 		}
 
-		if (Load) {
+		if (Load && !bMapped) {
 			BurnFree(Load);
 			Load = NULL;
 		}
 	}
 	else
 	{
+		UINT8 *Map = NULL;
+		INT32 nMapLen = 0;
+
  		// If no XOR, and gap of 1, just copy straight in
-		nRet=BurnExtLoadRom(Dest,NULL,i);
-		if (bDoIpsPatch) IpsApplyPatches(Dest, RomName);
+		if (BurnLoadRomMapped(&Map, &nMapLen, i) == 0) {
+			memcpy(Dest, Map, (nMapLen < nLen) ? nMapLen : nLen);
+			nRet = 0;
+		} else {
+			nRet=BurnExtLoadRom(Dest,NULL,i);
+			if (bDoIpsPatch) IpsApplyPatches(Dest, RomName);
+		}
 		if (nRet!=0) return 1;
 
 		if (nFlags & LD_INVERT) {
@@ -105,6 +134,30 @@ INT32 BurnXorRom(UINT8 *Dest, INT32 i, INT32 nGap)
 	return BurnLoadRomExt(Dest,i,nGap,LD_XOR);
 }
 
+// Get a read-only pointer to rom i without loading it anywhere, for roms the driver
+// only ever reads. Only works when the application can map the file (e.g. a rom stored
+// uncompressed in a zip), where the pages are shared with any other process using the
+// same file. The data stays valid until the driver exits and must never be written to.
+// Returns 1 if the rom has to be loaded with BurnLoadRom instead.
+INT32 BurnMapRom(UINT8 **ppData, INT32 i)
+{
+	struct BurnRomInfo ri;
+	ri.nType=0;
+	ri.nLen=0;
+	BurnDrvGetRomInfo(&ri,i);
+	if (ri.nType==0 || ri.nLen<=0) return 1;
+
+	UINT8 *Map = NULL;
+	INT32 nMapLen = 0;
+
+	if (BurnLoadRomMapped(&Map, &nMapLen, i)) return 1;
+	if (nMapLen < (INT32)ri.nLen) return 1;
+
+	*ppData = Map;
+
+	return 0;
+}
+
 // Separate out a bitfield into Bit number 'nField' of each nibble in pDest
 // (end result: each dword in memory carries the 8 pixels of a tile line).
 INT32 BurnLoadBitField(UINT8 *pDest, UINT8 *pSrc, INT32 nField, INT32 nSrcLen)
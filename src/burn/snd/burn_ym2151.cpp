@@ -1,6 +1,7 @@
 // FBAlpha YM-2151 sound core interface
 #include "burnint.h"
 #include "burn_ym2151.h"
+#include "burn_prof.h"
 
 // Irq Callback timing notes..
 // Due to the way the internal timing of the ym2151 works, BurnYM2151Render()
@@ -31,6 +32,8 @@ static void YM2151RenderResample(INT16* pSoundBuf, INT32 nSegmentLength)
 #if defined FBA_DEBUG
 	if (!DebugSnd_YM2151Initted) bprintf(PRINT_ERROR, _T("YM2151RenderResample called without init\n"));
 #endif
+	BURN_PROF_SCOPE(BURN_PROF_SOUND);
+
 	
 	nBurnPosition += nSegmentLength;
 
@@ -115,6 +118,8 @@ static void YM2151RenderNormal(INT16* pSoundBuf, INT32 nSegmentLength)
 	if (!DebugSnd_YM2151Initted) bprintf(PRINT_ERROR, _T("YM2151RenderNormal called without init\n"));
 #endif
 
+	BURN_PROF_SCOPE(BURN_PROF_SOUND);
+
 	nBurnPosition += nSegmentLength;
 
 	pYM2151Buffer[0] = pBuffer;
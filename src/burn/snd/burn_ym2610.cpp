@@ -1,5 +1,6 @@
 #include "burnint.h"
 #include "burn_ym2610.h"
+#include "burn_prof.h"
 
 void (*BurnYM2610Update)(INT16* pSoundBuf, INT32 nSegmentEnd);
 
@@ -94,6 +95,8 @@ static void YM2610UpdateResample(INT16* pSoundBuf, INT32 nSegmentEnd)
 	if (!DebugSnd_YM2610Initted) bprintf(PRINT_ERROR, _T("YM2610UpdateResample called without init\n"));
 #endif
 
+	BURN_PROF_SCOPE(BURN_PROF_SOUND);
+
 	INT32 nSegmentLength = nSegmentEnd;
 	INT32 nSamplesNeeded = nSegmentEnd * nBurnYM2610SoundRate / nBurnSoundRate + 1;
 
@@ -242,6 +245,8 @@ static void YM2610UpdateNormal(INT16* pSoundBuf, INT32 nSegmentEnd)
 	if (!DebugSnd_YM2610Initted) bprintf(PRINT_ERROR, _T("YM2610UpdateNormal called without init\n"));
 #endif
 
+	BURN_PROF_SCOPE(BURN_PROF_SOUND);
+
 	INT32 nSegmentLength = nSegmentEnd;
 
 	if (nSegmentEnd < nAY8910Position) {
@@ -1,5 +1,6 @@
 #include "burnint.h"
 #include "dac.h"
+#include "burn_prof.h"
 
 #define DAC_NUM		(8)	// Maximum DAC chips
 
@@ -88,6 +89,8 @@ void DACUpdate(INT16* Buffer, INT32 Length)
 	if (!DebugSnd_DACInitted) bprintf(PRINT_ERROR, _T("DACUpdate called without init\n"));
 #endif
 
+	BURN_PROF_SCOPE(BURN_PROF_SOUND);
+
 	struct dac_info *ptr;
 
 	for (INT32 i = 0; i < NumChips; i++) {
@@ -4,6 +4,7 @@
 #include <math.h>
 #include "burnint.h"
 #include "msm6295.h"
+#include "burn_prof.h"
 #include <stddef.h>
 
 UINT8* MSM6295ROM;
@@ -360,6 +361,8 @@ INT32 MSM6295Render(INT32 nChip, INT16* pSoundBuf, INT32 nSegmentLength) // rend
 	if (nChip > nLastMSM6295Chip) bprintf(PRINT_ERROR, _T("MSM6295Render called with invalid chip number %x\n"), nChip);
 #endif
 
+	BURN_PROF_SCOPE(BURN_PROF_SOUND);
+
 	if (nChip == 0) {
 		memset(pLeftBuffer, 0, nSegmentLength * sizeof(INT32));
 		memset(pRightBuffer, 0, nSegmentLength * sizeof(INT32));
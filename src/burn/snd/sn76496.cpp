@@ -2,6 +2,7 @@
 
 #include "burnint.h"
 #include "sn76496.h"
+#include "burn_prof.h"
 #include <stddef.h>
 
 #define MAX_SN76496_CHIPS 8
@@ -43,6 +44,8 @@ void SN76496Update(INT32 Num, INT16* pSoundBuf, INT32 Length)
 	if (Num > NumChips) bprintf(PRINT_ERROR, _T("SN76496Update called with invalid chip %x\n"), Num);
 #endif
 
+	BURN_PROF_SCOPE(BURN_PROF_SOUND);
+
 	if (Num >= MAX_SN76496_CHIPS) return;
 
 	INT32 i;
@@ -2,6 +2,20 @@
 
 #define MAX_TILEMAPS	32	// number of tile maps allowed
 
+#define TMAP_CACHE_MAX_PIXELS	0x200000	// don't cache maps with more pixels than this (2048x1024)
+#define TMAP_CACHE_MAX_MISSES	8		// stop caching a map that keeps being drawn with different settings
+
+// what a cached tile was rendered from
+struct GenericTilemapCacheTile {
+	INT32 gfxnum;
+	INT32 code;
+	INT32 color;
+	UINT32 flags;
+	INT32 category;
+	UINT32 gfxsum;				// checksum of the tile graphics, catches tiles in ram
+	UINT32 stamp;				// last draw this tile was checked in
+};
+
 struct GenericTilemap {
 	UINT8 initialized;
 	INT32 (*pScan)(INT32 col, INT32 row);
@@ -25,12 +39,36 @@ struct GenericTilemap {
 	INT32 transcolor;
 	UINT8 *dirty_tiles;			// 1 skip, 0 draw
 	INT32 dirty_tiles_enable;
+	UINT16 *cache_pixmap;			// whole map pre-rendered
+	UINT8 *cache_transmap;			// 1 skip, 0 draw
+	GenericTilemapCacheTile *cache_tiles;
+	UINT32 cache_params;			// draw settings the cache was rendered with
+	INT32 cache_valid;
+	INT32 cache_disable;
+	INT32 cache_misses;
+	INT32 cache_hits;
 };
 
 static GenericTilemap maps[MAX_TILEMAPS];
 static GenericTilemap *cur_map;
 GenericTilesGfx GenericGfxData[MAX_TILEMAPS];
 
+static UINT32 cache_stamp = 0;
+
+static inline void TilemapCacheInvalidate(GenericTilemap *map)
+{
+	map->cache_valid = 0;
+}
+
+static void TilemapCacheExit(GenericTilemap *map)
+{
+	if (map->cache_pixmap) BurnFree(map->cache_pixmap);
+	if (map->cache_transmap) BurnFree(map->cache_transmap);
+	if (map->cache_tiles) BurnFree(map->cache_tiles);
+
+	map->cache_valid = 0;
+}
+
 void GenericTilemapInit(INT32 which, INT32 (*pScan)(INT32 col, INT32 row), void (*pTile)(INT32 offs, INT32 *tile_gfx, INT32 *tile_code, INT32 *tile_color, UINT32 *tile_flags, INT32 *category), UINT32 tile_width, UINT32 tile_height, UINT32 map_width, UINT32 map_height)
 {
 #if defined FBA_DEBUG
@@ -118,6 +156,12 @@ void GenericTilemapSetGfx(INT32 num, UINT8 *gfxbase, INT32 depth, INT32 tile_wid
 
 	GenericTilesGfx *ptr = &GenericGfxData[num];
 
+	if (ptr->gfxbase != gfxbase || ptr->depth != depth || ptr->width != tile_width || ptr->height != tile_height || ptr->gfx_len != (UINT32)gfxlen || ptr->color_offset != color_offset || ptr->color_mask != color_mask) {
+		for (INT32 i = 0; i < MAX_TILEMAPS; i++) {
+			TilemapCacheInvalidate(&maps[i]);
+		}
+	}
+
 	ptr->gfxbase = gfxbase;
 	ptr->depth = depth;
 	ptr->width = tile_width;
@@ -152,6 +196,7 @@ void GenericTilemapExit()
 		if (cur_map->scrollx_table) BurnFree(cur_map->scrollx_table);
 		if (cur_map->transparent[0]) BurnFree(cur_map->transparent[0]);
 		if (cur_map->dirty_tiles) BurnFree(cur_map->dirty_tiles);
+		TilemapCacheExit(cur_map);
 	}
 
 	// wipe everything else out
@@ -224,6 +269,10 @@ void GenericTilemapSetTransparent(INT32 which, UINT32 transparent)
 	}
 #endif
 
+	if ((cur_map->flags & TMAP_TRANSPARENT) == 0 || cur_map->transcolor != (INT32)transparent) {
+		TilemapCacheInvalidate(cur_map);
+	}
+
 	memset (cur_map->transparent[0], 0, 256);	// set all to opaque
 
 	cur_map->transparent[0][transparent] = 1;	// one color opaque
@@ -255,14 +304,22 @@ void GenericTilemapSetTransMask(INT32 which, INT32 category, UINT16 transmask)
 	}
 #endif
 
-	memset (cur_map->transparent[category], 1, 256);
+	UINT8 trans[256];
+
+	memset (trans, 1, 256);
 
 	for (INT32 i = 0; i < 16; i++) {
 		if ((transmask & (1 << i)) == 0) {
-			cur_map->transparent[category][i] = 0;
+			trans[i] = 0;
 		}
 	}
 
+	if ((cur_map->flags & TMAP_TRANSMASK) == 0 || memcmp(cur_map->transparent[category], trans, 256)) {
+		TilemapCacheInvalidate(cur_map);
+	}
+
+	memcpy (cur_map->transparent[category], trans, 256);
+
 	cur_map->flags |= TMAP_TRANSMASK;
 }
 
@@ -288,6 +345,8 @@ void GenericTilemapCategoryConfig(INT32 which, INT32 categories)
 
 	cur_map->transparent[0] = BurnMalloc(256 * (categories + 1));
 
+	TilemapCacheInvalidate(cur_map);
+
 	for (INT32 i = 1; i < categories; i++)
 	{
 		cur_map->transparent[(i % categories)] = &cur_map->transparent[0][(i % categories) * 256];	
@@ -326,6 +385,10 @@ void GenericTilemapSetCategoryEntry(INT32 which, INT32 category, INT32 entry, IN
 	}
 #endif
 
+	if (cur_map->transparent[category][entry] != trans) {
+		TilemapCacheInvalidate(cur_map);
+	}
+
 	cur_map->transparent[category][entry] = trans;
 }
 
@@ -704,6 +767,350 @@ INT32 GenericTilemapGetTileDirty(INT32 which, UINT32 offset)
 	return cur_map->dirty_tiles[offset % (cur_map->mwidth * cur_map->mheight)];
 }
 
+// Tilemap cache
+//
+// The whole map is kept rendered in cache_pixmap along with which pixels are transparent.
+// Every draw asks pTile for the visible tiles again and compares the answer, plus a checksum
+// of the tile graphics, with what was cached. Only tiles that changed get rendered again, then
+// the visible window is copied out with the scroll applied.
+
+#define TMAP_CACHE_LINESCROLL	(1 << 16)	// transparency rules of the line scroll renderer
+
+static inline INT32 TilemapCacheMod(INT32 a, INT32 b)
+{
+	a %= b;
+	return (a < 0) ? (a + b) : a;
+}
+
+static UINT32 TilemapCacheGfxSum(const UINT8 *src, INT32 len)
+{
+	UINT32 sum = len;
+
+	if ((len & 3) == 0 && ((size_t)src & 3) == 0) {
+		const UINT32 *src32 = (const UINT32*)src;
+
+		for (INT32 i = 0; i < len / 4; i++) {
+			sum = ((sum << 5) | (sum >> 27)) ^ src32[i];
+		}
+	} else {
+		for (INT32 i = 0; i < len; i++) {
+			sum = ((sum << 5) | (sum >> 27)) ^ src[i];
+		}
+	}
+
+	return sum * 0x9e3779b1;
+}
+
+static INT32 TilemapCacheInit(GenericTilemap *map)
+{
+	if (map->cache_disable || map->dirty_tiles_enable) return 1;
+
+	if (map->cache_pixmap == NULL) {
+		INT32 pixels = map->mwidth * map->twidth * map->mheight * map->theight;
+
+		if (pixels > TMAP_CACHE_MAX_PIXELS) {
+			map->cache_disable = 1;
+			return 1;
+		}
+
+		map->cache_pixmap = (UINT16*)BurnMalloc(pixels * sizeof(UINT16));
+		map->cache_transmap = (UINT8*)BurnMalloc(pixels);
+		map->cache_tiles = (GenericTilemapCacheTile*)BurnMalloc(map->mwidth * map->mheight * sizeof(GenericTilemapCacheTile));
+
+		if (map->cache_pixmap == NULL || map->cache_transmap == NULL || map->cache_tiles == NULL) {
+			TilemapCacheExit(map);
+			map->cache_disable = 1;
+			return 1;
+		}
+
+		map->cache_valid = 0;
+	}
+
+	return 0;
+}
+
+// check that the cache was rendered with these draw settings, start over if not
+static INT32 TilemapCacheBegin(GenericTilemap *map, UINT32 params)
+{
+	if (TilemapCacheInit(map)) return 1;
+
+	if (map->cache_valid && map->cache_params != params) {
+		map->cache_hits = 0;
+
+		if (++map->cache_misses >= TMAP_CACHE_MAX_MISSES) {
+			TilemapCacheExit(map);
+			map->cache_disable = 1;
+			return 1;
+		}
+
+		map->cache_valid = 0;
+	} else if (++map->cache_hits >= 60) {
+		map->cache_misses = 0;
+	}
+
+	if (map->cache_valid == 0) {
+		// gfxnum -1 never matches
+		memset (map->cache_tiles, 0xff, map->mwidth * map->mheight * sizeof(GenericTilemapCacheTile));
+
+		map->cache_params = params;
+		map->cache_valid = 1;
+	}
+
+	cache_stamp++;
+
+	return 0;
+}
+
+static void TilemapCacheRenderTile(GenericTilemap *map, INT32 col, INT32 row, INT32 gfxnum, INT32 code, INT32 color, UINT32 flags, INT32 category, INT32 skip)
+{
+	INT32 pitch = map->mwidth * map->twidth;
+	UINT16 *dst = map->cache_pixmap + (row * map->theight * pitch) + (col * map->twidth);
+	UINT8 *trans = map->cache_transmap + (row * map->theight * pitch) + (col * map->twidth);
+
+	if (skip) {
+		for (UINT32 y = 0; y < map->theight; y++, trans += pitch) {
+			memset (trans, 1, map->twidth);
+		}
+		return;
+	}
+
+	GenericTilesGfx *gfx = &GenericGfxData[gfxnum];
+
+	UINT32 params = map->cache_params;
+	INT32 opaque = params & (TMAP_FORCEOPAQUE | TMAP_DRAWOPAQUE);
+	INT32 flipx = flags & TILE_FLIPX;
+	INT32 flipy = flags & TILE_FLIPY;
+
+	UINT8 *trans_tab = NULL;
+	INT32 transcolor = -1;
+
+	if (params & TMAP_CACHE_LINESCROLL) {
+		trans_tab = flipx ? map->transparent[category] : map->transparent[0];
+		if (trans_tab == NULL) trans_tab = map->transparent[0];
+	} else if ((map->flags & TMAP_TRANSPARENT) && (flags & TILE_OPAQUE) == 0 && opaque == 0) {
+		transcolor = map->transcolor;
+	} else if ((map->flags & TMAP_TRANSMASK) && (flags & TILE_OPAQUE) == 0 && opaque == 0) {
+		trans_tab = map->transparent[category];
+	}
+
+	UINT8 *src = gfx->gfxbase + (code * map->twidth * map->theight);
+
+	for (UINT32 y = 0; y < map->theight; y++, dst += pitch, trans += pitch) {
+		UINT8 *line = src + (flipy ? (map->theight - 1 - y) : y) * map->twidth;
+
+		for (UINT32 x = 0; x < map->twidth; x++) {
+			INT32 pxl = line[flipx ? (map->twidth - 1 - x) : x];
+
+			dst[x] = color + pxl;
+
+			if (trans_tab) {
+				trans[x] = trans_tab[pxl];
+			} else {
+				trans[x] = (pxl == transcolor) ? 1 : 0;
+			}
+		}
+	}
+}
+
+// bring ncols tiles of a map row, starting at col, up to date
+static void TilemapCacheUpdate(GenericTilemap *map, INT32 row, INT32 col, INT32 ncols)
+{
+	UINT32 params = map->cache_params;
+	INT32 category_or = (params & TMAP_DRAWLAYER1) ? 2 : 0;
+	INT32 opaque = params & TMAP_FORCEOPAQUE;
+	INT32 tgroup = (params >> 8) & 0xff;
+
+	if (ncols > (INT32)map->mwidth) ncols = map->mwidth;
+
+	for (INT32 i = 0; i < ncols; i++, col++)
+	{
+		if (col >= (INT32)map->mwidth) col = 0;
+
+		GenericTilemapCacheTile *tile = &map->cache_tiles[row * map->mwidth + col];
+
+		if (tile->stamp == cache_stamp) continue; // already checked during this draw
+		tile->stamp = cache_stamp;
+
+		INT32 code, color, gfxnum, category = 0, offset = map->pScan(col, row);
+		UINT32 flags;
+
+		map->pTile(offset, &gfxnum, &code, &color, &flags, &category);
+
+		category |= category_or;
+
+		if (category && (map->flags & TMAP_TRANSMASK)) {
+			if (map->transparent[category] == NULL) {
+				category = 0;
+			}
+		}
+
+		INT32 skip = 0;
+
+		if (opaque == 0)
+		{
+			if (flags & TILE_SKIP) skip = 1;
+
+			if (flags & TILE_GROUP_ENABLE) {
+				if ((INT32)((flags >> 16) & 0xff) != tgroup) {
+					skip = 1;
+				}
+			}
+		}
+
+		GenericTilesGfx *gfx = &GenericGfxData[gfxnum];
+
+		if (gfx->gfxbase == NULL) {
+			bprintf (PRINT_ERROR,_T("GenericTilemapDraw gfx[%d] not initialized!\n"), gfxnum);
+			skip = 1;
+		}
+
+		UINT32 gfxsum = 0;
+
+		if (skip) {
+			gfxnum = code = color = category = 0;
+			flags = TILE_SKIP;
+		} else {
+			color = ((color & gfx->color_mask) << gfx->depth) + gfx->color_offset;
+			code %= gfx->code_mask;
+			gfxsum = TilemapCacheGfxSum(gfx->gfxbase + (code * map->twidth * map->theight), map->twidth * map->theight);
+		}
+
+		if (tile->gfxnum == gfxnum && tile->code == code && tile->color == color && tile->flags == flags && tile->category == category && tile->gfxsum == gfxsum) {
+			continue;
+		}
+
+		tile->gfxnum = gfxnum;
+		tile->code = code;
+		tile->color = color;
+		tile->flags = flags;
+		tile->category = category;
+		tile->gfxsum = gfxsum;
+
+		TilemapCacheRenderTile(map, col, row, gfxnum, code, color, flags, category, skip);
+	}
+}
+
+// copy one line of the cache to the bitmap, going backwards through the cache if flipped
+static void TilemapCacheCopyLine(GenericTilemap *map, UINT16 *dest, UINT8 *prio, INT32 my, INT32 mx, INT32 width, INT32 flipx, INT32 priority)
+{
+	INT32 pitch = map->mwidth * map->twidth;
+	UINT16 *src = map->cache_pixmap + my * pitch;
+	UINT8 *trans = map->cache_transmap + my * pitch;
+
+	while (width > 0)
+	{
+		// run up to where the map wraps around
+		INT32 len = flipx ? (mx + 1) : (pitch - mx);
+		if (len > width) len = width;
+
+		if (flipx) {
+			for (INT32 x = 0; x < len; x++) {
+				if (trans[mx - x] == 0) {
+					dest[x] = src[mx - x];
+					prio[x] = priority;
+				}
+			}
+			mx = pitch - 1;
+		} else {
+			UINT16 *s = src + mx;
+			UINT8 *t = trans + mx;
+
+			// written without branches so the compiler can vectorize it
+			for (INT32 x = 0; x < len; x++) {
+				UINT16 m = t[x] - 1;	// 0xffff draw, 0 skip
+				dest[x] = (s[x] & m) | (dest[x] & ~m);
+				prio[x] = (priority & m) | (prio[x] & ~m);
+			}
+			mx = 0;
+		}
+
+		dest += len;
+		prio += len;
+		width -= len;
+	}
+}
+
+// one scroll value for the whole map
+static void TilemapCacheDraw(GenericTilemap *map, UINT16 *Bitmap, INT32 priority, INT32 minx, INT32 maxx, INT32 miny, INT32 maxy)
+{
+	INT32 pwidth = map->mwidth * map->twidth;
+	INT32 pheight = map->mheight * map->theight;
+	INT32 width = maxx - minx;
+
+	INT32 scrollx = map->scrollx - map->xoffset;
+	INT32 scrolly = map->scrolly - map->yoffset;
+
+	// flipping mirrors the screen inside the clip, (maxx - minx) - 1 - x
+	INT32 flipx = map->flags & TMAP_FLIPX;
+	INT32 flipy = map->flags & TMAP_FLIPY;
+
+	INT32 mx = TilemapCacheMod((flipx ? (width - 1 - minx) : minx) + scrollx, pwidth);
+
+	// tiles crossed by a line
+	INT32 lo = flipx ? TilemapCacheMod(mx - (width - 1), pwidth) : mx;
+	INT32 col = lo / map->twidth;
+	INT32 ncols = ((lo % map->twidth) + width + map->twidth - 1) / map->twidth;
+
+	INT32 last_row = -1;
+
+	for (INT32 y = miny; y < maxy; y++)
+	{
+		INT32 my = TilemapCacheMod((flipy ? ((maxy - miny) - 1 - y) : y) + scrolly, pheight);
+
+		if ((INT32)(my / map->theight) != last_row) {
+			last_row = my / map->theight;
+			TilemapCacheUpdate(map, last_row, col, ncols);
+		}
+
+		TilemapCacheCopyLine(map, Bitmap + y * nScreenWidth + minx, pPrioDraw + y * nScreenWidth + minx, my, mx, width, flipx, priority);
+	}
+}
+
+// scroll value for each line
+static void TilemapCacheDrawLines(GenericTilemap *map, UINT16 *Bitmap, INT32 priority, INT32 minx, INT32 maxx, INT32 miny, INT32 maxy)
+{
+	INT32 pwidth = map->mwidth * map->twidth;
+	INT32 pheight = map->mheight * map->theight;
+	INT32 width = maxx - minx;
+
+	for (INT32 y = miny; y < maxy; y++)
+	{
+		INT32 my = TilemapCacheMod(map->scrolly + y + map->yoffset, pheight);
+		INT32 scrollx = map->scrollx_table[(my * map->scroll_rows) / pheight] - map->xoffset;
+		INT32 mx = TilemapCacheMod(minx + scrollx, pwidth);
+
+		TilemapCacheUpdate(map, my / map->theight, mx / map->twidth, ((mx % map->twidth) + width + map->twidth - 1) / map->twidth);
+
+		TilemapCacheCopyLine(map, Bitmap + y * nScreenWidth + minx, pPrioDraw + y * nScreenWidth + minx, my, mx, width, 0, priority);
+	}
+}
+
+void GenericTilemapSetCache(INT32 which, INT32 enable)
+{
+#if defined FBA_DEBUG
+	if (which < 0 || which >= MAX_TILEMAPS) {
+		bprintf (PRINT_ERROR, _T("GenericTilemapSetCache(%d, %d); called with impossible tilemap!\n"), which, enable);
+		return;
+	}
+#endif
+
+	cur_map = &maps[which];
+
+#if defined FBA_DEBUG
+	if (cur_map->initialized == 0) {
+		bprintf (PRINT_ERROR, _T("GenericTilemapSetCache(%d, %d); called without initialized tilemap!\n"), which, enable);
+		return;
+	}
+#endif
+
+	if (enable == 0) {
+		TilemapCacheExit(cur_map);
+	}
+
+	cur_map->cache_disable = enable ? 0 : 1;
+	cur_map->cache_misses = 0;
+}
+
 void GenericTilemapDraw(INT32 which, UINT16 *Bitmap, INT32 priority)
 {
 #if defined FBA_DEBUG
@@ -746,6 +1153,24 @@ void GenericTilemapDraw(INT32 which, UINT16 *Bitmap, INT32 priority)
 	INT32 tgroup = (priority >> 8) & 0xff;
 	priority &= 0xff;
 
+	// pre-rendered map, only tiles that changed since the last draw are rendered again
+	UINT32 cache_params = (category_or ? TMAP_DRAWLAYER1 : 0) | opaque | opaque2 | (tgroup << 8);
+
+	if (cur_map->scroll_rows <= 1 && cur_map->scroll_cols <= 1)
+	{
+		if (TilemapCacheBegin(cur_map, cache_params) == 0) {
+			TilemapCacheDraw(cur_map, Bitmap, priority, minx, maxx, miny, maxy);
+			return;
+		}
+	}
+	else if (!(cur_map->scrolly_table != NULL && cur_map->scroll_cols > cur_map->mwidth) && cur_map->scrollx_table != NULL && cur_map->scroll_rows > cur_map->mheight && (cur_map->flags & (TMAP_FLIPX | TMAP_FLIPY)) == 0)
+	{
+		if (TilemapCacheBegin(cur_map, cache_params | TMAP_CACHE_LINESCROLL) == 0) {
+			TilemapCacheDrawLines(cur_map, Bitmap, priority, minx, maxx, miny, maxy);
+			return;
+		}
+	}
+
 	// column (less than tile size) and line scroll
 	if ((cur_map->scrolly_table != NULL) && (cur_map->scroll_cols > cur_map->mwidth))
 	{
@@ -150,6 +150,10 @@ void GenericTilemapAllTilesDirty(INT32 which);
 // Is this tile dirty (note that offset will be %= map_height * map_width!!)
 INT32 GenericTilemapGetTileDirty(INT32 which, UINT32 offset);
 
+// Tilemaps are kept pre-rendered and only changed tiles are drawn again, disable (0) this
+// for a tilemap if the driver changes what it draws in a way the cache can't see
+void GenericTilemapSetCache(INT32 which, INT32 enable);
+
 // Actually draw the tilemap.
 // which 	- select which tilemap to draw
 // Bitmap	- pointer to the bitmap to draw the tilemap
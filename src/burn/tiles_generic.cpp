@@ -14,6 +14,7 @@ Otherwise, use the Transfer code as usual.
 ================================================================================================*/
 
 #include "tiles_generic.h"
+#include "burn_prof.h"
 
 UINT8* pTileData;
 INT32 nScreenWidth, nScreenHeight;
@@ -171,48 +172,318 @@ void BurnTransferClear(UINT16 nFillPattern)
 	}
 }
 
-INT32 BurnTransferCopy(UINT32* pPalette)
+// Row converters, the AVX2 ones are picked at runtime when the cpu has them.
+// SSE2 and NEON have no gather so there the plain loops are as good as it gets.
+typedef void (*BurnTransferRow)(UINT8* pDest, const UINT16* pSrc, const UINT32* pPalette, INT32 nWidth);
+
+static void TransferRow16(UINT8* pDest, const UINT16* pSrc, const UINT32* pPalette, INT32 nWidth)
 {
-#if defined FBA_DEBUG
-	if (!Debug_BurnTransferInitted) bprintf(PRINT_ERROR, _T("BurnTransferCopy called without init\n"));
+	for (INT32 x = 0; x < nWidth; x++) {
+		((UINT16*)pDest)[x] = pPalette[pSrc[x]];
+	}
+}
+
+static void TransferRow24(UINT8* pDest, const UINT16* pSrc, const UINT32* pPalette, INT32 nWidth)
+{
+	for (INT32 x = 0; x < nWidth; x++) {
+		UINT32 c = pPalette[pSrc[x]];
+		*(pDest + (x * 3) + 0) = c & 0xFF;
+		*(pDest + (x * 3) + 1) = (c >> 8) & 0xFF;
+		*(pDest + (x * 3) + 2) = c >> 16;
+	}
+}
+
+static void TransferRow32(UINT8* pDest, const UINT16* pSrc, const UINT32* pPalette, INT32 nWidth)
+{
+	for (INT32 x = 0; x < nWidth; x++) {
+		((UINT32*)pDest)[x] = pPalette[pSrc[x]];
+	}
+}
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5))
+#define BURN_TRANSFER_AVX2
+#include <immintrin.h>
+
+__attribute__((target("avx2"))) static void TransferRow16AVX2(UINT8* pDest, const UINT16* pSrc, const UINT32* pPalette, INT32 nWidth)
+{
+	const __m256i mask = _mm256_set1_epi32(0xffff);
+	INT32 x = 0;
+
+	for (; x + 16 <= nWidth; x += 16) {
+		__m256i i0 = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(pSrc + x + 0)));
+		__m256i i1 = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(pSrc + x + 8)));
+		__m256i c0 = _mm256_and_si256(_mm256_i32gather_epi32((const int*)pPalette, i0, 4), mask);
+		__m256i c1 = _mm256_and_si256(_mm256_i32gather_epi32((const int*)pPalette, i1, 4), mask);
+
+		// packus works per 128-bit lane, put the quadwords back in order
+		__m256i c = _mm256_permute4x64_epi64(_mm256_packus_epi32(c0, c1), 0xd8);
+		_mm256_storeu_si256((__m256i*)(pDest + x * 2), c);
+	}
+
+	TransferRow16(pDest + x * 2, pSrc + x, pPalette, nWidth - x);
+}
+
+__attribute__((target("avx2"))) static void TransferRow32AVX2(UINT8* pDest, const UINT16* pSrc, const UINT32* pPalette, INT32 nWidth)
+{
+	INT32 x = 0;
+
+	for (; x + 8 <= nWidth; x += 8) {
+		__m256i i0 = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(pSrc + x)));
+		_mm256_storeu_si256((__m256i*)(pDest + x * 4), _mm256_i32gather_epi32((const int*)pPalette, i0, 4));
+	}
+
+	TransferRow32(pDest + x * 4, pSrc + x, pPalette, nWidth - x);
+}
+#endif
+
+static BurnTransferRow TransferGetRow(INT32 nBpp)
+{
+#if defined BURN_TRANSFER_AVX2
+	static INT32 nHaveAVX2 = -1;
+
+	if (nHaveAVX2 < 0) {
+		__builtin_cpu_init();
+		nHaveAVX2 = __builtin_cpu_supports("avx2") ? 1 : 0;
+	}
 #endif
 
-	UINT16* pSrc = pTransDraw;
-	UINT8* pDest = pBurnDraw;
+	switch (nBpp) {
+		case 2:
+#if defined BURN_TRANSFER_AVX2
+			if (nHaveAVX2) return TransferRow16AVX2;
+#endif
+			return TransferRow16;
+		case 3:
+			return TransferRow24;
+		case 4:
+#if defined BURN_TRANSFER_AVX2
+			if (nHaveAVX2) return TransferRow32AVX2;
+#endif
+			return TransferRow32;
+	}
 
-	pBurnDrvPalette = pPalette;
+	return NULL;
+}
+
+// Dirty-line mode (bBurnTransferDirtyLines): remember what was last sent to pBurnDraw
+// and skip the lines of pTransDraw that are the same, as long as the palette and the
+// destination didn't change.
+static UINT16* pTransPrevDraw = NULL;
+static UINT32* pTransPrevPalette = NULL;
+static INT32 nTransPrevPaletteLen = 0;
+static UINT8* pTransPrevDest = NULL;
+static INT32 nTransPrevPitch = 0;
+static INT32 nTransPrevBpp = 0;
+static bool bTransPrevValid = false;
+
+static void TransferFlushPending();
+
+void BurnTransferInvalidate()
+{
+	TransferFlushPending();
+
+	bTransPrevValid = false;
+}
+
+static void TransferPrevExit()
+{
+	BurnFree(pTransPrevDraw);
+	BurnFree(pTransPrevPalette);
+	nTransPrevPaletteLen = 0;
+	bTransPrevValid = false;
+}
+
+// Returns true if unchanged lines can be skipped this time
+static bool TransferPrevCheck(UINT32* pPalette, UINT8* pDest, INT32 nPitch, INT32 nBpp)
+{
+	INT32 nEntries = BurnDrvGetPaletteEntries();
+
+	if (pTransPrevDraw == NULL) {
+		pTransPrevDraw = (UINT16*)BurnMalloc(nTransWidth * nTransHeight * sizeof(UINT16));
+		bTransPrevValid = false;
+	}
+
+	if (nTransPrevPaletteLen != nEntries) {
+		BurnFree(pTransPrevPalette);
+		pTransPrevPalette = (UINT32*)BurnMalloc(nEntries * sizeof(UINT32));
+		nTransPrevPaletteLen = nEntries;
+		bTransPrevValid = false;
+	}
+
+	if (pTransPrevDraw == NULL || pTransPrevPalette == NULL) {
+		TransferPrevExit();
+		return false;
+	}
+
+	bool bValid = bTransPrevValid && pTransPrevDest == pDest && nTransPrevPitch == nPitch && nTransPrevBpp == nBpp;
+
+	if (bValid && memcmp(pTransPrevPalette, pPalette, nEntries * sizeof(UINT32))) {
+		bValid = false;
+	}
 
-	switch (nBurnBpp) {
-		case 2: {
-			for (INT32 y = 0; y < nTransHeight; y++, pSrc += nTransWidth, pDest += nBurnPitch) {
-				for (INT32 x = 0; x < nTransWidth; x ++) {
-					((UINT16*)pDest)[x] = pPalette[pSrc[x]];
+	if (!bValid) {
+		memcpy(pTransPrevPalette, pPalette, nEntries * sizeof(UINT32));
+		pTransPrevDest = pDest;
+		nTransPrevPitch = nPitch;
+		nTransPrevBpp = nBpp;
+	}
+
+	return bValid;
+}
+
+static void TransferCopy(UINT16* pSrc, UINT32* pPalette, UINT8* pDest, INT32 nPitch, INT32 nBpp)
+{
+	BurnTransferRow pRow = TransferGetRow(nBpp);
+	if (pRow == NULL) {
+		return;
+	}
+
+	// Deferred frames alternate between buffers, there is nothing to compare against
+	if (bBurnTransferDirtyLines && !bBurnTransferDeferred && pPalette) {
+		bool bSkip = TransferPrevCheck(pPalette, pDest, nPitch, nBpp);
+
+		if (pTransPrevDraw) {
+			UINT16* pPrev = pTransPrevDraw;
+
+			for (INT32 y = 0; y < nTransHeight; y++, pSrc += nTransWidth, pPrev += nTransWidth, pDest += nPitch) {
+				if (bSkip && memcmp(pSrc, pPrev, nTransWidth * sizeof(UINT16)) == 0) {
+					continue;
 				}
+
+				pRow(pDest, pSrc, pPalette, nTransWidth);
+				memcpy(pPrev, pSrc, nTransWidth * sizeof(UINT16));
 			}
-			break;
+
+			bTransPrevValid = true;
+
+			return;
 		}
-		case 3: {
-			for (INT32 y = 0; y < nTransHeight; y++, pSrc += nTransWidth, pDest += nBurnPitch) {
-				for (INT32 x = 0; x < nTransWidth; x++) {
-					UINT32 c = pPalette[pSrc[x]];
-					*(pDest + (x * 3) + 0) = c & 0xFF;
-					*(pDest + (x * 3) + 1) = (c >> 8) & 0xFF;
-					*(pDest + (x * 3) + 2) = c >> 16;
+	}
 
-				}
-			}
-			break;
+	bTransPrevValid = false;
+
+	for (INT32 y = 0; y < nTransHeight; y++, pSrc += nTransWidth, pDest += nPitch) {
+		pRow(pDest, pSrc, pPalette, nTransWidth);
+	}
+}
+
+// Deferred mode (bBurnTransferDeferred): BurnTransferCopy() keeps a copy of pTransDraw
+// and the palette together with where it was meant to go, the frontend picks it up
+// with BurnTransferDeferredTake() after the frame and converts it whenever it likes,
+// e.g. on another thread while the next frame is emulated. There are two slots so
+// the next frame can be drawn while the last one is still being converted.
+#define TRANSFER_DEFERRED_PALETTE	0x10000		// Anything a UINT16 pixel can index
+
+struct TransferSnapshot {
+	UINT16* pDraw;
+	UINT32* pPalette;
+	UINT8* pDest;
+	INT32 nPitch;
+	INT32 nBpp;
+	bool bPalette;
+};
+
+static TransferSnapshot TransferSnap[2];
+static INT32 nTransferSnapSlot = 0;
+static bool bTransferSnapTaken = false;			// A snapshot was taken this frame
+
+static void TransferSnapExit()
+{
+	for (INT32 i = 0; i < 2; i++) {
+		BurnFree(TransferSnap[i].pDraw);
+		BurnFree(TransferSnap[i].pPalette);
+	}
+
+	nTransferSnapSlot = 0;
+	bTransferSnapTaken = false;
+}
+
+static INT32 TransferSnapTake(UINT32* pPalette)
+{
+	TransferSnapshot* pSnap = &TransferSnap[nTransferSnapSlot];
+
+	if (pSnap->pDraw == NULL) {
+		pSnap->pDraw = (UINT16*)BurnMalloc(nTransWidth * nTransHeight * sizeof(UINT16));
+		pSnap->pPalette = (UINT32*)BurnMalloc(TRANSFER_DEFERRED_PALETTE * sizeof(UINT32));
+
+		if (pSnap->pDraw == NULL || pSnap->pPalette == NULL) {
+			BurnFree(pSnap->pDraw);
+			BurnFree(pSnap->pPalette);
+			return 1;
 		}
-		case 4: {
-			for (INT32 y = 0; y < nTransHeight; y++, pSrc += nTransWidth, pDest += nBurnPitch) {
-				for (INT32 x = 0; x < nTransWidth; x++) {
-					((UINT32*)pDest)[x] = pPalette[pSrc[x]];
-				}
-			}
-			break;
+	}
+
+	memcpy(pSnap->pDraw, pTransDraw, nTransWidth * nTransHeight * sizeof(UINT16));
+
+	pSnap->bPalette = (pPalette != NULL);
+	if (pPalette) {
+		INT32 nEntries = BurnDrvGetPaletteEntries();
+		if (nEntries > TRANSFER_DEFERRED_PALETTE) nEntries = TRANSFER_DEFERRED_PALETTE;
+
+		memcpy(pSnap->pPalette, pPalette, nEntries * sizeof(UINT32));
+	}
+
+	pSnap->pDest = pBurnDraw;
+	pSnap->nPitch = nBurnPitch;
+	pSnap->nBpp = nBurnBpp;
+
+	bTransferSnapTaken = true;
+
+	return 0;
+}
+
+// Something is about to draw over pBurnDraw, so the snapshot has to be in there first
+static void TransferFlushPending()
+{
+	if (bTransferSnapTaken) {
+		bTransferSnapTaken = false;
+		BurnTransferDeferredFlush(nTransferSnapSlot);
+	}
+}
+
+INT32 BurnTransferDeferredTake()
+{
+	if (!bTransferSnapTaken) {
+		return -1;
+	}
+
+	INT32 nSlot = nTransferSnapSlot;
+
+	nTransferSnapSlot ^= 1;
+	bTransferSnapTaken = false;
+
+	return nSlot;
+}
+
+void BurnTransferDeferredFlush(INT32 nSlot)
+{
+	TransferSnapshot* pSnap = &TransferSnap[nSlot & 1];
+
+	if (pSnap->pDraw == NULL) {
+		return;
+	}
+
+	TransferCopy(pSnap->pDraw, pSnap->bPalette ? pSnap->pPalette : NULL, pSnap->pDest, pSnap->nPitch, pSnap->nBpp);
+}
+
+INT32 BurnTransferCopy(UINT32* pPalette)
+{
+#if defined FBA_DEBUG
+	if (!Debug_BurnTransferInitted) bprintf(PRINT_ERROR, _T("BurnTransferCopy called without init\n"));
+#endif
+
+	BURN_PROF_SCOPE(BURN_PROF_DRAW);
+
+	pBurnDrvPalette = pPalette;
+
+	if (bBurnTransferDeferred && pBurnDraw) {
+		if (TransferSnapTake(pPalette) == 0) {
+			return 0;
 		}
 	}
 
+	TransferCopy(pTransDraw, pPalette, pBurnDraw, nBurnPitch, nBurnBpp);
+
 	return 0;
 }
 
@@ -222,6 +493,9 @@ void BurnTransferExit()
 	if (!Debug_BurnTransferInitted) bprintf(PRINT_ERROR, _T("BurnTransferExit called without init\n"));
 #endif
 
+	TransferPrevExit();
+	TransferSnapExit();
+
 	BurnBitmapExit();
 	pTransDraw = NULL;
 	pPrioDraw = NULL;
@@ -248,6 +522,8 @@ INT32 BurnTransferInit()
 	pTransDraw = BurnBitmapGetBitmap(0);
 	pPrioDraw = BurnBitmapGetPriomap(0);
 
+	bTransPrevValid = false;
+
 	BurnTransferClear();
 
 	return 0;
@@ -257,57 +533,309 @@ INT32 BurnTransferInit()
 Graphics Decoding
 ================================================================================================*/
 
+// Decoded graphics can be kept on disk, so the next start of the same set reads them back
+// instead of decoding them again. Off unless the frontend enables it and sets the path.
+bool bBurnUseGfxCache = false;
+TCHAR szBurnGfxCachePath[MAX_PATH] = _T("");
+
+#define GFX_CACHE_MIN_LEN	0x40000		// smaller decodes are quicker than opening a file
+#define GFX_CACHE_MAGIC		0x58464742	// 'BGFX'
+#define GFX_CACHE_VERSION	1
+
+#define GFX_MAX_WIDTH		256			// wider tiles go through readbit() for every pixel
+
+struct GfxCacheHeader {
+	UINT32 nMagic;
+	UINT32 nVersion;
+	UINT32 nLen;
+	UINT32 nReserved;
+	UINT64 nKey;
+};
+
 inline static INT32 readbit(const UINT8 *src, INT32 bitnum)
 {
 	return src[bitnum / 8] & (0x80 >> (bitnum % 8));
 }
 
-void GfxDecode(INT32 num, INT32 numPlanes, INT32 xSize, INT32 ySize, INT32 planeoffsets[], INT32 xoffsets[], INT32 yoffsets[], INT32 modulo, UINT8 *pSrc, UINT8 *pDest)
+// A byte of one plane expanded to 8 pixels of 0 or 1, in memory order
+static UINT64 GfxExpand[256];
+static bool bGfxExpandInit = false;
+
+static void GfxExpandInit()
 {
-	INT32 c;
+	for (INT32 i = 0; i < 256; i++) {
+		UINT8 pix[8];
+		for (INT32 b = 0; b < 8; b++) {
+			pix[b] = (i >> (7 - b)) & 1;
+		}
+		memcpy(&GfxExpand[i], pix, 8);
+	}
+
+	bGfxExpandInit = true;
+}
+
+static void GfxDecodeTiles(INT32 first, INT32 last, INT32 numPlanes, INT32 xSize, INT32 ySize, INT32 planeoffsets[], INT32 xoffsets[], INT32 yoffsets[], INT32 modulo, UINT8 *pSrc, UINT8 *pDest)
+{
+	INT32 c, plane, x, y;
+
+	if (xSize > GFX_MAX_WIDTH) {
+		for (c = first; c < last; c++) {
+			UINT8 *dp = pDest + (c * xSize * ySize);
+			memset(dp, 0, xSize * ySize);
 
-	for (c = 0; c < num; c++) {
-		INT32 plane, x, y;
+			for (plane = 0; plane < numPlanes; plane++) {
+				INT32 planebit = 1 << (numPlanes - 1 - plane);
+				INT32 planeoffs = (c * modulo) + planeoffsets[plane];
+
+				for (y = 0; y < ySize; y++) {
+					INT32 yoffs = planeoffs + yoffsets[y];
+					dp = pDest + (c * xSize * ySize) + (y * xSize);
+
+					for (x = 0; x < xSize; x++) {
+						if (readbit(pSrc, yoffs + xoffsets[x])) dp[x] |= planebit;
+					}
+				}
+			}
+		}
+		return;
+	}
+
+	if (!bGfxExpandInit) GfxExpandInit();
+
+	// Where each pixel of a row comes from, relative to the first byte of the row.
+	// Runs of 8 pixels taken in order from one whole byte are done in one go.
+	INT32 xbyte[GFX_MAX_WIDTH];
+	UINT8 xshift[GFX_MAX_WIDTH];
+	bool xrun[GFX_MAX_WIDTH / 8];
+
+	for (x = 0; x < xSize; x++) {
+		xbyte[x] = xoffsets[x] >> 3;
+		xshift[x] = 7 - (xoffsets[x] & 7);
+	}
+
+	for (x = 0; x < xSize / 8; x++) {
+		xrun[x] = (xoffsets[x * 8] & 7) == 0;
+		for (INT32 i = 1; i < 8; i++) {
+			if (xoffsets[x * 8 + i] != xoffsets[x * 8] + i) xrun[x] = false;
+		}
+	}
+
+	// Packed pixels: all planes of a pixel are neighbouring bits of one byte
+	// (e.g. 4bpp nibbles), so a pixel is a single shift and mask.
+	bool packed = (numPlanes <= 8);
+	INT32 pmask = (1 << numPlanes) - 1;
+	INT32 pbyte[GFX_MAX_WIDTH];
+	UINT8 pshift[GFX_MAX_WIDTH];
+
+	for (plane = 1; plane < numPlanes && packed; plane++) {
+		if (planeoffsets[plane] != planeoffsets[0] + plane) packed = false;
+	}
+
+	for (x = 0; x < xSize && packed; x++) {
+		INT32 offs = xoffsets[x] + (planeoffsets[0] & 7);
+		if ((offs & 7) + numPlanes > 8) packed = false;
+		pbyte[x] = offs >> 3;
+		pshift[x] = 8 - ((offs & 7) + numPlanes);
+	}
+
+	for (c = first; c < last; c++) {
+		UINT8 *tile = pDest + (c * xSize * ySize);
+
+		if (packed) {
+			for (y = 0; y < ySize; y++) {
+				INT32 yoffs = (c * modulo) + (planeoffsets[0] & ~7) + yoffsets[y];
+				UINT8 *dp = tile + (y * xSize);
+
+				if (yoffs & 7) {
+					memset(dp, 0, xSize);
+					for (plane = 0; plane < numPlanes; plane++) {
+						for (x = 0; x < xSize; x++) {
+							if (readbit(pSrc, yoffs + (planeoffsets[0] & 7) + plane + xoffsets[x])) dp[x] |= 1 << (numPlanes - 1 - plane);
+						}
+					}
+					continue;
+				}
+
+				const UINT8 *src = pSrc + (yoffs >> 3);
+
+				for (x = 0; x < xSize; x++) {
+					dp[x] = (src[pbyte[x]] >> pshift[x]) & pmask;
+				}
+			}
+			continue;
+		}
 
-		UINT8 *dp = pDest + (c * xSize * ySize);
-		memset(dp, 0, xSize * ySize);
+		memset(tile, 0, xSize * ySize);
 
 		for (plane = 0; plane < numPlanes; plane++) {
-			INT32 planebit = 1 << (numPlanes - 1 - plane);
+			INT32 planeshift = numPlanes - 1 - plane;
 			INT32 planeoffs = (c * modulo) + planeoffsets[plane];
 
+			if (planeshift > 7) continue;		// doesn't fit in the 8 bit pixels anyway
+
 			for (y = 0; y < ySize; y++) {
 				INT32 yoffs = planeoffs + yoffsets[y];
-				dp = pDest + (c * xSize * ySize) + (y * xSize);
+				UINT8 *dp = tile + (y * xSize);
 
-				for (x = 0; x < xSize; x++) {
-					if (readbit(pSrc, yoffs + xoffsets[x])) dp[x] |= planebit;
+				if (yoffs & 7) {
+					for (x = 0; x < xSize; x++) {
+						if (readbit(pSrc, yoffs + xoffsets[x])) dp[x] |= 1 << planeshift;
+					}
+					continue;
+				}
+
+				const UINT8 *src = pSrc + (yoffs >> 3);
+
+				for (x = 0; x < xSize; ) {
+					if ((x & 7) == 0 && x + 8 <= xSize && xrun[x >> 3]) {
+						UINT64 pix;
+						memcpy(&pix, dp + x, 8);
+						pix |= GfxExpand[src[xbyte[x]]] << planeshift;
+						memcpy(dp + x, &pix, 8);
+						x += 8;
+					} else {
+						dp[x] |= ((src[xbyte[x]] >> xshift[x]) & 1) << planeshift;
+						x++;
+					}
 				}
 			}
 		}
 	}
 }
 
-void GfxDecodeSingle(INT32 which, INT32 numPlanes, INT32 xSize, INT32 ySize, INT32 planeoffsets[], INT32 xoffsets[], INT32 yoffsets[], INT32 modulo, UINT8 *pSrc, UINT8 *pDest)
+static UINT64 GfxCacheHash(UINT64 h, const void *ptr, INT32 len)
+{
+	const UINT8 *p = (const UINT8*)ptr;
+
+	for (; len >= 8; len -= 8, p += 8) {
+		UINT64 v;
+		memcpy(&v, p, 8);
+		h = (h ^ v) * 0x100000001b3ULL;
+		h ^= h >> 29;
+	}
+
+	for (; len > 0; len--, p++) {
+		h = (h ^ *p) * 0x100000001b3ULL;
+	}
+
+	return h;
+}
+
+// The decode parameters, the crcs of the set's roms and the source data itself
+static UINT64 GfxCacheKey(INT32 num, INT32 numPlanes, INT32 xSize, INT32 ySize, INT32 planeoffsets[], INT32 xoffsets[], INT32 yoffsets[], INT32 modulo, UINT8 *pSrc)
+{
+	INT32 params[5] = { num, numPlanes, xSize, ySize, modulo };
+	UINT64 h = 0xcbf29ce484222325ULL;
+
+	h = GfxCacheHash(h, params, sizeof(params));
+	h = GfxCacheHash(h, planeoffsets, numPlanes * sizeof(INT32));
+	h = GfxCacheHash(h, xoffsets, xSize * sizeof(INT32));
+	h = GfxCacheHash(h, yoffsets, ySize * sizeof(INT32));
+
+	struct BurnRomInfo ri;
+	for (INT32 i = 0; BurnDrvGetRomInfo(&ri, i) == 0; i++) {
+		h = GfxCacheHash(h, &ri.nCrc, sizeof(ri.nCrc));
+	}
+
+	// Range of source bits the decode reads
+	INT32 nMin = planeoffsets[0], nMax = planeoffsets[0];
+	for (INT32 i = 1; i < numPlanes; i++) {
+		if (planeoffsets[i] < nMin) nMin = planeoffsets[i];
+		if (planeoffsets[i] > nMax) nMax = planeoffsets[i];
+	}
+
+	INT32 nMinY = yoffsets[0], nMaxY = yoffsets[0];
+	for (INT32 i = 1; i < ySize; i++) {
+		if (yoffsets[i] < nMinY) nMinY = yoffsets[i];
+		if (yoffsets[i] > nMaxY) nMaxY = yoffsets[i];
+	}
+
+	INT32 nMinX = xoffsets[0], nMaxX = xoffsets[0];
+	for (INT32 i = 1; i < xSize; i++) {
+		if (xoffsets[i] < nMinX) nMinX = xoffsets[i];
+		if (xoffsets[i] > nMaxX) nMaxX = xoffsets[i];
+	}
+
+	nMin += nMinY + nMinX;
+	nMax += nMaxY + nMaxX + (num - 1) * modulo;
+
+	return GfxCacheHash(h, pSrc + (nMin >> 3), (nMax >> 3) - (nMin >> 3) + 1);
+}
+
+// returns 1 if the name doesn't fit in MAX_PATH (the cache is skipped then)
+static INT32 GfxCacheName(TCHAR *szName, UINT64 nKey)
 {
-	INT32 plane, x, y;
+	INT32 nRet = _sntprintf(szName, MAX_PATH, _T("%s%s_%08x%08x.gfx"), szBurnGfxCachePath, BurnDrvGetText(DRV_NAME), (UINT32)(nKey >> 32), (UINT32)nKey);
+	szName[MAX_PATH - 1] = 0;
 
-	UINT8 *dp = pDest + (which * xSize * ySize);
-	memset(dp, 0, xSize * ySize);
+	return (nRet < 0 || nRet >= MAX_PATH) ? 1 : 0;
+}
+
+static INT32 GfxCacheLoad(UINT64 nKey, UINT8 *pDest, INT32 nLen)
+{
+	TCHAR szName[MAX_PATH];
+	if (GfxCacheName(szName, nKey)) return 1;
 
-	for (plane = 0; plane < numPlanes; plane++) {
-		INT32 planebit = 1 << (numPlanes - 1 - plane);
-		INT32 planeoffs = (which * modulo) + planeoffsets[plane];
+	FILE *fp = _tfopen(szName, _T("rb"));
+	if (fp == NULL) return 1;
 
-		for (y = 0; y < ySize; y++) {
-			INT32 yoffs = planeoffs + yoffsets[y];
-			dp = pDest + (which * xSize * ySize) + (y * xSize);
+	GfxCacheHeader header;
+	INT32 nRet = 1;
 
-			for (x = 0; x < xSize; x++) {
-				if (readbit(pSrc, yoffs + xoffsets[x])) dp[x] |= planebit;
+	if (fread(&header, sizeof(header), 1, fp) == 1) {
+		if (header.nMagic == GFX_CACHE_MAGIC && header.nVersion == GFX_CACHE_VERSION && header.nLen == (UINT32)nLen && header.nKey == nKey) {
+			if (fread(pDest, 1, nLen, fp) == (size_t)nLen) {
+				nRet = 0;
 			}
 		}
 	}
+
+	fclose(fp);
+
+	return nRet;
+}
+
+static void GfxCacheSave(UINT64 nKey, UINT8 *pDest, INT32 nLen)
+{
+	TCHAR szName[MAX_PATH];
+	if (GfxCacheName(szName, nKey)) return;
+
+	FILE *fp = _tfopen(szName, _T("wb"));
+	if (fp == NULL) return;
+
+	GfxCacheHeader header;
+	memset(&header, 0, sizeof(header));
+	header.nMagic = GFX_CACHE_MAGIC;
+	header.nVersion = GFX_CACHE_VERSION;
+	header.nLen = nLen;
+	header.nKey = nKey;
+
+	fwrite(&header, sizeof(header), 1, fp);
+	fwrite(pDest, 1, nLen, fp);
+	fclose(fp);
+}
+
+void GfxDecode(INT32 num, INT32 numPlanes, INT32 xSize, INT32 ySize, INT32 planeoffsets[], INT32 xoffsets[], INT32 yoffsets[], INT32 modulo, UINT8 *pSrc, UINT8 *pDest)
+{
+	INT32 nLen = num * xSize * ySize;
+	bool bCache = bBurnUseGfxCache && szBurnGfxCachePath[0] && nLen >= GFX_CACHE_MIN_LEN;
+	UINT64 nKey = 0;
+
+	if (bCache) {
+		nKey = GfxCacheKey(num, numPlanes, xSize, ySize, planeoffsets, xoffsets, yoffsets, modulo, pSrc);
+		if (GfxCacheLoad(nKey, pDest, nLen) == 0) return;
+	}
+
+	GfxDecodeTiles(0, num, numPlanes, xSize, ySize, planeoffsets, xoffsets, yoffsets, modulo, pSrc, pDest);
+
+	if (bCache) {
+		GfxCacheSave(nKey, pDest, nLen);
+	}
+}
+
+void GfxDecodeSingle(INT32 which, INT32 numPlanes, INT32 xSize, INT32 ySize, INT32 planeoffsets[], INT32 xoffsets[], INT32 yoffsets[], INT32 modulo, UINT8 *pSrc, UINT8 *pDest)
+{
+	GfxDecodeTiles(which, which + 1, numPlanes, xSize, ySize, planeoffsets, xoffsets, yoffsets, modulo, pSrc, pDest);
 }
 
 //================================================================================================
@@ -2,12 +2,29 @@
 #include "burnint.h"
 #include "timer.h"
 
-#define MAX_TIMER_VALUE ((1 << 30) - 65536)
+// Timers live in a binary heap ordered on their (absolute) expiry time, so the
+// cpu can be run straight up to the next one instead of polling every timer.
+// Timers 0 and 1 are the FM timers, shared by all the chips like they always
+// were (the chip number is ignored and the callback gets (0, c)). Drivers can
+// add as many generic timers as they need with BurnTimerAdd.
+
+#define TIMER_FM_COUNT		2
+#define TIMER_NEVER			((INT64)0x7fffffffffffffffLL)
+
+struct burn_timer {
+	INT64 nExpire;								// absolute time in timer ticks
+	INT64 nPeriod;								// 0 = one-shot
+	INT32 nHeapPos;								// -1 = stopped
+	INT32 (*pCallback)(INT32, INT32);
+	INT32 nParam[2];
+};
+
+static burn_timer *pTimers = NULL;
+static INT32 *pTimerHeap = NULL;
+static INT32 nTimerCount = 0, nTimerAlloc = 0, nTimerHeapCount = 0;
 
 double dTime;									// Time elapsed since the emulated machine was started
 
-static INT32 nTimerCount[2], nTimerStart[2];
-
 // Callbacks
 static INT32 (*pTimerOverCallback)(INT32, INT32);
 static double (*pTimerTimeCallback)();
@@ -18,6 +35,10 @@ INT32 (*BurnTimerCPUTotalCycles)() = NULL;
 static INT32 (*pCPURun)(INT32) = NULL;
 static void (*pCPURunEnd)() = NULL;
 
+static INT64 nTicksBase;						// absolute time of cycle 0 of this frame
+static INT64 nTicksTotal, nTicksDone;
+static INT32 nTicksExtra;
+
 // ---------------------------------------------------------------------------
 // Running time
 
@@ -31,257 +52,315 @@ extern "C" double BurnTimerGetTime()
 	return dTime + pTimerTimeCallback();
 }
 
-// ---------------------------------------------------------------------------
-// Update timers
+static inline INT64 BurnTimerNow()
+{
+	return nTicksBase + MAKE_TIMER_TICKS(BurnTimerCPUTotalCycles(), BurnTimerCPUClockspeed);
+}
 
-static INT32 nTicksTotal, nTicksDone, nTicksExtra;
+// ---------------------------------------------------------------------------
+// Timer heap
 
-INT32 BurnTimerUpdate(INT32 nCycles)
+static inline INT32 TimerBefore(INT32 a, INT32 b)
 {
-	INT32 nIRQStatus = 0;
+	if (pTimers[a].nExpire != pTimers[b].nExpire) {
+		return pTimers[a].nExpire < pTimers[b].nExpire;
+	}
 
-	nTicksTotal = MAKE_TIMER_TICKS(nCycles, BurnTimerCPUClockspeed);
+	return a < b;
+}
 
-//	bprintf(PRINT_NORMAL, _T(" -- Ticks: %08X, cycles %i\n"), nTicksTotal, nCycles);
+static inline void TimerHeapSet(INT32 nPos, INT32 nTimer)
+{
+	pTimerHeap[nPos] = nTimer;
+	pTimers[nTimer].nHeapPos = nPos;
+}
 
-	while (nTicksDone < nTicksTotal) {
-		INT32 nTimer, nCyclesSegment, nTicksSegment;
+static void TimerHeapUp(INT32 nPos)
+{
+	INT32 nTimer = pTimerHeap[nPos];
 
-		// Determine which timer fires first
-		if (nTimerCount[0] <= nTimerCount[1]) {
-			nTicksSegment = nTimerCount[0];
-		} else {
-			nTicksSegment = nTimerCount[1];
-		}
-		if (nTicksSegment > nTicksTotal) {
-			nTicksSegment = nTicksTotal;
-		}
+	while (nPos > 0) {
+		INT32 nParent = (nPos - 1) >> 1;
+		if (!TimerBefore(nTimer, pTimerHeap[nParent])) break;
 
-		nCyclesSegment = MAKE_CPU_CYLES(nTicksSegment + nTicksExtra, BurnTimerCPUClockspeed);
-//		bprintf(PRINT_NORMAL, _T("  - Timer: %08X, %08X, %08X, cycles %i, %i\n"), nTicksDone, nTicksSegment, nTicksTotal, nCyclesSegment, BurnTimerCPUTotalCycles());
+		TimerHeapSet(nPos, pTimerHeap[nParent]);
+		nPos = nParent;
+	}
 
-		pCPURun(nCyclesSegment - BurnTimerCPUTotalCycles());
+	TimerHeapSet(nPos, nTimer);
+}
 
-		nTicksDone = MAKE_TIMER_TICKS(BurnTimerCPUTotalCycles() + 1, BurnTimerCPUClockspeed) - 1;
-//		bprintf(PRINT_NORMAL, _T("  - ticks done -> %08X cycles -> %i\n"), nTicksDone, BurnTimerCPUTotalCycles());
+static void TimerHeapDown(INT32 nPos)
+{
+	INT32 nTimer = pTimerHeap[nPos];
 
-		nTimer = 0;
-		if (nTicksDone >= nTimerCount[0]) {
-			if (nTimerStart[0] == MAX_TIMER_VALUE) {
-				nTimerCount[0] = MAX_TIMER_VALUE;
-			} else {
-				nTimerCount[0] += nTimerStart[0];
-			}
-//			bprintf(PRINT_NORMAL, _T("  - timer 0 fired\n"));
-			nTimer |= 1;
-		}
-		if (nTicksDone >= nTimerCount[1]) {
-			if (nTimerStart[1] == MAX_TIMER_VALUE) {
-				nTimerCount[1] = MAX_TIMER_VALUE;
-			} else {
-				nTimerCount[1] += nTimerStart[1];
-			}
-//			bprintf(PRINT_NORMAL, _T("  - timer 1 fired\n"));
-			nTimer |= 2;
-		}
-		if (nTimer & 1) {
-			nIRQStatus |= pTimerOverCallback(0, 0);
-		}
-		if (nTimer & 2) {
-			nIRQStatus |= pTimerOverCallback(0, 1);
+	while (1) {
+		INT32 nChild = nPos * 2 + 1;
+		if (nChild >= nTimerHeapCount) break;
+
+		if (nChild + 1 < nTimerHeapCount && TimerBefore(pTimerHeap[nChild + 1], pTimerHeap[nChild])) {
+			nChild++;
 		}
+		if (!TimerBefore(pTimerHeap[nChild], nTimer)) break;
+
+		TimerHeapSet(nPos, pTimerHeap[nChild]);
+		nPos = nChild;
 	}
 
-	return nIRQStatus;
+	TimerHeapSet(nPos, nTimer);
 }
 
-void BurnTimerEndFrame(INT32 nCycles)
+static void TimerRemove(INT32 nTimer)
 {
-	INT32 nTicks = MAKE_TIMER_TICKS(nCycles, BurnTimerCPUClockspeed);
+	INT32 nPos = pTimers[nTimer].nHeapPos;
+	if (nPos < 0) return;
 
-	BurnTimerUpdate(nCycles);
+	pTimers[nTimer].nHeapPos = -1;
 
-	if (nTimerCount[0] < MAX_TIMER_VALUE) {
-		nTimerCount[0] -= nTicks;
-	}
-	if (nTimerCount[1] < MAX_TIMER_VALUE) {
-		nTimerCount[1] -= nTicks;
-	}
+	nTimerHeapCount--;
+	if (nPos == nTimerHeapCount) return;
 
-	nTicksDone -= nTicks;
-	if (nTicksDone < 0) {
-//		bprintf(PRINT_ERROR, _T(" -- ticks done -> %08X\n"), nTicksDone);
-		nTicksDone = 0;
-	}
+	TimerHeapSet(nPos, pTimerHeap[nTimerHeapCount]);
+	TimerHeapUp(nPos);
+	TimerHeapDown(pTimers[pTimerHeap[nPos]].nHeapPos);
 }
 
-void BurnTimerUpdateEnd()
+static void TimerSchedule(INT32 nTimer, INT64 nExpire)
 {
-//	bprintf(PRINT_NORMAL, _T("  - end %i\n"), BurnTimerCPUTotalCycles());
+	burn_timer *t = &pTimers[nTimer];
 
-	pCPURunEnd();
+	t->nExpire = nExpire;
 
-	nTicksTotal = 0;
+	if (t->nHeapPos < 0) {
+		TimerHeapSet(nTimerHeapCount++, nTimer);
+		TimerHeapUp(nTimerHeapCount - 1);
+	} else {
+		TimerHeapUp(t->nHeapPos);
+		TimerHeapDown(t->nHeapPos);
+	}
 }
 
+static inline INT64 TimerNextExpire()
+{
+	return nTimerHeapCount ? pTimers[pTimerHeap[0]].nExpire : TIMER_NEVER;
+}
 
-// ---------------------------------------------------------------------------
-// Callbacks for the sound cores
-/*
-static INT32 BurnTimerExtraCallbackDummy()
+static INT32 TimerAlloc(INT32 (*pCallback)(INT32, INT32), INT32 n, INT32 c)
 {
-	return 0;
+	if (nTimerCount == nTimerAlloc) {
+		nTimerAlloc = nTimerAlloc ? nTimerAlloc * 2 : 16;
+		pTimers = (burn_timer*)realloc(pTimers, nTimerAlloc * sizeof(burn_timer));
+		pTimerHeap = (INT32*)realloc(pTimerHeap, nTimerAlloc * sizeof(INT32));
+	}
+
+	burn_timer *t = &pTimers[nTimerCount];
+
+	t->nExpire = TIMER_NEVER;
+	t->nPeriod = 0;
+	t->nHeapPos = -1;
+	t->pCallback = pCallback;
+	t->nParam[0] = n;
+	t->nParam[1] = c;
+
+	return nTimerCount++;
 }
-*/
-void BurnOPLTimerCallback(INT32 c, double period)
+
+// (Re)start FM timer c, or stop it if nTicks is 0
+static void TimerStartFM(INT32 c, INT64 nTicks, INT64 nPeriod)
 {
+	INT32 nTimer = c;
+
 	pCPURunEnd();
 
-	if (period == 0.0) {
-		nTimerCount[c] = MAX_TIMER_VALUE;
-//		bprintf(PRINT_NORMAL, _T("  - timer %i stopped\n"), c);
+	if (nTimer < 0 || nTimer >= TIMER_FM_COUNT) {
+		bprintf(PRINT_ERROR, _T("BurnTimer: no FM timer %i\n"), c);
 		return;
 	}
 
-	nTimerCount[c]  = (INT32)(period * (double)TIMER_TICKS_PER_SECOND);
-	nTimerCount[c] += MAKE_TIMER_TICKS(BurnTimerCPUTotalCycles(), BurnTimerCPUClockspeed);
+	if (nTicks <= 0) {
+		TimerRemove(nTimer);
+		return;
+	}
 
-//	bprintf(PRINT_NORMAL, _T("  - timer %i started, %08X ticks (fires in %lf seconds)\n"), c, nTimerCount[c], period);
+	pTimers[nTimer].nPeriod = nPeriod;
+	TimerSchedule(nTimer, BurnTimerNow() + nTicks);
 }
 
-void BurnOPMTimerCallback(INT32 c, double period)
+// ---------------------------------------------------------------------------
+// Generic timers
+
+// Returns the timer number. It starts stopped, and BurnTimerReset stops it again.
+INT32 BurnTimerAdd(INT32 (*pCallback)(INT32, INT32), INT32 n, INT32 c)
 {
+	return TimerAlloc(pCallback, n, c);
+}
+
+// Fire in nTicks, then every nPeriod ticks (0 = once). nTicks 0 stops the timer.
+void BurnTimerStart(INT32 nTimer, UINT64 nTicks, UINT64 nPeriod)
+{
+	if (nTimer < TIMER_FM_COUNT || nTimer >= nTimerCount) return;
+
 	pCPURunEnd();
-	
-	if (period == 0.0) {
-		nTimerCount[c] = MAX_TIMER_VALUE;
+
+	if (nTicks == 0) {
+		TimerRemove(nTimer);
 		return;
 	}
 
-	nTimerCount[c]  = (INT32)(period * (double)TIMER_TICKS_PER_SECOND);
-	nTimerCount[c] += MAKE_TIMER_TICKS(BurnTimerCPUTotalCycles(), BurnTimerCPUClockspeed);
+	pTimers[nTimer].nPeriod = nPeriod;
+	TimerSchedule(nTimer, BurnTimerNow() + nTicks);
 }
 
-void BurnOPNTimerCallback(INT32  /*n */, INT32 c, INT32 cnt, double stepTime)
+void BurnTimerStop(INT32 nTimer)
 {
-	pCPURunEnd();
-	
-	if (cnt == 0) {
-		nTimerCount[c] = MAX_TIMER_VALUE;
+	if (nTimer < TIMER_FM_COUNT || nTimer >= nTimerCount) return;
 
-//		bprintf(PRINT_NORMAL, _T("  - timer %i stopped\n"), c);
+	TimerRemove(nTimer);
+}
 
-		return;
-	}
+INT32 BurnTimerIsRunning(INT32 nTimer)
+{
+	if (nTimer < 0 || nTimer >= nTimerCount) return 0;
 
-	nTimerCount[c]  = (INT32)(stepTime * cnt * (double)TIMER_TICKS_PER_SECOND);
-	nTimerCount[c] += MAKE_TIMER_TICKS(BurnTimerCPUTotalCycles(), BurnTimerCPUClockspeed);
-//	bprintf(PRINT_NORMAL, _T("  - timer %i started, %08X ticks (fires in %lf seconds)\n"), c, nTimerCount[c], stepTime * cnt);
+	return (pTimers[nTimer].nHeapPos >= 0) ? 1 : 0;
 }
 
-void BurnYMFTimerCallback(INT32 /* n */, INT32 c, double period)
+// ---------------------------------------------------------------------------
+// Update timers
+
+INT32 BurnTimerUpdate(INT32 nCycles)
 {
-	pCPURunEnd();
+	INT32 nIRQStatus = 0;
 
-	if (period == 0.0) {
-		nTimerStart[c] = nTimerCount[c] = MAX_TIMER_VALUE;
+	nTicksTotal = nTicksBase + MAKE_TIMER_TICKS(nCycles, BurnTimerCPUClockspeed);
 
-//		bprintf(PRINT_NORMAL, _T("  - timer %i stopped\n"), c);
+//	bprintf(PRINT_NORMAL, _T(" -- Ticks: %08X, cycles %i\n"), nTicksTotal, nCycles);
 
-		return;
-	}
+	while (nTicksDone < nTicksTotal) {
+		INT64 nTicksSegment = TimerNextExpire();
+		INT32 nCyclesSegment;
 
-	nTimerStart[c]  = nTimerCount[c] = (INT32)(period * (double)(TIMER_TICKS_PER_SECOND / 1000000));
-	nTimerCount[c] += MAKE_TIMER_TICKS(BurnTimerCPUTotalCycles(), BurnTimerCPUClockspeed);
+		if (nTicksSegment > nTicksTotal) {
+			nTicksSegment = nTicksTotal;
+		}
 
-//	bprintf(PRINT_NORMAL, _T("  - timer %i started, %08X ticks (fires in %lf seconds)\n"), c, nTimerCount[c], period);
-}
+		nCyclesSegment = MAKE_CPU_CYLES(nTicksSegment - nTicksBase + nTicksExtra, BurnTimerCPUClockspeed);
+//		bprintf(PRINT_NORMAL, _T("  - Timer: %08X, %08X, %08X, cycles %i, %i\n"), nTicksDone, nTicksSegment, nTicksTotal, nCyclesSegment, BurnTimerCPUTotalCycles());
 
-void BurnYMF262TimerCallback(INT32 /* n */, INT32 c, double period)
-{
-	pCPURunEnd();
+		pCPURun(nCyclesSegment - BurnTimerCPUTotalCycles());
 
-	if (period == 0.0) {
-		nTimerCount[c] = MAX_TIMER_VALUE;
-		return;
-	}
+		nTicksDone = nTicksBase + MAKE_TIMER_TICKS(BurnTimerCPUTotalCycles() + 1, BurnTimerCPUClockspeed) - 1;
+//		bprintf(PRINT_NORMAL, _T("  - ticks done -> %08X cycles -> %i\n"), nTicksDone, BurnTimerCPUTotalCycles());
 
-	nTimerCount[c]  = (INT32)(period * (double)TIMER_TICKS_PER_SECOND);
-	nTimerCount[c] += MAKE_TIMER_TICKS(BurnTimerCPUTotalCycles(), BurnTimerCPUClockspeed);
+		while (TimerNextExpire() <= nTicksDone) {
+			INT32 nTimer = pTimerHeap[0];
+			burn_timer *t = &pTimers[nTimer];
 
-//	bprintf(PRINT_NORMAL, _T("  - timer %i started, %08X ticks (fires in %lf seconds)\n"), c, nTimerCount[c], period);
+			if (t->nPeriod) {
+				TimerSchedule(nTimer, t->nExpire + t->nPeriod);
+			} else {
+				TimerRemove(nTimer);
+			}
+
+//			bprintf(PRINT_NORMAL, _T("  - timer %i fired\n"), nTimer);
+			if (t->pCallback) {
+				nIRQStatus |= t->pCallback(t->nParam[0], t->nParam[1]);
+			}
+		}
+	}
+
+	return nIRQStatus;
 }
 
-void BurnTimerSetRetrig(INT32 c, double period)
+void BurnTimerEndFrame(INT32 nCycles)
 {
-	pCPURunEnd();
-
-	if (period == 0.0) {
-		nTimerStart[c] = nTimerCount[c] = MAX_TIMER_VALUE;
+	BurnTimerUpdate(nCycles);
 
-//		bprintf(PRINT_NORMAL, _T("  - timer %i stopped\n"), c);
+	nTicksBase += MAKE_TIMER_TICKS(nCycles, BurnTimerCPUClockspeed);
 
-		return;
+	if (nTicksDone < nTicksBase) {
+//		bprintf(PRINT_ERROR, _T(" -- ticks done -> %08X\n"), nTicksDone);
+		nTicksDone = nTicksBase;
 	}
-
-	nTimerStart[c]  = nTimerCount[c] = (INT32)(period * (double)(TIMER_TICKS_PER_SECOND));
-	nTimerCount[c] += MAKE_TIMER_TICKS(BurnTimerCPUTotalCycles(), BurnTimerCPUClockspeed);
-
-//	bprintf(PRINT_NORMAL, _T("  - timer %i started, %08X ticks (fires in %lf seconds)\n"), c, nTimerCount[c], period);
 }
 
-void BurnTimerSetOneshot(INT32 c, double period)
+void BurnTimerUpdateEnd()
 {
+//	bprintf(PRINT_NORMAL, _T("  - end %i\n"), BurnTimerCPUTotalCycles());
+
 	pCPURunEnd();
 
-	if (period == 0.0) {
-		nTimerStart[c] = nTimerCount[c] = MAX_TIMER_VALUE;
+	nTicksTotal = 0;
+}
 
-//		bprintf(PRINT_NORMAL, _T("  - timer %i stopped\n"), c);
+INT32 BurnTimerCyclesToNext()
+{
+	INT64 nTicks = TimerNextExpire();
 
-		return;
+	if (nTicks == TIMER_NEVER) {
+		return 0x7fffffff;
+	}
+
+	nTicks -= BurnTimerNow();
+	if (nTicks <= 0) {
+		return 0;
 	}
 
-	nTimerCount[c]  = (INT32)(period * (double)(TIMER_TICKS_PER_SECOND));
-	nTimerCount[c] += MAKE_TIMER_TICKS(BurnTimerCPUTotalCycles(), BurnTimerCPUClockspeed);
+	nTicks = MAKE_CPU_CYLES(nTicks + nTicksExtra, BurnTimerCPUClockspeed);
 
-//	bprintf(PRINT_NORMAL, _T("  - timer %i started, %08X ticks (fires in %lf seconds)\n"), c, nTimerCount[c], period / 1000000.0);
+	return (nTicks < 0x7fffffff) ? (INT32)nTicks : 0x7fffffff;
 }
 
-void BurnTimerSetRetrig(INT32 c, UINT64 timer_ticks)
-{
-	pCPURunEnd();
+// ---------------------------------------------------------------------------
+// Callbacks for the sound cores
 
-	if (timer_ticks == 0) {
-		nTimerStart[c] = nTimerCount[c] = MAX_TIMER_VALUE;
+void BurnOPLTimerCallback(INT32 c, double period)
+{
+	TimerStartFM(c, (INT64)(period * (double)TIMER_TICKS_PER_SECOND), 0);
+}
 
-		// bprintf(PRINT_NORMAL, L"  - timer %i stopped\n", c);
+void BurnOPMTimerCallback(INT32 c, double period)
+{
+	TimerStartFM(c, (INT64)(period * (double)TIMER_TICKS_PER_SECOND), 0);
+}
 
-		return;
-	}
+void BurnOPNTimerCallback(INT32 /*n*/, INT32 c, INT32 cnt, double stepTime)
+{
+	TimerStartFM(c, (INT64)(stepTime * cnt * (double)TIMER_TICKS_PER_SECOND), 0);
+}
 
-	nTimerStart[c] = nTimerCount[c] = (UINT32)(timer_ticks);
-	nTimerCount[c] += MAKE_TIMER_TICKS(BurnTimerCPUTotalCycles(), BurnTimerCPUClockspeed);
+void BurnYMFTimerCallback(INT32 /*n*/, INT32 c, double period)
+{
+	INT64 nTicks = (INT64)(period * (double)(TIMER_TICKS_PER_SECOND / 1000000));
 
-	// bprintf(PRINT_NORMAL, L"  - timer %i started, %08X ticks (fires in %lf seconds)\n", c, nTimerCount[c], (double)(TIMER_TICKS_PER_SECOND) / timer_ticks);
+	TimerStartFM(c, nTicks, nTicks);
 }
 
-void BurnTimerSetOneshot(INT32 c, UINT64 timer_ticks)
+void BurnYMF262TimerCallback(INT32 /*n*/, INT32 c, double period)
 {
-	pCPURunEnd();
+	TimerStartFM(c, (INT64)(period * (double)TIMER_TICKS_PER_SECOND), 0);
+}
 
-	if (timer_ticks == 0) {
-		nTimerStart[c] = nTimerCount[c] = MAX_TIMER_VALUE;
+void BurnTimerSetRetrig(INT32 c, double period)
+{
+	INT64 nTicks = (INT64)(period * (double)(TIMER_TICKS_PER_SECOND));
 
-		// bprintf(PRINT_NORMAL, L"  - timer %i stopped\n", c);
+	TimerStartFM(c, nTicks, nTicks);
+}
 
-		return;
-	}
+void BurnTimerSetOneshot(INT32 c, double period)
+{
+	TimerStartFM(c, (INT64)(period * (double)(TIMER_TICKS_PER_SECOND)), 0);
+}
 
-	nTimerCount[c] = (UINT32)(timer_ticks);
-	nTimerCount[c] += MAKE_TIMER_TICKS(BurnTimerCPUTotalCycles(), BurnTimerCPUClockspeed);
+void BurnTimerSetRetrig(INT32 c, UINT64 timer_ticks)
+{
+	TimerStartFM(c, timer_ticks, timer_ticks);
+}
 
-	// bprintf(PRINT_NORMAL, L"  - timer %i started, %08X ticks (fires in %lf seconds)\n", c, nTimerCount[c], (double)(TIMER_TICKS_PER_SECOND) / timer_ticks);
+void BurnTimerSetOneshot(INT32 c, UINT64 timer_ticks)
+{
+	TimerStartFM(c, timer_ticks, 0);
 }
 
 // ------------------------------------ ---------------------------------------
@@ -289,16 +368,38 @@ void BurnTimerSetOneshot(INT32 c, UINT64 timer_ticks)
 
 void BurnTimerScan(INT32 nAction, INT32* pnMin)
 {
-	if (pnMin && *pnMin < 0x029521) {
-		*pnMin = 0x029521;
+	if (pnMin && *pnMin < 0x029744) {
+		*pnMin = 0x029744;
 	}
 
 	if (nAction & ACB_DRIVER_DATA) {
-		SCAN_VAR(nTimerCount);
-		SCAN_VAR(nTimerStart);
+		SCAN_VAR(nTicksBase);
 		SCAN_VAR(dTime);
 
 		SCAN_VAR(nTicksDone);
+
+		for (INT32 i = 0; i < nTimerCount; i++) {
+			INT32 nRunning = (pTimers[i].nHeapPos >= 0) ? 1 : 0;
+
+			SCAN_VAR(pTimers[i].nExpire);
+			SCAN_VAR(pTimers[i].nPeriod);
+			SCAN_VAR(nRunning);
+
+			if (nAction & ACB_WRITE) {
+				pTimers[i].nHeapPos = nRunning ? 0 : -1;
+			}
+		}
+
+		if (nAction & ACB_WRITE) {
+			// rebuild the heap from the loaded timers
+			nTimerHeapCount = 0;
+			for (INT32 i = 0; i < nTimerCount; i++) {
+				if (pTimers[i].nHeapPos < 0) continue;
+
+				pTimers[i].nHeapPos = -1;
+				TimerSchedule(i, pTimers[i].nExpire);
+			}
+		}
 	}
 }
 
@@ -309,16 +410,31 @@ void BurnTimerExit()
 	pCPURun = NULL;
 	pCPURunEnd = NULL;
 
+	if (pTimers) {
+		free(pTimers);
+		pTimers = NULL;
+	}
+	if (pTimerHeap) {
+		free(pTimerHeap);
+		pTimerHeap = NULL;
+	}
+	nTimerCount = nTimerAlloc = nTimerHeapCount = 0;
+
 	return;
 }
 
 void BurnTimerReset()
 {
-	nTimerCount[0] = nTimerCount[1] = MAX_TIMER_VALUE;
-	nTimerStart[0] = nTimerStart[1] = MAX_TIMER_VALUE;
+	for (INT32 i = 0; i < nTimerCount; i++) {
+		pTimers[i].nExpire = TIMER_NEVER;
+		pTimers[i].nPeriod = 0;
+		pTimers[i].nHeapPos = -1;
+	}
+	nTimerHeapCount = 0;
 
 	dTime = 0.0;
 
+	nTicksBase = 0;
 	nTicksDone = 0;
 }
 
@@ -329,6 +445,10 @@ INT32 BurnTimerInit(INT32 (*pOverCallback)(INT32, INT32), double (*pTimeCallback
 	pTimerOverCallback = pOverCallback;
 	pTimerTimeCallback = pTimeCallback ? pTimeCallback : BurnTimerTimeCallbackDummy;
 
+	for (INT32 c = 0; c < TIMER_FM_COUNT; c++) {
+		TimerAlloc(pTimerOverCallback, 0, c);
+	}
+
 	BurnTimerReset();
 
 	return 0;
@@ -20,6 +20,15 @@ void BurnTimerSetOneshot(INT32 c, double period);						// period in  s
 void BurnTimerSetRetrig(INT32 c, UINT64 timer_ticks);
 void BurnTimerSetOneshot(INT32 c, UINT64 timer_ticks);
 
+// Generic timers (times in timer ticks, nPeriod 0 = one-shot), pCallback(n, c) is called when it fires
+INT32 BurnTimerAdd(INT32 (*pCallback)(INT32, INT32), INT32 n, INT32 c);
+void BurnTimerStart(INT32 nTimer, UINT64 nTicks, UINT64 nPeriod);
+void BurnTimerStop(INT32 nTimer);
+INT32 BurnTimerIsRunning(INT32 nTimer);
+
+// Cycles the attached cpu can run before the next timer fires (see burn_sched.cpp)
+INT32 BurnTimerCyclesToNext();
+
 extern double dTime;
 
 void BurnTimerExit();
@@ -195,6 +195,12 @@ INT32 BurnStateUNDO(TCHAR* szName);
 INT32 BurnStateCompress(UINT8** pDef, INT32* pnDefLen, INT32 bAll);
 INT32 BurnStateDecompress(UINT8* Def, INT32 nDefLen, INT32 bAll);
 
+// statedelta.cpp
+INT32 BurnStateDeltaInit();
+void BurnStateDeltaExit();
+INT32 BurnStateDeltaPush();
+INT32 BurnStateDeltaRestore();
+
 // zipfn.cpp
 struct ZipEntry { char* szName;	UINT32 nLen; UINT32 nCrc; };
 
@@ -202,6 +208,8 @@ INT32 ZipOpen(char* szZip);
 INT32 ZipClose();
 INT32 ZipGetList(struct ZipEntry** pList, INT32* pnListCount);
 INT32 ZipLoadFile(UINT8* Dest, INT32 nLen, INT32* pnWrote, INT32 nEntry);
+INT32 ZipMapFile(UINT8** ppData, INT32* pnLen, INT32 nEntry);
+void ZipUnmapAll();
 INT32 __cdecl ZipLoadOneFile(char* arcName, const char* fileName, void** Dest, INT32* pnWrote);
 
 // bzip.cpp
@@ -1,5 +1,6 @@
 #include <vector>
 #include <string>
+#include <algorithm>
 #include <sys/types.h>
 #include <sys/stat.h>
 
@@ -16,6 +17,25 @@
 
 #include <streams/file_stream.h>
 
+#include "unzip.h"
+#ifdef INCLUDE_7Z_SUPPORT
+#include "un7z.h"
+#endif
+
+#ifdef HAVE_THREADS
+// retro_miscellaneous.h (pulled in by rthreads.h) tests "#elif PS2", give it a value
+#ifndef PS2
+#define PS2 0
+#define FBA_UNDEF_PS2
+#endif
+#include <rthreads/rthreads.h>
+#ifdef FBA_UNDEF_PS2
+#undef PS2
+#undef FBA_UNDEF_PS2
+#endif
+#include <features/features_cpu.h>
+#endif
+
 #define FBA_VERSION "v0.2.97.44"
 
 static void log_dummy(enum retro_log_level level, const char *fmt, ...) { }
@@ -80,6 +100,9 @@ struct ROMFIND
 	int nArchive;
 	int nPos;
 	BurnRomInfo ri;
+	UINT8 *pPrefetch;	// Decompressed ahead of BurnDrvInit, see archive_prefetch()
+	int nPrefetchLen;
+	uLong nPrefetchOffset;	// Entry in the zip's central directory (unzSetOffset)
 };
 
 static std::vector<std::string> g_find_list_path;
@@ -89,6 +112,7 @@ static unsigned g_rom_count;
 INT32 nAudSegLen = 0;
 
 static UINT8* pVidImage = NULL;
+static INT32 nVidImageSize = 0;		// One frame, pVidImage has room for two (threaded video)
 static int16_t *g_audio_buf;
 
 // Mapping of PC inputs to game inputs
@@ -475,6 +499,334 @@ static void ForceFrameStep(int bDraw)
 	BurnDrvFrame();
 }
 
+static bool bRunAheadActive = false;
+
+// Emulate the real frame hidden, keep its state, then run nRunAheadFrames more
+// with sound discarded and present the last one before rolling back. The game
+// reacts to input on the very frame it is shown instead of a few frames later.
+static void RunAheadFrameStep(int bDraw)
+{
+	UINT8* pDraw = pBurnDraw;
+
+	if (!bRunAheadActive) {
+		if (BurnStateDeltaInit()) {
+			ForceFrameStep(bDraw);
+			return;
+		}
+		bRunAheadActive = true;
+	}
+
+	// The real frame, its sound is the one sent to the frontend
+	ForceFrameStep(0);
+
+	if (BurnStateDeltaPush()) {
+		log_cb(RETRO_LOG_ERROR, "[FBA] Run-ahead can't snapshot this driver, disabling it.\n");
+		BurnStateDeltaExit();
+		bRunAheadActive = false;
+		nRunAheadFrames = 0;
+		return;
+	}
+
+	UINT32 nRealFrame = nCurrentFrame;
+	INT16* pSoundOut = pBurnSoundOut;
+	pBurnSoundOut = NULL;
+
+	for (UINT32 i = 1; i < nRunAheadFrames; i++)
+		ForceFrameStep(0);
+
+	pBurnDraw = pDraw;
+	ForceFrameStep(bDraw);
+
+	pBurnSoundOut = pSoundOut;
+	BurnStateDeltaRestore();
+	BurnRecalcPal();
+	nCurrentFrame = nRealFrame;
+}
+
+static void RunAheadExit()
+{
+	if (bRunAheadActive) {
+		BurnStateDeltaExit();
+		bRunAheadActive = false;
+	}
+}
+
+#ifdef HAVE_THREADS
+// Threaded video: BurnTransferCopy() only snapshots the frame (bBurnTransferDeferred)
+// and a worker converts it into one half of pVidImage while the next frame is
+// emulated into the other half. What is shown is always one frame behind.
+static sthread_t *video_thread = NULL;
+static slock_t *video_lock = NULL;
+static scond_t *video_cond = NULL;
+static int video_job = -1;				// Snapshot slot the worker has to convert
+static bool video_quit = false;
+static int video_buffer = 0;			// Half of pVidImage the next frame is drawn into
+static UINT8 *video_shown = NULL;		// Last complete frame
+
+static void video_thread_func(void *)
+{
+	slock_lock(video_lock);
+	for (;;) {
+		while (video_job < 0 && !video_quit)
+			scond_wait(video_cond, video_lock);
+		if (video_job < 0)
+			break;
+
+		int slot = video_job;
+		slock_unlock(video_lock);
+		BurnTransferDeferredFlush(slot);
+		slock_lock(video_lock);
+
+		video_job = -1;
+		scond_broadcast(video_cond);
+	}
+	slock_unlock(video_lock);
+}
+
+static void video_thread_wait()
+{
+	slock_lock(video_lock);
+	while (video_job >= 0)
+		scond_wait(video_cond, video_lock);
+	slock_unlock(video_lock);
+}
+
+static void video_thread_exit()
+{
+	if (!video_thread)
+		return;
+
+	slock_lock(video_lock);
+	video_quit = true;
+	scond_broadcast(video_cond);
+	slock_unlock(video_lock);
+	sthread_join(video_thread);
+
+	scond_free(video_cond);
+	slock_free(video_lock);
+	video_thread = NULL;
+	video_cond = NULL;
+	video_lock = NULL;
+
+	bBurnTransferDeferred = false;
+}
+
+static void video_thread_init()
+{
+	video_lock = slock_new();
+	video_cond = scond_new();
+	video_job = -1;
+	video_quit = false;
+	video_buffer = 0;
+	video_shown = NULL;
+
+	if (video_lock && video_cond)
+		video_thread = sthread_create(video_thread_func, NULL);
+
+	if (!video_thread) {
+		log_cb(RETRO_LOG_ERROR, "[FBA] Can't start the video thread, drawing on the main thread.\n");
+		if (video_cond)
+			scond_free(video_cond);
+		if (video_lock)
+			slock_free(video_lock);
+		video_cond = NULL;
+		video_lock = NULL;
+		bVideoThreaded = false;
+		return;
+	}
+
+	bBurnTransferDeferred = true;
+}
+
+// Pick the half of pVidImage to draw into, starting or stopping the worker if the option changed
+static void video_thread_frame_begin()
+{
+	if (bVideoThreaded && !video_thread && pVidImage)
+		video_thread_init();
+	else if (!bVideoThreaded && video_thread)
+		video_thread_exit();
+
+	if (video_thread)
+		pBurnDraw = pVidImage + video_buffer * nVidImageSize;
+}
+
+// Hand the frame to the worker and return the one to show
+static UINT8 *video_thread_frame_end()
+{
+	UINT8 *drawn = pVidImage + video_buffer * nVidImageSize;
+	int slot = BurnTransferDeferredTake();
+
+	video_thread_wait();
+
+	if (slot >= 0) {
+		UINT8 *show = video_shown;
+
+		slock_lock(video_lock);
+		video_job = slot;
+		scond_broadcast(video_cond);
+		slock_unlock(video_lock);
+
+		if (!show) {
+			// Nothing older to show yet
+			video_thread_wait();
+			show = drawn;
+		}
+
+		video_shown = drawn;
+		video_buffer ^= 1;
+		return show;
+	}
+
+	if (pBurnDraw) {
+		// The driver drew straight into pBurnDraw
+		video_shown = drawn;
+		video_buffer ^= 1;
+		return drawn;
+	}
+
+	return video_shown ? video_shown : drawn;
+}
+#endif
+
+#ifdef HAVE_THREADS
+// Parallel drawing: workers for BurnExtParallelFor(). Drivers that support it
+// split their rendering into a few independent tasks per call, which are handed
+// out one at a time to the workers and to the emulation thread itself.
+#define PARALLEL_MAX_THREADS 7
+
+static sthread_t *parallel_thread[PARALLEL_MAX_THREADS];
+static unsigned parallel_threads = 0;
+static slock_t *parallel_lock = NULL;
+static scond_t *parallel_cond = NULL;		// Work to do, or quit
+static scond_t *parallel_done = NULL;		// Last task of the call finished
+static void (*parallel_task)(void *, INT32) = NULL;
+static void *parallel_param = NULL;
+static INT32 parallel_count = 0;			// Tasks in the current call
+static INT32 parallel_next = 0;				// Next task to hand out
+static INT32 parallel_pending = 0;			// Tasks not finished yet
+static bool parallel_quit = false;
+
+// Run tasks until none are left to hand out, called with parallel_lock held
+static void parallel_run_tasks()
+{
+	while (parallel_next < parallel_count) {
+		INT32 i = parallel_next++;
+
+		slock_unlock(parallel_lock);
+		parallel_task(parallel_param, i);
+		slock_lock(parallel_lock);
+
+		if (--parallel_pending == 0)
+			scond_broadcast(parallel_done);
+	}
+}
+
+static void parallel_thread_func(void *)
+{
+	slock_lock(parallel_lock);
+	while (!parallel_quit) {
+		if (parallel_next < parallel_count)
+			parallel_run_tasks();
+		else
+			scond_wait(parallel_cond, parallel_lock);
+	}
+	slock_unlock(parallel_lock);
+}
+
+static void parallel_for(void (*pTask)(void *, INT32), void *pParam, INT32 nCount)
+{
+	slock_lock(parallel_lock);
+	parallel_task = pTask;
+	parallel_param = pParam;
+	parallel_count = nCount;
+	parallel_next = 0;
+	parallel_pending = nCount;
+	scond_broadcast(parallel_cond);
+
+	parallel_run_tasks();
+	while (parallel_pending > 0)
+		scond_wait(parallel_done, parallel_lock);
+
+	parallel_count = 0;
+	parallel_next = 0;
+	slock_unlock(parallel_lock);
+}
+
+static void parallel_exit()
+{
+	BurnExtParallelFor = NULL;
+
+	if (!parallel_lock)
+		return;
+
+	slock_lock(parallel_lock);
+	parallel_quit = true;
+	scond_broadcast(parallel_cond);
+	slock_unlock(parallel_lock);
+
+	for (unsigned i = 0; i < parallel_threads; i++)
+		sthread_join(parallel_thread[i]);
+	parallel_threads = 0;
+
+	if (parallel_done)
+		scond_free(parallel_done);
+	if (parallel_cond)
+		scond_free(parallel_cond);
+	slock_free(parallel_lock);
+	parallel_done = NULL;
+	parallel_cond = NULL;
+	parallel_lock = NULL;
+}
+
+static void parallel_init()
+{
+	unsigned threads = cpu_features_get_core_amount();
+
+	// The emulation thread works through the tasks as well
+	threads = (threads > 1) ? threads - 1 : 0;
+	if (threads > PARALLEL_MAX_THREADS)
+		threads = PARALLEL_MAX_THREADS;
+	if (threads == 0) {
+		bVideoParallel = false;
+		return;
+	}
+
+	parallel_lock = slock_new();
+	parallel_cond = scond_new();
+	parallel_done = scond_new();
+	parallel_count = 0;
+	parallel_next = 0;
+	parallel_pending = 0;
+	parallel_quit = false;
+
+	if (parallel_lock && parallel_cond && parallel_done) {
+		for (unsigned i = 0; i < threads; i++) {
+			parallel_thread[parallel_threads] = sthread_create(parallel_thread_func, NULL);
+			if (parallel_thread[parallel_threads])
+				parallel_threads++;
+		}
+	}
+
+	if (!parallel_threads) {
+		log_cb(RETRO_LOG_ERROR, "[FBA] Can't start the drawing threads, drawing on the main thread.\n");
+		parallel_exit();
+		bVideoParallel = false;
+		return;
+	}
+
+	BurnExtParallelFor = parallel_for;
+}
+
+// Start or stop the workers if the option changed
+static void parallel_frame_begin()
+{
+	if (bVideoParallel && !parallel_lock)
+		parallel_init();
+	else if (!bVideoParallel && parallel_lock)
+		parallel_exit();
+}
+#endif
+
 // Non-idiomatic (OutString should be to the left to match strcpy())
 // Seems broken to not check nOutSize.
 char* TCHARToANSI(const TCHAR* pszInString, char* pszOutString, int /*nOutSize*/)
@@ -554,26 +906,577 @@ static void free_archive_list(ZipEntry *list, unsigned count)
    }
 }
 
+// Archive index cache
+//
+// Listing an archive means opening it and reading its whole directory (or the
+// header database of a 7z), for every archive of the set, every time a game
+// is started. The lists are kept in fba/romindex.dat in the system directory,
+// keyed by path, size and modification time, so unchanged archives are never
+// opened just to find out what is in them.
+
+struct ArchiveIndexEntry
+{
+   std::string name;
+   UINT32 nLen;
+   UINT32 nCrc;
+};
+
+struct ArchiveIndex
+{
+   std::string path;
+   INT64 nSize;
+   INT64 nTime;
+   std::vector<ArchiveIndexEntry> entries;
+};
+
+static std::vector<ArchiveIndex> g_archive_index;
+static bool g_archive_index_loaded = false;
+static bool g_archive_index_dirty = false;
+
+// false if the path doesn't fit, the index isn't kept on disk then
+static bool archive_index_path(char *path, size_t size)
+{
+   int len = snprintf(path, size, "%s%cfba%cromindex.dat", g_system_dir, path_default_slash_c(), path_default_slash_c());
+
+   return len >= 0 && (size_t)len < size;
+}
+
+// Size and time of the file ZipOpen would pick for this archive
+static bool archive_stat(const char *archive, INT64 *size, INT64 *time)
+{
+   static const char *ext[] = { ".zip", ".7z" };
+   char path[MAX_PATH];
+
+   for (unsigned i = 0; i < sizeof(ext) / sizeof(ext[0]); i++)
+   {
+      struct stat st;
+      snprintf(path, sizeof(path), "%s%s", archive, ext[i]);
+      if (stat(path, &st) == 0)
+      {
+         *size = st.st_size;
+         *time = st.st_mtime;
+         return true;
+      }
+   }
+
+   return false;
+}
+
+static void archive_index_load()
+{
+   char path[MAX_PATH];
+   char line[MAX_PATH + 64];
+
+   g_archive_index_loaded = true;
+   g_archive_index.clear();
+
+   if (!archive_index_path(path, sizeof(path)))
+      return;
+
+   FILE *fp = fopen(path, "rb");
+   if (fp == NULL)
+      return;
+
+   while (fgets(line, sizeof(line), fp))
+   {
+      line[strcspn(line, "\r\n")] = '\0';
+
+      if (line[0] == 'A' && line[1] == ' ')
+      {
+         ArchiveIndex index;
+         long long size = 0, time = 0;
+         int name = 0;
+         if (sscanf(line + 2, "%lld %lld %n", &size, &time, &name) < 2 || name == 0)
+            break;
+         index.path = line + 2 + name;
+         index.nSize = size;
+         index.nTime = time;
+         g_archive_index.push_back(index);
+      }
+      else if (line[0] == 'E' && line[1] == ' ' && !g_archive_index.empty())
+      {
+         ArchiveIndexEntry entry;
+         unsigned int crc = 0, len = 0;
+         int name = 0;
+         if (sscanf(line + 2, "%x %u %n", &crc, &len, &name) < 2 || name == 0)
+            break;
+         entry.name = line + 2 + name;
+         entry.nCrc = crc;
+         entry.nLen = len;
+         g_archive_index.back().entries.push_back(entry);
+      }
+   }
+
+   fclose(fp);
+}
+
+static void archive_index_save()
+{
+   char path[MAX_PATH];
+
+   if (!g_archive_index_dirty)
+      return;
+
+   g_archive_index_dirty = false;
+
+   if (!archive_index_path(path, sizeof(path)))
+      return;
+
+   FILE *fp = fopen(path, "wb");
+   if (fp == NULL)
+      return;
+
+   for (unsigned i = 0; i < g_archive_index.size(); i++)
+   {
+      const ArchiveIndex &index = g_archive_index[i];
+      fprintf(fp, "A %lld %lld %s\n", (long long)index.nSize, (long long)index.nTime, index.path.c_str());
+      for (unsigned j = 0; j < index.entries.size(); j++)
+         fprintf(fp, "E %08x %u %s\n", index.entries[j].nCrc, index.entries[j].nLen, index.entries[j].name.c_str());
+   }
+
+   fclose(fp);
+}
+
+// Index entry for an archive that hasn't changed since it was listed
+static ArchiveIndex *archive_index_find(const char *archive)
+{
+   INT64 size, time;
+
+   if (!g_archive_index_loaded)
+      archive_index_load();
+
+   for (unsigned i = 0; i < g_archive_index.size(); i++)
+   {
+      if (g_archive_index[i].path == archive)
+      {
+         if (archive_stat(archive, &size, &time) && size == g_archive_index[i].nSize && time == g_archive_index[i].nTime)
+            return &g_archive_index[i];
+         return NULL;
+      }
+   }
+
+   return NULL;
+}
+
+// Same as ZipOpen + ZipGetList, from the index when possible
+static int archive_get_list(const char *archive, ZipEntry **list, int *count)
+{
+   ArchiveIndex *index = archive_index_find(archive);
+
+   if (index == NULL)
+   {
+      if (ZipOpen((char*)archive) != 0)
+         return 1;
+
+      if (ZipGetList(list, count) != 0)
+         return 1;
+
+      ArchiveIndex entry;
+      entry.path = archive;
+      if (!archive_stat(archive, &entry.nSize, &entry.nTime))
+         return 0;
+
+      for (int i = 0; i < *count; i++)
+      {
+         ArchiveIndexEntry file;
+         file.name = (*list)[i].szName ? (*list)[i].szName : "";
+         file.nLen = (*list)[i].nLen;
+         file.nCrc = (*list)[i].nCrc;
+         entry.entries.push_back(file);
+      }
+
+      for (unsigned i = 0; i < g_archive_index.size(); i++)
+      {
+         if (g_archive_index[i].path == archive)
+         {
+            g_archive_index.erase(g_archive_index.begin() + i);
+            break;
+         }
+      }
+      g_archive_index.push_back(entry);
+      g_archive_index_dirty = true;
+
+      return 0;
+   }
+
+   *count = index->entries.size();
+   *list = (ZipEntry*)calloc(*count ? *count : 1, sizeof(ZipEntry));
+   if (*list == NULL)
+      return 1;
+
+   for (int i = 0; i < *count; i++)
+   {
+      (*list)[i].szName = strdup(index->entries[i].name.c_str());
+      (*list)[i].nLen = index->entries[i].nLen;
+      (*list)[i].nCrc = index->entries[i].nCrc;
+   }
+
+   return 0;
+}
+
+// Parallel rom prefetch
+//
+// Inflating the roms one after the other from BurnDrvInit keeps one core busy
+// for seconds on the big sets. Instead, what the driver is going to ask for is
+// decompressed up front by a few worker threads and archive_load_rom just hands
+// over the buffers. The zips' central directories are read once, each worker then
+// opens an archive only once and seeks straight to the entries it inflates.
+// Files stored uncompressed are left alone (they are mapped instead, see
+// ZipMapFile), and a 7z archive is always decoded by a single worker since its
+// files usually share one solid block.
+//
+// Everything prefetched is held until the driver copies it into its own buffers,
+// so at most PREFETCH_MAX_BYTES are prefetched, the rest is loaded on demand.
+
+#ifdef HAVE_THREADS
+
+#define PREFETCH_MAX_THREADS 8
+#define PREFETCH_MAX_BYTES ((INT64)256 << 20)
+
+struct PrefetchJob
+{
+   int nArchive;
+   bool b7z;
+   std::vector<int> roms;
+   INT64 nSize;
+};
+
+static std::vector<PrefetchJob> g_prefetch_jobs;
+static unsigned g_prefetch_next;
+static slock_t *g_prefetch_lock;
+
+static bool prefetch_job_larger(const PrefetchJob &a, const PrefetchJob &b)
+{
+   return a.nSize > b.nSize;
+}
+
+static void archive_prefetch_zip(unzFile zip, int rom)
+{
+   ROMFIND *find = &g_find_list[rom];
+
+   if (unzSetOffset(zip, find->nPrefetchOffset) != UNZ_OK)
+      return;
+
+   UINT8 *data = (UINT8*)malloc(find->ri.nLen);
+   if (data == NULL)
+      return;
+   memset(data, 0, find->ri.nLen);
+
+   if (unzOpenCurrentFile(zip) != UNZ_OK)
+   {
+      free(data);
+      return;
+   }
+
+   int wrote = unzReadCurrentFile(zip, data, find->ri.nLen);
+   if (unzCloseCurrentFile(zip) != UNZ_OK || wrote < 0)
+   {
+      free(data);
+      return;
+   }
+
+   find->nPrefetchLen = wrote;
+   find->pPrefetch = data;
+}
+
+#ifdef INCLUDE_7Z_SUPPORT
+static void archive_prefetch_7z(_7z_file *archive, int rom)
+{
+   ROMFIND *find = &g_find_list[rom];
+
+   UINT8 *data = (UINT8*)malloc(find->ri.nLen);
+   if (data == NULL)
+      return;
+   memset(data, 0, find->ri.nLen);
+
+   UINT32 wrote = 0;
+   archive->curr_file_idx = find->nPos;
+   if (_7z_file_decompress(archive, data, find->ri.nLen, &wrote) != _7ZERR_NONE
+      || crc32(0, data, wrote) != archive->db.CRCs.Vals[find->nPos])
+   {
+      free(data);
+      return;
+   }
+
+   find->nPrefetchLen = wrote;
+   find->pPrefetch = data;
+}
+#endif
+
+static void archive_prefetch_thread(void *)
+{
+   char path[MAX_PATH];
+
+   // One handle per archive, opened the first time this worker needs it
+   std::vector<unzFile> zips(g_find_list_path.size(), (unzFile)NULL);
+
+   for (;;)
+   {
+      slock_lock(g_prefetch_lock);
+      unsigned job = g_prefetch_next++;
+      slock_unlock(g_prefetch_lock);
+
+      if (job >= g_prefetch_jobs.size())
+         break;
+
+      PrefetchJob *pJob = &g_prefetch_jobs[job];
+
+      if (!pJob->b7z)
+      {
+         unzFile &zip = zips[pJob->nArchive];
+         if (zip == NULL)
+         {
+            snprintf(path, sizeof(path), "%s.zip", g_find_list_path[pJob->nArchive].c_str());
+            zip = unzOpen(path);
+            if (zip == NULL)
+               continue;
+         }
+
+         for (unsigned i = 0; i < pJob->roms.size(); i++)
+            archive_prefetch_zip(zip, pJob->roms[i]);
+      }
+#ifdef INCLUDE_7Z_SUPPORT
+      else
+      {
+         // _7z_file_open/_7z_file_close share a cache of open files
+         _7z_file *archive = NULL;
+
+         snprintf(path, sizeof(path), "%s.7z", g_find_list_path[pJob->nArchive].c_str());
+         slock_lock(g_prefetch_lock);
+         _7z_error err = _7z_file_open(path, &archive);
+         slock_unlock(g_prefetch_lock);
+         if (err != _7ZERR_NONE)
+            continue;
+
+         for (unsigned i = 0; i < pJob->roms.size(); i++)
+            archive_prefetch_7z(archive, pJob->roms[i]);
+
+         slock_lock(g_prefetch_lock);
+         _7z_file_close(archive);
+         slock_unlock(g_prefetch_lock);
+      }
+#endif
+   }
+
+   for (unsigned i = 0; i < zips.size(); i++)
+      if (zips[i])
+         unzClose(zips[i]);
+}
+
+// Find the central directory entries of the compressed roms in a zip, in one pass
+static void archive_prefetch_index_zip(const char *path, std::vector<int> &roms)
+{
+   std::vector<int> compressed;
+
+   unzFile zip = unzOpen(path);
+   if (zip == NULL)
+   {
+      roms.clear();
+      return;
+   }
+
+   int entry = 0;
+   for (int err = unzGoToFirstFile(zip); err == UNZ_OK; err = unzGoToNextFile(zip), entry++)
+   {
+      for (unsigned i = 0; i < roms.size(); i++)
+      {
+         ROMFIND *find = &g_find_list[roms[i]];
+         if (find->nPos != entry)
+            continue;
+
+         unz_file_info info;
+         if (unzGetCurrentFileInfo(zip, &info, NULL, 0, NULL, 0, NULL, 0) != UNZ_OK || info.compression_method == 0)
+            continue;
+
+         find->nPrefetchOffset = unzGetOffset(zip);
+         compressed.push_back(roms[i]);
+      }
+   }
+
+   unzClose(zip);
+   roms.swap(compressed);
+}
+
+static void archive_prefetch()
+{
+   char path[MAX_PATH];
+
+   unsigned threads = cpu_features_get_core_amount();
+   if (threads > PREFETCH_MAX_THREADS)
+      threads = PREFETCH_MAX_THREADS;
+   if (threads < 2)
+      return;
+
+   g_prefetch_jobs.clear();
+
+   for (unsigned z = 0; z < g_find_list_path.size(); z++)
+   {
+      // Same lookup order as ZipOpen
+      snprintf(path, sizeof(path), "%s.zip", g_find_list_path[z].c_str());
+      bool b7z = !path_is_valid(path);
+#ifndef INCLUDE_7Z_SUPPORT
+      if (b7z)
+         continue;
+#endif
+
+      PrefetchJob job;
+      job.nArchive = z;
+      job.b7z = b7z;
+      job.nSize = 0;
+
+      for (unsigned i = 0; i < g_rom_count; i++)
+      {
+         ROMFIND *find = &g_find_list[i];
+
+         // Optional roms (mostly alternative bioses) are left to be loaded on demand
+         if (find->nState == STAT_NOFIND || find->nArchive != (int)z)
+            continue;
+         if (find->ri.nType == 0 || find->ri.nLen == 0 || find->ri.nCrc == 0 || (find->ri.nType & BRF_OPT))
+            continue;
+
+         job.roms.push_back(i);
+         job.nSize += find->ri.nLen;
+      }
+
+      if (job.roms.empty())
+         continue;
+
+      if (b7z)
+      {
+         g_prefetch_jobs.push_back(job);
+         continue;
+      }
+
+      // Zip entries are inflated independently, one job each
+      archive_prefetch_index_zip(path, job.roms);
+
+      for (unsigned i = 0; i < job.roms.size(); i++)
+      {
+         PrefetchJob rom = job;
+         rom.roms.assign(1, job.roms[i]);
+         rom.nSize = g_find_list[job.roms[i]].ri.nLen;
+         g_prefetch_jobs.push_back(rom);
+      }
+   }
+
+   // Biggest first, so the last job to finish is a short one
+   std::stable_sort(g_prefetch_jobs.begin(), g_prefetch_jobs.end(), prefetch_job_larger);
+
+   // Keep what is held at once within the budget
+   INT64 total = 0;
+   std::vector<PrefetchJob> jobs;
+   for (unsigned i = 0; i < g_prefetch_jobs.size(); i++)
+   {
+      if (total + g_prefetch_jobs[i].nSize > PREFETCH_MAX_BYTES)
+         continue;
+
+      total += g_prefetch_jobs[i].nSize;
+      jobs.push_back(g_prefetch_jobs[i]);
+   }
+   g_prefetch_jobs.swap(jobs);
+
+   if (g_prefetch_jobs.size() < 2)
+   {
+      g_prefetch_jobs.clear();
+      return;
+   }
+
+   if (threads > g_prefetch_jobs.size())
+      threads = g_prefetch_jobs.size();
+
+   g_prefetch_next = 0;
+   g_prefetch_lock = slock_new();
+   if (g_prefetch_lock == NULL)
+      return;
+
+   std::vector<sthread_t*> workers;
+   for (unsigned i = 0; i < threads; i++)
+   {
+      sthread_t *thread = sthread_create(archive_prefetch_thread, NULL);
+      if (thread)
+         workers.push_back(thread);
+   }
+
+   // Make sure the work gets done even if no thread could be started
+   if (workers.empty())
+      archive_prefetch_thread(NULL);
+
+   for (unsigned i = 0; i < workers.size(); i++)
+      sthread_join(workers[i]);
+
+   slock_free(g_prefetch_lock);
+   g_prefetch_lock = NULL;
+   g_prefetch_jobs.clear();
+}
+
+#endif
+
+// Drop whatever the driver didn't load
+static void archive_prefetch_free()
+{
+   for (unsigned i = 0; i < g_rom_count; i++)
+   {
+      if (g_find_list[i].pPrefetch)
+      {
+         free(g_find_list[i].pPrefetch);
+         g_find_list[i].pPrefetch = NULL;
+      }
+   }
+}
+
 static int archive_load_rom(uint8_t *dest, int *wrote, int i)
 {
    if (i < 0 || i >= g_rom_count)
       return 1;
 
+   BurnRomInfo ri = {0};
+   BurnDrvGetRomInfo(&ri, i);
+
+   // Already decompressed, only the first load can use it
+   if (g_find_list[i].pPrefetch)
+   {
+      int len = g_find_list[i].nPrefetchLen;
+      if (len > (int)ri.nLen)
+         len = ri.nLen;
+
+      memcpy(dest, g_find_list[i].pPrefetch, len);
+      if (wrote)
+         *wrote = len;
+
+      free(g_find_list[i].pPrefetch);
+      g_find_list[i].pPrefetch = NULL;
+
+      return 0;
+   }
+
    int archive = g_find_list[i].nArchive;
 
    if (ZipOpen((char*)g_find_list_path[archive].c_str()) != 0)
       return 1;
 
-   BurnRomInfo ri = {0};
-   BurnDrvGetRomInfo(&ri, i);
-
    if (ZipLoadFile(dest, ri.nLen, wrote, g_find_list[i].nPos) != 0)
    {
       ZipClose();
       return 1;
    }
 
-   ZipClose();
+   // The archive stays open for the next rom, it's closed once the driver is initialized
+   return 0;
+}
+
+static int archive_map_rom(uint8_t **data, int *len, int i)
+{
+   if (i < 0 || i >= g_rom_count)
+      return 1;
+
+   int archive = g_find_list[i].nArchive;
+
+   if (ZipOpen((char*)g_find_list_path[archive].c_str()) != 0)
+      return 1;
+
+   if (ZipMapFile(data, len, g_find_list[i].nPos) != 0)
+      return 1;
+
    return 0;
 }
 
@@ -583,21 +1486,21 @@ static void locate_archive(std::vector<std::string>& pathList, const char* const
 
 	// Search rom dir
 	snprintf(path, sizeof(path), "%s%c%s", g_rom_dir, path_default_slash_c(), romName);
-	if (ZipOpen(path) == 0)
+	if (archive_index_find(path) || ZipOpen(path) == 0)
 	{
 		g_find_list_path.push_back(path);
 		return;
 	}
 	// Search system fba subdirectory (where samples/hiscore are stored)
 	snprintf(path, sizeof(path), "%s%cfba%c%s", g_system_dir, path_default_slash_c(), path_default_slash_c(), romName);
-	if (ZipOpen(path) == 0)
+	if (archive_index_find(path) || ZipOpen(path) == 0)
 	{
 		g_find_list_path.push_back(path);
 		return;
 	}
 	// Search system directory
 	snprintf(path, sizeof(path), "%s%c%s", g_system_dir, path_default_slash_c(), romName);
-	if (ZipOpen(path) == 0)
+	if (archive_index_find(path) || ZipOpen(path) == 0)
 	{
 		g_find_list_path.push_back(path);
 		return;
@@ -609,6 +1512,7 @@ static void locate_archive(std::vector<std::string>& pathList, const char* const
 // This code is very confusing. The original code is even more confusing :(
 static bool open_archive()
 {
+   archive_prefetch_free();
    memset(g_find_list, 0, sizeof(g_find_list));
 
    // FBA wants some roms ... Figure out how many.
@@ -641,16 +1545,17 @@ static bool open_archive()
 
    for (unsigned z = 0; z < g_find_list_path.size(); z++)
    {
-      if (ZipOpen((char*)g_find_list_path[z].c_str()) != 0)
+      ZipEntry *list = NULL;
+      int count = 0;
+
+      if (archive_get_list(g_find_list_path[z].c_str(), &list, &count) != 0)
       {
          log_cb(RETRO_LOG_ERROR, "[FBA] Failed to open archive %s\n", g_find_list_path[z].c_str());
+         ZipClose();
+         archive_index_save();
          return false;
       }
 
-      ZipEntry *list = NULL;
-      int count;
-      ZipGetList(&list, &count);
-
       // Try to map the ROMs FBA wants to ROMs we find inside our pretty archives ...
       for (unsigned i = 0; i < g_rom_count; i++)
       {
@@ -733,6 +1638,8 @@ static bool open_archive()
       ZipClose();
    }
 
+   archive_index_save();
+
    bool is_neogeo_bios_available = false;
    if (is_neogeo_game)
    {
@@ -767,7 +1674,12 @@ static bool open_archive()
       }
    }
 
+#ifdef HAVE_THREADS
+   archive_prefetch();
+#endif
+
    BurnExtLoadRom = archive_load_rom;
+   BurnExtMapRom = archive_map_rom;
    return true;
 }
 
@@ -859,6 +1771,33 @@ void retro_reset()
    ForceFrameStep(1);
 }
 
+#ifdef BURN_PROFILE
+// Log the counters of the last emulated frame, times in microseconds
+static void ProfileLog()
+{
+	BurnProfFrame prof;
+	if (BurnProfGet(&prof))
+		return;
+
+	log_cb(RETRO_LOG_INFO, "[FBA] Profile frame %u: total %llu, cpu %llu, draw %llu, sound %llu, palette %llu\n",
+		prof.nFrame,
+		(unsigned long long)(prof.nTime[BURN_PROF_FRAME] / 1000),
+		(unsigned long long)(prof.nTime[BURN_PROF_CPU] / 1000),
+		(unsigned long long)(prof.nTime[BURN_PROF_DRAW] / 1000),
+		(unsigned long long)(prof.nTime[BURN_PROF_SOUND] / 1000),
+		(unsigned long long)(prof.nTime[BURN_PROF_PALETTE] / 1000));
+
+	for (INT32 i = 0; i < prof.nCpuCount; i++) {
+		BurnProfCpu *p = &prof.Cpu[i];
+		log_cb(RETRO_LOG_INFO, "[FBA]   %s #%d: %u runs, %lld/%lld cycles, handlers r %llu w %llu f %llu p %llu\n",
+			p->szName ? p->szName : "cpu", p->nCpu, p->nRuns,
+			(long long)p->nCyclesDone, (long long)p->nCyclesRequested,
+			(unsigned long long)p->nHandlerCalls[0], (unsigned long long)p->nHandlerCalls[1],
+			(unsigned long long)p->nHandlerCalls[2], (unsigned long long)p->nHandlerCalls[3]);
+	}
+}
+#endif
+
 void retro_run()
 {
 	int width, height;
@@ -867,7 +1806,26 @@ void retro_run()
 
 	InputMake();
 
-	ForceFrameStep(nCurrentFrame % nFrameskip == 0);
+#ifdef HAVE_THREADS
+	video_thread_frame_begin();
+	parallel_frame_begin();
+#endif
+
+	if (nRunAheadFrames)
+		RunAheadFrameStep(nCurrentFrame % nFrameskip == 0);
+	else
+		ForceFrameStep(nCurrentFrame % nFrameskip == 0);
+
+#ifdef BURN_PROFILE
+	if (nProfileLogFrames && (nCurrentFrame % nProfileLogFrames) == 0)
+		ProfileLog();
+#endif
+
+	UINT8 *pVidShow = pVidImage;
+#ifdef HAVE_THREADS
+	if (video_thread)
+		pVidShow = video_thread_frame_end();
+#endif
 
 	unsigned drv_flags = BurnDrvGetFlags();
 	uint32_t height_tmp = height;
@@ -885,7 +1843,7 @@ void retro_run()
 			nBurnPitch = width * nBurnBpp;
 	}
 
-	video_cb(pVidImage, width, height, nBurnPitch);
+	video_cb(pVidShow, width, height, nBurnPitch);
 
 	audio_batch_cb(g_audio_buf, nBurnSoundLen);
 	bool updated = false;
@@ -899,6 +1857,9 @@ void retro_run()
 
 		apply_dipswitch_from_variables();
 
+		if (!nRunAheadFrames)
+			RunAheadExit();
+
 		// Maybe macros changed, update them
 		UpdateMacros();
 
@@ -1013,7 +1974,8 @@ void retro_get_system_av_info(struct retro_system_av_info *info)
 {
 	int width, height, game_aspect_x, game_aspect_y;
 	BurnDrvGetVisibleSize(&width, &height);
-	pVidImage = BurnMalloc(width * height * nBurnBpp);
+	nVidImageSize = width * height * nBurnBpp;
+	pVidImage = BurnMalloc(nVidImageSize * 2);
 	BurnDrvGetAspect(&game_aspect_x, &game_aspect_y);
 	if (bVerticalMode)
 	{
@@ -1186,6 +2148,9 @@ static bool retro_load_game_common()
 	// Initialize Samples path
 	snprintf (szAppSamplesPath, sizeof(szAppSamplesPath), "%s%cfba%csamples%c", g_system_dir, path_default_slash_c(), path_default_slash_c(), path_default_slash_c());
 
+	// Initialize decoded graphics cache path (created when the cache is enabled)
+	snprintf (szBurnGfxCachePath, sizeof(szBurnGfxCachePath), "%s%cfba%cgfxcache%c", g_system_dir, path_default_slash_c(), path_default_slash_c(), path_default_slash_c());
+
 	// Initialize HDD path
 	snprintf (szAppHDDPath, sizeof(szAppHDDPath), "%s%c", g_rom_dir, path_default_slash_c());
 
@@ -1234,6 +2199,8 @@ static bool retro_load_game_common()
 
 		// Initialize game driver
 		BurnDrvInit();
+		ZipClose();
+		archive_prefetch_free();
 
 		// If the game is marked as not working, let's stop here
 		if (!(BurnDrvIsWorking())) {
@@ -1283,7 +2250,8 @@ static bool retro_load_game_common()
 			SetBurnHighCol(32);
 		}
 
-		pVidImage = BurnMalloc(width * height * nBurnBpp);
+		nVidImageSize = width * height * nBurnBpp;
+		pVidImage = BurnMalloc(nVidImageSize * 2);
 
 		// Apply dipswitches
 		apply_dipswitch_from_variables();
@@ -1370,9 +2338,15 @@ void retro_unload_game(void)
 	if (driver_inited)
 	{
 		BurnStateSave(g_autofs_path, 0);
+		RunAheadExit();
+#ifdef HAVE_THREADS
+		video_thread_exit();
+		parallel_exit();
+#endif
 		BurnDrvExit();
 		CDEmuExit();
 	}
+	ZipUnmapAll();
 	InputDeInit();
 	driver_inited = false;
 }
@@ -0,0 +1,360 @@
+// Headless frame-runner benchmark
+//
+// Links against the libretro core objects and acts as a minimal frontend: every
+// set named on the command line is loaded through retro_load_game (so ROM lookup,
+// audio setup and BurnDrvInit are exactly what players get), then BurnDrvFrame is
+// driven directly with scratch video/sound buffers.
+//
+// Each set is measured in three passes started from the same savestate:
+//   full   - pBurnDraw and pBurnSoundOut set
+//   nodraw - pBurnDraw = NULL
+//   cpu    - pBurnDraw = NULL, pBurnSoundOut = NULL
+// cpu time = cpu pass, sound time = nodraw - cpu, video time = full - nodraw.
+//
+// On POSIX hosts every set runs in its own forked process, so a crashing driver
+// does not abort the run and the reported peak RSS belongs to that driver only.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#endif
+
+#include "libretro.h"
+#include "burner.h"
+#include "burnint.h"
+
+#include <file/file_path.h>
+#include <features/features_cpu.h>
+
+#define BENCH_FORMAT_CSV	0
+#define BENCH_FORMAT_JSON	1
+
+struct BenchResult {
+	char szName[32];
+	INT32 nStatus;					// 0 = ok, 1 = load failed, 2 = crashed
+	INT32 nFrames;
+	double dNativeFps;
+	double dFullUsec;
+	double dNoDrawUsec;
+	double dCpuUsec;
+	INT64 nPeakRssKb;
+};
+
+static const char* szRomDir = ".";
+static const char* szSystemDir = NULL;
+static const char* szSaveDir = NULL;
+static INT32 nBenchFrames = 600;
+static INT32 nBenchWarmup = 120;
+static INT32 nBenchFormat = BENCH_FORMAT_CSV;
+static bool bBenchVerbose = false;
+static bool bBenchFork = true;
+
+static void bench_log(enum retro_log_level level, const char* fmt, ...)
+{
+	if (!bBenchVerbose && level < RETRO_LOG_ERROR)
+		return;
+
+	va_list vp;
+	va_start(vp, fmt);
+	vfprintf(stderr, fmt, vp);
+	va_end(vp);
+}
+
+static bool bench_environment(unsigned cmd, void* data)
+{
+	switch (cmd) {
+		case RETRO_ENVIRONMENT_GET_LOG_INTERFACE:
+			((struct retro_log_callback*)data)->log = bench_log;
+			return true;
+		case RETRO_ENVIRONMENT_GET_SYSTEM_DIRECTORY:
+			*(const char**)data = szSystemDir ? szSystemDir : szRomDir;
+			return true;
+		case RETRO_ENVIRONMENT_GET_SAVE_DIRECTORY:
+			*(const char**)data = szSaveDir ? szSaveDir : szRomDir;
+			return true;
+		case RETRO_ENVIRONMENT_GET_AUDIO_VIDEO_ENABLE:
+			*(int*)data = 3;		// video + audio, never a netplay session
+			return true;
+		case RETRO_ENVIRONMENT_SET_PIXEL_FORMAT:
+		case RETRO_ENVIRONMENT_SET_ROTATION:
+		case RETRO_ENVIRONMENT_SET_GEOMETRY:
+			return true;
+	}
+
+	// core options stay at their defaults
+	return false;
+}
+
+static void bench_video(const void*, unsigned, unsigned, size_t) {}
+static size_t bench_audio(const int16_t*, size_t frames) { return frames; }
+static void bench_input_poll() {}
+static int16_t bench_input_state(unsigned, unsigned, unsigned, unsigned) { return 0; }
+
+static double bench_run_frames(INT32 nFrames, UINT8* pDraw, INT16* pSound)
+{
+	pBurnDraw = pDraw;
+	pBurnSoundOut = pSound;
+
+	retro_time_t nStart = cpu_features_get_time_usec();
+
+	for (INT32 i = 0; i < nFrames; i++) {
+		nCurrentFrame++;
+		nBurnLayer = 0xff;
+		BurnDrvFrame();
+	}
+
+	return (double)(cpu_features_get_time_usec() - nStart);
+}
+
+static INT64 bench_peak_rss_kb()
+{
+#if !defined(_WIN32)
+	struct rusage ru;
+	if (getrusage(RUSAGE_SELF, &ru) != 0)
+		return 0;
+#if defined(__APPLE__)
+	return ru.ru_maxrss / 1024;
+#else
+	return ru.ru_maxrss;
+#endif
+#else
+	return 0;
+#endif
+}
+
+static void bench_one(const char* szName, BenchResult* pResult)
+{
+	char szPath[MAX_PATH];
+	snprintf(szPath, sizeof(szPath), "%s%c%s.zip", szRomDir, path_default_slash_c(), szName);
+
+	memset(pResult, 0, sizeof(BenchResult));
+	strncpy(pResult->szName, szName, sizeof(pResult->szName) - 1);
+	pResult->nStatus = 1;
+
+	retro_set_environment(bench_environment);
+	retro_set_video_refresh(bench_video);
+	retro_set_audio_sample_batch(bench_audio);
+	retro_set_input_poll(bench_input_poll);
+	retro_set_input_state(bench_input_state);
+	retro_init();
+
+	struct retro_game_info info;
+	memset(&info, 0, sizeof(info));
+	info.path = szPath;
+
+	if (!retro_load_game(&info)) {
+		retro_unload_game();
+		retro_deinit();
+		return;
+	}
+
+	INT32 nWidth, nHeight;
+	BurnDrvGetVisibleSize(&nWidth, &nHeight);
+	if (BurnDrvGetFlags() & BDF_ORIENTATION_VERTICAL)
+		nBurnPitch = nHeight * nBurnBpp;
+	else
+		nBurnPitch = nWidth * nBurnBpp;
+
+	UINT8* pDraw = (UINT8*)malloc(nWidth * nHeight * 4);
+	INT16* pSound = pBurnSoundOut;		// allocated by the core for nBurnSoundLen samples
+
+	// Get past boot screens, then pin the starting point for every pass
+	bench_run_frames(nBenchWarmup, pDraw, pSound);
+
+	size_t nStateLen = retro_serialize_size();
+	UINT8* pState = nStateLen ? (UINT8*)malloc(nStateLen) : NULL;
+	if (pState && !retro_serialize(pState, nStateLen)) {
+		free(pState);
+		pState = NULL;
+	}
+
+	pResult->dFullUsec = bench_run_frames(nBenchFrames, pDraw, pSound);
+	if (pState) retro_unserialize(pState, nStateLen);
+	pResult->dNoDrawUsec = bench_run_frames(nBenchFrames, NULL, pSound);
+	if (pState) retro_unserialize(pState, nStateLen);
+	pResult->dCpuUsec = bench_run_frames(nBenchFrames, NULL, NULL);
+
+	pBurnSoundOut = pSound;
+	pResult->nFrames = nBenchFrames;
+	pResult->dNativeFps = nBurnFPS / 100.0;
+	pResult->nPeakRssKb = bench_peak_rss_kb();
+	pResult->nStatus = 0;
+
+	free(pState);
+	free(pDraw);
+
+	retro_unload_game();
+	retro_deinit();
+}
+
+#if !defined(_WIN32)
+static void bench_one_forked(const char* szName, BenchResult* pResult)
+{
+	int fd[2];
+
+	if (pipe(fd) != 0) {
+		bench_one(szName, pResult);
+		return;
+	}
+
+	fflush(NULL);
+	pid_t pid = fork();
+
+	if (pid == 0) {
+		close(fd[0]);
+		bench_one(szName, pResult);
+		ssize_t nWrote = write(fd[1], pResult, sizeof(BenchResult));
+		close(fd[1]);
+		_exit(nWrote == (ssize_t)sizeof(BenchResult) ? 0 : 1);
+	}
+
+	close(fd[1]);
+
+	memset(pResult, 0, sizeof(BenchResult));
+	strncpy(pResult->szName, szName, sizeof(pResult->szName) - 1);
+	pResult->nStatus = 2;
+
+	if (pid > 0) {
+		BenchResult r;
+		if (read(fd[0], &r, sizeof(r)) == (ssize_t)sizeof(r))
+			*pResult = r;
+		waitpid(pid, NULL, 0);
+	}
+
+	close(fd[0]);
+}
+#endif
+
+static const char* bench_status_text(INT32 nStatus)
+{
+	switch (nStatus) {
+		case 0: return "ok";
+		case 1: return "load-failed";
+	}
+	return "crashed";
+}
+
+static void bench_print(FILE* fp, const BenchResult* r, bool bFirst)
+{
+	double dFrames = r->nFrames ? (double)r->nFrames : 1.0;
+	double dFull  = r->dFullUsec;
+	double dCpu   = r->dCpuUsec;
+	double dSound = r->dNoDrawUsec > dCpu ? r->dNoDrawUsec - dCpu : 0.0;
+	double dVideo = dFull > r->dNoDrawUsec ? dFull - r->dNoDrawUsec : 0.0;
+	double dFps   = dFull > 0.0 ? dFrames * 1000000.0 / dFull : 0.0;
+
+	if (nBenchFormat == BENCH_FORMAT_JSON) {
+		fprintf(fp, "%s\n  { \"driver\": \"%s\", \"status\": \"%s\", \"frames\": %d, \"native_fps\": %.2f, \"fps\": %.2f, "
+			"\"speed\": %.3f, \"frame_ms\": %.4f, \"cpu_ms\": %.4f, \"video_ms\": %.4f, \"sound_ms\": %.4f, \"peak_rss_kb\": %lld }",
+			bFirst ? "" : ",", r->szName, bench_status_text(r->nStatus), r->nFrames, r->dNativeFps, dFps,
+			r->dNativeFps > 0.0 ? dFps / r->dNativeFps : 0.0,
+			dFull / dFrames / 1000.0, dCpu / dFrames / 1000.0, dVideo / dFrames / 1000.0, dSound / dFrames / 1000.0,
+			(long long)r->nPeakRssKb);
+	} else {
+		fprintf(fp, "%s,%s,%d,%.2f,%.2f,%.3f,%.4f,%.4f,%.4f,%.4f,%lld\n",
+			r->szName, bench_status_text(r->nStatus), r->nFrames, r->dNativeFps, dFps,
+			r->dNativeFps > 0.0 ? dFps / r->dNativeFps : 0.0,
+			dFull / dFrames / 1000.0, dCpu / dFrames / 1000.0, dVideo / dFrames / 1000.0, dSound / dFrames / 1000.0,
+			(long long)r->nPeakRssKb);
+	}
+
+	fflush(fp);
+}
+
+static void bench_usage(const char* szExe)
+{
+	fprintf(stderr,
+		"Usage: %s [options] <set> [<set> ...]\n"
+		"  -r <dir>    rom directory (default .)\n"
+		"  -s <dir>    system directory (default: rom directory)\n"
+		"  -d <dir>    save directory (default: rom directory)\n"
+		"  -n <count>  frames measured per pass (default 600)\n"
+		"  -w <count>  warm-up frames before measuring (default 120)\n"
+		"  -j          JSON output instead of CSV\n"
+		"  -o <file>   write results to file instead of stdout\n"
+		"  -1          run every set in this process (no fork)\n"
+		"  -v          show core log output\n", szExe);
+}
+
+int main(int argc, char* argv[])
+{
+	FILE* fp = stdout;
+	INT32 nFirstSet = argc;
+
+	for (INT32 i = 1; i < argc; i++) {
+		if (argv[i][0] != '-') {
+			nFirstSet = i;
+			break;
+		}
+
+		char c = argv[i][1];
+		bool bHasArg = (c == 'r' || c == 's' || c == 'd' || c == 'n' || c == 'w' || c == 'o');
+
+		if (bHasArg && i + 1 >= argc) {
+			bench_usage(argv[0]);
+			return 1;
+		}
+
+		switch (c) {
+			case 'r': szRomDir = argv[++i]; break;
+			case 's': szSystemDir = argv[++i]; break;
+			case 'd': szSaveDir = argv[++i]; break;
+			case 'n': nBenchFrames = atoi(argv[++i]); break;
+			case 'w': nBenchWarmup = atoi(argv[++i]); break;
+			case 'j': nBenchFormat = BENCH_FORMAT_JSON; break;
+			case '1': bBenchFork = false; break;
+			case 'v': bBenchVerbose = true; break;
+			case 'o':
+				fp = fopen(argv[++i], "w");
+				if (fp == NULL) {
+					fprintf(stderr, "Can't open %s for writing\n", argv[i]);
+					return 1;
+				}
+				break;
+			default:
+				bench_usage(argv[0]);
+				return 1;
+		}
+	}
+
+	if (nFirstSet >= argc || nBenchFrames <= 0) {
+		bench_usage(argv[0]);
+		return 1;
+	}
+
+	if (nBenchFormat == BENCH_FORMAT_JSON)
+		fprintf(fp, "[");
+	else
+		fprintf(fp, "driver,status,frames,native_fps,fps,speed,frame_ms,cpu_ms,video_ms,sound_ms,peak_rss_kb\n");
+
+	INT32 nFailed = 0;
+
+	for (INT32 i = nFirstSet; i < argc; i++) {
+		BenchResult r;
+
+#if !defined(_WIN32)
+		if (bBenchFork)
+			bench_one_forked(argv[i], &r);
+		else
+#endif
+			bench_one(argv[i], &r);
+
+		if (r.nStatus) nFailed++;
+
+		bench_print(fp, &r, i == nFirstSet);
+	}
+
+	if (nBenchFormat == BENCH_FORMAT_JSON)
+		fprintf(fp, "\n]\n");
+
+	if (fp != stdout)
+		fclose(fp);
+
+	return nFailed ? 2 : 0;
+}
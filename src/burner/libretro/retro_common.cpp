@@ -1,5 +1,6 @@
 #include "retro_common.h"
 #include "retro_input.h"
+#include <file/file_path.h>
 
 struct RomBiosInfo mvs_bioses[] = {
 	{"sp-s3.sp1",         0x91b64be3, 0x00, "MVS Asia/Europe ver. 6 (1 slot)",  1 },
@@ -59,6 +60,10 @@ bool core_aspect_par = false;
 bool bVerticalMode = false;
 bool bAllowDepth32 = false;
 UINT32 nFrameskip = 1;
+UINT32 nRunAheadFrames = 0;
+UINT32 nProfileLogFrames = 0;
+bool bVideoThreaded = false;
+bool bVideoParallel = true;
 INT32 g_audio_samplerate = 48000;
 UINT8 *diag_input;
 neo_geo_modes g_opt_neo_geo_mode = NEO_GEO_MODE_MVS;
@@ -83,6 +88,14 @@ static const struct retro_variable var_fba_aspect = { "fba-aspect", "Core-provid
 static const struct retro_variable var_fba_allow_depth_32 = { "fba-allow-depth-32", "Use 32-bits color depth when available; disabled|enabled" };
 static const struct retro_variable var_fba_vertical_mode = { "fba-vertical-mode", "Vertical mode; disabled|enabled" };
 static const struct retro_variable var_fba_frameskip = { "fba-frameskip", "Frameskip; 0|1|2|3|4|5" };
+static const struct retro_variable var_fba_runahead = { "fba-runahead", "Run-ahead (reduce input lag, needs more CPU); 0|1|2|3|4" };
+static const struct retro_variable var_fba_dirty_lines = { "fba-dirty-lines", "Only redraw changed lines; disabled|enabled" };
+static const struct retro_variable var_fba_threaded_video = { "fba-threaded-video", "Draw on a separate thread (adds a frame of lag); disabled|enabled" };
+static const struct retro_variable var_fba_parallel_video = { "fba-parallel-video", "Split drawing across cpu cores (supported drivers only); enabled|disabled" };
+static const struct retro_variable var_fba_gfx_cache = { "fba-gfx-cache", "Cache decoded graphics on disk; disabled|enabled" };
+#ifdef BURN_PROFILE
+static const struct retro_variable var_fba_profile_log = { "fba-profile-log", "Log the frame profile every N frames; disabled|60|300|600" };
+#endif
 static const struct retro_variable var_fba_cpu_speed_adjust = { "fba-cpu-speed-adjust", "CPU overclock; 100|110|120|130|140|150|160|170|180|190|200" };
 static const struct retro_variable var_fba_diagnostic_input = { "fba-diagnostic-input", "Diagnostic Input; None|Hold Start|Start + A + B|Hold Start + A + B|Start + L + R|Hold Start + L + R|Hold Select|Select + A + B|Hold Select + A + B|Select + L + R|Hold Select + L + R" };
 static const struct retro_variable var_fba_hiscores = { "fba-hiscores", "Hiscores; enabled|disabled" };
@@ -232,6 +245,16 @@ void set_environment()
 	vars_systems.push_back(&var_fba_allow_depth_32);
 	vars_systems.push_back(&var_fba_vertical_mode);
 	vars_systems.push_back(&var_fba_frameskip);
+	vars_systems.push_back(&var_fba_runahead);
+	vars_systems.push_back(&var_fba_dirty_lines);
+	vars_systems.push_back(&var_fba_gfx_cache);
+#ifdef BURN_PROFILE
+	vars_systems.push_back(&var_fba_profile_log);
+#endif
+#ifdef HAVE_THREADS
+	vars_systems.push_back(&var_fba_threaded_video);
+	vars_systems.push_back(&var_fba_parallel_video);
+#endif
 	vars_systems.push_back(&var_fba_cpu_speed_adjust);
 	vars_systems.push_back(&var_fba_hiscores);
 	if (nGameType != RETRO_GAME_TYPE_NEOCD)
@@ -391,6 +414,77 @@ void check_variables(void)
 			nFrameskip = 6;
 	}
 
+	var.key = var_fba_runahead.key;
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var))
+	{
+		if (strcmp(var.value, "1") == 0)
+			nRunAheadFrames = 1;
+		else if (strcmp(var.value, "2") == 0)
+			nRunAheadFrames = 2;
+		else if (strcmp(var.value, "3") == 0)
+			nRunAheadFrames = 3;
+		else if (strcmp(var.value, "4") == 0)
+			nRunAheadFrames = 4;
+		else
+			nRunAheadFrames = 0;
+	}
+
+	var.key = var_fba_dirty_lines.key;
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var))
+	{
+		if (strcmp(var.value, "enabled") == 0)
+			bBurnTransferDirtyLines = true;
+		else
+			bBurnTransferDirtyLines = false;
+	}
+
+#ifdef HAVE_THREADS
+	var.key = var_fba_threaded_video.key;
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var))
+	{
+		if (strcmp(var.value, "enabled") == 0)
+			bVideoThreaded = true;
+		else
+			bVideoThreaded = false;
+	}
+
+	var.key = var_fba_parallel_video.key;
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var))
+	{
+		if (strcmp(var.value, "disabled") == 0)
+			bVideoParallel = false;
+		else
+			bVideoParallel = true;
+	}
+#endif
+
+	var.key = var_fba_gfx_cache.key;
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var))
+	{
+		if (strcmp(var.value, "enabled") == 0)
+			bBurnUseGfxCache = true;
+		else
+			bBurnUseGfxCache = false;
+
+		if (bBurnUseGfxCache && szBurnGfxCachePath[0])
+			path_mkdir(szBurnGfxCachePath);
+	}
+
+#ifdef BURN_PROFILE
+	var.key = var_fba_profile_log.key;
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var))
+	{
+		if (strcmp(var.value, "60") == 0)
+			nProfileLogFrames = 60;
+		else if (strcmp(var.value, "300") == 0)
+			nProfileLogFrames = 300;
+		else if (strcmp(var.value, "600") == 0)
+			nProfileLogFrames = 600;
+		else
+			nProfileLogFrames = 0;
+	}
+#endif
+
 	if (pgi_diag)
 	{
 		var.key = var_fba_diagnostic_input.key;
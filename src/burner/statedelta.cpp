@@ -0,0 +1,239 @@
+// Driver State Delta module
+//
+// Keeps one flat copy of the driver state, taken with BurnAreaScan. Each push
+// compares the areas with the copy page by page and only refreshes the pages
+// that changed, restoring only writes back the pages that differ from it. Used
+// by run-ahead, which snapshots and rolls back the driver every frame.
+#include "burner.h"
+
+#define DELTA_PAGE_SHIFT	(10)
+#define DELTA_PAGE_SIZE		(1 << DELTA_PAGE_SHIFT)
+
+static UINT8* pDeltaState = NULL;		// The most recently pushed state, flattened
+static INT32 nDeltaStateLen = 0;
+static INT32 nDeltaStateFill = 0;
+static INT32 nDeltaAreaCount = 0;
+static INT32 nDeltaAreaSeen = 0;
+static bool bDeltaHaveBase = false;
+static bool bDeltaOverflow = false;
+
+static bool bDeltaActive = false;
+
+#ifdef FBA_DEBUG
+static INT32 nDeltaMismatch = 0;
+static const TCHAR* szDeltaVerifyWhat = NULL;
+#endif
+
+// -----------------------------------------------------------------------------
+
+static INT32 __cdecl DeltaLenAcb(struct BurnArea* pba)
+{
+	nDeltaStateLen += pba->nLen;
+	nDeltaAreaCount++;
+
+	return 0;
+}
+
+static INT32 __cdecl DeltaBaseAcb(struct BurnArea* pba)
+{
+	if (nDeltaStateFill + (INT32)pba->nLen > nDeltaStateLen) {
+		bDeltaOverflow = true;
+		return 0;
+	}
+
+	memcpy(pDeltaState + nDeltaStateFill, pba->Data, pba->nLen);
+	nDeltaStateFill += pba->nLen;
+	nDeltaAreaSeen++;
+
+	return 0;
+}
+
+static INT32 __cdecl DeltaPushAcb(struct BurnArea* pba)
+{
+	if (bDeltaOverflow || nDeltaStateFill + (INT32)pba->nLen > nDeltaStateLen) {
+		bDeltaOverflow = true;
+		return 0;
+	}
+
+	const UINT8* pNew = (const UINT8*)pba->Data;
+	UINT8* pOld = pDeltaState + nDeltaStateFill;
+
+	for (INT32 i = 0; i < (INT32)pba->nLen; i += DELTA_PAGE_SIZE) {
+		INT32 nLen = pba->nLen - i;
+		if (nLen > DELTA_PAGE_SIZE) {
+			nLen = DELTA_PAGE_SIZE;
+		}
+
+		if (memcmp(pNew + i, pOld + i, nLen)) {
+			memcpy(pOld + i, pNew + i, nLen);
+		}
+	}
+
+	nDeltaStateFill += pba->nLen;
+	nDeltaAreaSeen++;
+
+	return 0;
+}
+
+static INT32 __cdecl DeltaRestoreAcb(struct BurnArea* pba)
+{
+	if (nDeltaStateFill + (INT32)pba->nLen > nDeltaStateLen) {
+		return 0;
+	}
+
+	UINT8* pDst = (UINT8*)pba->Data;
+	const UINT8* pSrc = pDeltaState + nDeltaStateFill;
+
+	// Only write back the pages that were changed since
+	for (INT32 i = 0; i < (INT32)pba->nLen; i += DELTA_PAGE_SIZE) {
+		INT32 nLen = pba->nLen - i;
+		if (nLen > DELTA_PAGE_SIZE) {
+			nLen = DELTA_PAGE_SIZE;
+		}
+
+		if (memcmp(pDst + i, pSrc + i, nLen)) {
+			memcpy(pDst + i, pSrc + i, nLen);
+		}
+	}
+
+	nDeltaStateFill += pba->nLen;
+
+	return 0;
+}
+
+#ifdef FBA_DEBUG
+static INT32 __cdecl DeltaVerifyAcb(struct BurnArea* pba)
+{
+	if (nDeltaStateFill + (INT32)pba->nLen > nDeltaStateLen) {
+		nDeltaMismatch++;
+		return 0;
+	}
+
+	if (memcmp(pba->Data, pDeltaState + nDeltaStateFill, pba->nLen)) {
+		bprintf(PRINT_ERROR, _T("*** State delta: area %d (offset %d) differs from the copy after the %s\n"), nDeltaAreaSeen, nDeltaStateFill, szDeltaVerifyWhat);
+		nDeltaMismatch++;
+	}
+
+	nDeltaStateFill += pba->nLen;
+	nDeltaAreaSeen++;
+
+	return 0;
+}
+
+// Round-trip check: the driver state and the copy must be identical after a
+// push or a restore
+static void DeltaVerify(const TCHAR* szWhat)
+{
+	szDeltaVerifyWhat = szWhat;
+	nDeltaMismatch = 0;
+	nDeltaStateFill = 0;
+	nDeltaAreaSeen = 0;
+	BurnAcb = DeltaVerifyAcb;
+	BurnAreaScan(ACB_FULLSCAN | ACB_READ, NULL);
+
+	if (nDeltaStateFill != nDeltaStateLen) {
+		nDeltaMismatch++;
+	}
+	if (nDeltaMismatch) {
+		bprintf(PRINT_ERROR, _T("*** State delta: %d mismatches after the %s\n"), nDeltaMismatch, szWhat);
+	}
+}
+#endif
+
+// (Re)build the flat copy from scratch
+static INT32 DeltaCaptureBase()
+{
+	nDeltaStateLen = 0;
+	nDeltaAreaCount = 0;
+	BurnAcb = DeltaLenAcb;
+	BurnAreaScan(ACB_FULLSCAN | ACB_READ, NULL);
+
+	if (pDeltaState) {
+		free(pDeltaState);
+	}
+	pDeltaState = (UINT8*)malloc(nDeltaStateLen ? nDeltaStateLen : 1);
+	if (pDeltaState == NULL) {
+		bDeltaHaveBase = false;
+		return 1;
+	}
+
+	nDeltaStateFill = 0;
+	nDeltaAreaSeen = 0;
+	bDeltaOverflow = false;
+	BurnAcb = DeltaBaseAcb;
+	BurnAreaScan(ACB_FULLSCAN | ACB_READ, NULL);
+
+	bDeltaHaveBase = !bDeltaOverflow;
+
+	return bDeltaHaveBase ? 0 : 1;
+}
+
+// -----------------------------------------------------------------------------
+
+INT32 BurnStateDeltaInit()
+{
+	BurnStateDeltaExit();
+
+	bDeltaActive = true;
+
+	return 0;
+}
+
+void BurnStateDeltaExit()
+{
+	if (pDeltaState) {
+		free(pDeltaState);
+		pDeltaState = NULL;
+	}
+
+	bDeltaActive = false;
+	nDeltaStateLen = 0;
+	bDeltaHaveBase = false;
+}
+
+// Record the current driver state
+INT32 BurnStateDeltaPush()
+{
+	if (!bDeltaActive) {
+		return 1;
+	}
+
+	if (!bDeltaHaveBase) {
+		return DeltaCaptureBase();
+	}
+
+	nDeltaStateFill = 0;
+	nDeltaAreaSeen = 0;
+	bDeltaOverflow = false;
+	BurnAcb = DeltaPushAcb;
+	BurnAreaScan(ACB_FULLSCAN | ACB_READ, NULL);
+
+	// The driver changed the layout of its state, start over
+	if (bDeltaOverflow || nDeltaStateFill != nDeltaStateLen || nDeltaAreaSeen != nDeltaAreaCount) {
+		return DeltaCaptureBase();
+	}
+
+#ifdef FBA_DEBUG
+	DeltaVerify(_T("push"));
+#endif
+
+	return 0;
+}
+
+// Put the driver back to the last pushed state
+INT32 BurnStateDeltaRestore()
+{
+	if (!bDeltaHaveBase) {
+		return 1;
+	}
+
+	nDeltaStateFill = 0;
+	BurnAcb = DeltaRestoreAcb;
+	BurnAreaScan(ACB_FULLSCAN | ACB_WRITE, NULL);
+
+#ifdef FBA_DEBUG
+	DeltaVerify(_T("restore"));
+#endif
+
+	return 0;
+}
@@ -6,6 +6,16 @@
 #include "un7z.h"
 #endif
 
+#if defined(_WIN32)
+#include <windows.h>
+#elif !defined(__CELLOS_LV2__) && !defined(_XBOX) && !defined(PSP) && !defined(VITA)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define ZIPFN_MMAP
+#endif
+
 #define ZIPFN_FILETYPE_NONE		-1
 #define ZIPFN_FILETYPE_ZIP		1
 #define ZIPFN_FILETYPE_7ZIP		2
@@ -19,11 +29,23 @@ static INT32 nCurrFile = 0; // The current file we are pointing to
 static _7z_file* _7ZipFile = NULL;
 #endif
 
+static char szOpenZip[MAX_PATH] = "";	// Name passed to ZipOpen for the open archive
+static char szOpenFile[MAX_PATH] = "";	// The file actually opened
+
 INT32 ZipOpen(char* szZip)
 {
-	nFileType = ZIPFN_FILETYPE_NONE;
-	
 	if (szZip == NULL) return 1;
+
+	// Opening the same archive again just keeps the one we have, so loading a
+	// set rom by rom doesn't re-read the central directory every time
+	if (nFileType != ZIPFN_FILETYPE_NONE) {
+		if (strcmp(szOpenZip, szZip) == 0) {
+			return 0;
+		}
+		ZipClose();
+	}
+
+	nFileType = ZIPFN_FILETYPE_NONE;
 	
 	char szFileName[MAX_PATH];
 	
@@ -33,6 +55,9 @@ INT32 ZipOpen(char* szZip)
 		nFileType = ZIPFN_FILETYPE_ZIP;
 		unzGoToFirstFile(Zip);
 		nCurrFile = 0;
+
+		snprintf(szOpenZip, sizeof(szOpenZip), "%s", szZip);
+		snprintf(szOpenFile, sizeof(szOpenFile), "%s", szFileName);
 		
 		return 0;
 	}
@@ -43,6 +68,9 @@ INT32 ZipOpen(char* szZip)
 	if (_7zerr == _7ZERR_NONE) {
 		nFileType = ZIPFN_FILETYPE_7ZIP;
 		nCurrFile = 0;
+
+		snprintf(szOpenZip, sizeof(szOpenZip), "%s", szZip);
+		snprintf(szOpenFile, sizeof(szOpenFile), "%s", szFileName);
 		
 		return 0;
 	}
@@ -70,6 +98,8 @@ INT32 ZipClose()
 #endif
 	
 	nFileType = ZIPFN_FILETYPE_NONE;
+	szOpenZip[0] = '\0';
+	szOpenFile[0] = '\0';
 	
 	return 0;
 }
@@ -196,6 +226,29 @@ INT32 ZipGetList(struct ZipEntry** pList, INT32* pnListCount)
 	return 0;
 }
 
+static INT32 ZipSeekEntry(INT32 nEntry)
+{
+	INT32 nRet = 0;
+
+	if (nEntry < nCurrFile)
+	{
+		// We'll have to go through the zip file again to get to our entry
+		nRet = unzGoToFirstFile(Zip);
+		if (nRet != UNZ_OK) return 1;
+		nCurrFile = 0;
+	}
+
+	// Now step through to the file we need
+	while (nCurrFile < nEntry)
+	{
+		nRet = unzGoToNextFile(Zip);
+		if (nRet != UNZ_OK) return 1;
+		nCurrFile++;
+	}
+
+	return 0;
+}
+
 INT32 ZipLoadFile(UINT8* Dest, INT32 nLen, INT32* pnWrote, INT32 nEntry)
 {
 	if (nFileType == ZIPFN_FILETYPE_ZIP && Zip == NULL) return 1;
@@ -207,21 +260,7 @@ INT32 ZipLoadFile(UINT8* Dest, INT32 nLen, INT32* pnWrote, INT32 nEntry)
 	INT32 nRet = 0;
 	
 	if (nFileType == ZIPFN_FILETYPE_ZIP) {
-		if (nEntry < nCurrFile)
-		{
-			// We'll have to go through the zip file again to get to our entry
-			nRet = unzGoToFirstFile(Zip);
-			if (nRet != UNZ_OK) return 1;
-			nCurrFile = 0;
-		}
-
-		// Now step through to the file we need
-		while (nCurrFile < nEntry)
-		{
-			nRet = unzGoToNextFile(Zip);
-			if (nRet != UNZ_OK) return 1;
-			nCurrFile++;
-		}
+		if (ZipSeekEntry(nEntry)) return 1;
 
 		nRet = unzOpenCurrentFile(Zip);
 		if (nRet != UNZ_OK) return 1;
@@ -257,6 +296,162 @@ INT32 ZipLoadFile(UINT8* Dest, INT32 nLen, INT32* pnWrote, INT32 nEntry)
 	return 0;
 }
 
+// ---------------------------------------------------------------------------
+// Memory mapped archives
+//
+// Files stored without compression can be used in place: the whole archive is
+// mapped read-only and a pointer into it is handed out, so the rom never goes
+// through a heap buffer and the pages are shared with any other process that
+// has the same archive open. Mappings are kept until ZipUnmapAll().
+
+#define ZIPFN_MAX_MAPS		(32)
+#define ZIPFN_MAX_CHECKED	(64)
+
+struct ZipMapping {
+	char szName[MAX_PATH];
+	UINT8* pData;
+	INT64 nSize;
+	UINT64 nChecked[ZIPFN_MAX_CHECKED];	// offsets of the entries whose crc matched
+	INT32 nCheckedCount;
+#if defined(_WIN32)
+	HANDLE hFile;
+	HANDLE hMap;
+#endif
+};
+
+static ZipMapping ZipMaps[ZIPFN_MAX_MAPS];
+static INT32 nZipMaps = 0;
+
+static ZipMapping* ZipMapArchive()
+{
+	for (INT32 i = 0; i < nZipMaps; i++) {
+		if (strcmp(ZipMaps[i].szName, szOpenFile) == 0) {
+			return &ZipMaps[i];
+		}
+	}
+
+	if (nZipMaps >= ZIPFN_MAX_MAPS) return NULL;
+
+	ZipMapping* pMap = &ZipMaps[nZipMaps];
+	memset(pMap, 0, sizeof(ZipMapping));
+
+#if defined(_WIN32)
+	pMap->hFile = CreateFileA(szOpenFile, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (pMap->hFile == INVALID_HANDLE_VALUE) return NULL;
+
+	LARGE_INTEGER nSize;
+	if (!GetFileSizeEx(pMap->hFile, &nSize) || nSize.QuadPart == 0) {
+		CloseHandle(pMap->hFile);
+		return NULL;
+	}
+
+	pMap->hMap = CreateFileMappingA(pMap->hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (pMap->hMap == NULL) {
+		CloseHandle(pMap->hFile);
+		return NULL;
+	}
+
+	pMap->pData = (UINT8*)MapViewOfFile(pMap->hMap, FILE_MAP_READ, 0, 0, 0);
+	if (pMap->pData == NULL) {
+		CloseHandle(pMap->hMap);
+		CloseHandle(pMap->hFile);
+		return NULL;
+	}
+	pMap->nSize = nSize.QuadPart;
+#elif defined(ZIPFN_MMAP)
+	INT32 fd = open(szOpenFile, O_RDONLY);
+	if (fd < 0) return NULL;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0) {
+		close(fd);
+		return NULL;
+	}
+
+	void* pData = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (pData == MAP_FAILED) return NULL;
+
+	pMap->pData = (UINT8*)pData;
+	pMap->nSize = st.st_size;
+#else
+	return NULL;
+#endif
+
+	snprintf(pMap->szName, sizeof(pMap->szName), "%s", szOpenFile);
+	nZipMaps++;
+
+	return pMap;
+}
+
+// Point *ppData at entry nEntry of the open archive, if it is stored uncompressed.
+// Returns 1 if the file has to be loaded with ZipLoadFile, 2 on a crc error.
+INT32 ZipMapFile(UINT8** ppData, INT32* pnLen, INT32 nEntry)
+{
+	if (nFileType != ZIPFN_FILETYPE_ZIP || Zip == NULL) return 1;
+	if (ppData == NULL) return 1;
+
+	if (ZipSeekEntry(nEntry)) return 1;
+
+	unz_file_info FileInfo;
+	memset(&FileInfo, 0, sizeof(FileInfo));
+
+	if (unzGetCurrentFileInfo(Zip, &FileInfo, NULL, 0, NULL, 0, NULL, 0) != UNZ_OK) return 1;
+
+	// Only stored, unencrypted files can be used as they are
+	if (FileInfo.compression_method != 0 || (FileInfo.flag & 1)) return 1;
+
+	// Opening the file parses the local header, which gives us where the data starts
+	if (unzOpenCurrentFile(Zip) != UNZ_OK) return 1;
+	UINT64 nPos = unzGetCurrentFileZStreamPos64(Zip);
+	unzCloseCurrentFile(Zip);
+
+	ZipMapping* pMap = ZipMapArchive();
+	if (pMap == NULL) return 1;
+
+	if (nPos + FileInfo.uncompressed_size > (UINT64)pMap->nSize) return 1;
+
+	UINT8* pData = pMap->pData + nPos;
+
+	// The mapping is read-only, so each entry only needs its crc checked once
+	INT32 bChecked = 0;
+	for (INT32 i = 0; i < pMap->nCheckedCount; i++) {
+		if (pMap->nChecked[i] == nPos) {
+			bChecked = 1;
+			break;
+		}
+	}
+
+	if (!bChecked) {
+		if (crc32(0, pData, FileInfo.uncompressed_size) != FileInfo.crc) return 2;
+
+		if (pMap->nCheckedCount < ZIPFN_MAX_CHECKED) {
+			pMap->nChecked[pMap->nCheckedCount++] = nPos;
+		}
+	}
+
+	*ppData = pData;
+	if (pnLen != NULL) *pnLen = FileInfo.uncompressed_size;
+
+	return 0;
+}
+
+// Release all mappings, nothing may use pointers from ZipMapFile after this
+void ZipUnmapAll()
+{
+	for (INT32 i = 0; i < nZipMaps; i++) {
+#if defined(_WIN32)
+		UnmapViewOfFile(ZipMaps[i].pData);
+		CloseHandle(ZipMaps[i].hMap);
+		CloseHandle(ZipMaps[i].hFile);
+#elif defined(ZIPFN_MMAP)
+		munmap(ZipMaps[i].pData, ZipMaps[i].nSize);
+#endif
+	}
+
+	nZipMaps = 0;
+}
+
 // Load one file directly, added by regret
 INT32 __cdecl ZipLoadOneFile(char* arcName, const char* fileName, void** Dest, INT32* pnWrote)
 {
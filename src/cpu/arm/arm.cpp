@@ -22,6 +22,7 @@
 //#include "driver.h"
 #include "burnint.h"
 #include "arm_intf.h"
+#include "burn_prof.h"
 
 #define READ8(addr)		cpu_read8(addr)
 #define WRITE8(addr,data)	cpu_write8(addr,data)
@@ -331,6 +332,8 @@ void ArmReset(void)
 
 int ArmRun( int cycles )
 {
+	BURN_PROF_CPU_SCOPE("ARM", &ArmConfig, cycles);
+
 	UINT32 pc;
 	UINT32 insn;
 
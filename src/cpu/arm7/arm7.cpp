@@ -37,6 +37,8 @@
 #include "burnint.h"
 #include "arm7core.h"
 #include "arm7_intf.h"
+#include "burn_prof.h"
+#include "burn_idle.h"
 
 #if defined __GNUC__
 __extension__ typedef unsigned long long	UINT64;
@@ -51,6 +53,9 @@ typedef signed long long	INT64;
 /* Example for showing how Co-Proc functions work */
 #define TEST_COPROC_FUNCS 0
 
+/* Run straight runs of directly mapped code from the block cache instead of fetching each opcode */
+#define USE_BLOCK_CACHE 1
+
 /* prototypes */
 #if TEST_COPROC_FUNCS
 static WRITE32_HANDLER(test_do_callback);
@@ -67,11 +72,11 @@ static char *Spec_DO(char *pBuf, UINT32 opcode, char *pConditionCode, char *pBuf
 /* In this case, we are using the default arm7 handlers (supplied by the core)
    - but simply changes these and define your own if needed for cpu implementation specific needs */
 #define READ8(addr)         arm7_cpu_read8(addr)
-#define WRITE8(addr,data)   arm7_cpu_write8(addr,data)
+#define WRITE8(addr,data)   (arm7_idle_writes++, arm7_cpu_write8(addr,data))
 #define READ16(addr)        arm7_cpu_read16(addr)
-#define WRITE16(addr,data)  arm7_cpu_write16(addr,data)
+#define WRITE16(addr,data)  (arm7_idle_writes++, arm7_cpu_write16(addr,data))
 #define READ32(addr)        arm7_cpu_read32(addr)
-#define WRITE32(addr,data)  arm7_cpu_write32(addr,data)
+#define WRITE32(addr,data)  (arm7_idle_writes++, arm7_cpu_write32(addr,data))
 #define PTR_READ32          &arm7_cpu_read32
 #define PTR_WRITE32         &arm7_cpu_write32
 
@@ -91,6 +96,11 @@ static int ARM7_ICOUNT;
 static int total_cycles = 0;
 static int curr_cycles = 0;
 
+// idle loop detection (burn_idle.h), only one arm7 so always slot 0
+static UINT32 arm7_idle_writes = 0;
+static void arm7_idle_branch(UINT32 pc, UINT32 target);
+#define ARM7_IDLE_CHECK(PC, TARGET) if (BurnIdleInfo[IDLE_CPU_ARM7][0].bEnabled) arm7_idle_branch(PC, TARGET)
+
 void Arm7Open(int ) 
 {
 
@@ -151,6 +161,282 @@ void Arm7NewFrame()
 /* include the arm7 core */
 #include "arm7core.c"
 
+static void arm7_idle_branch(UINT32 pc, UINT32 target)
+{
+	burn_idle *p = &BurnIdleInfo[IDLE_CPU_ARM7][0];
+	UINT32 regs[17];
+
+	for (INT32 i = 0; i < 16; i++) {
+		regs[i] = GET_REGISTER(i);
+	}
+	regs[15] = pc;
+	regs[16] = GET_CPSR;
+
+	if (BurnIdleBranch(p, pc, target, arm7_idle_writes, regs, sizeof(regs))) {
+		BurnIdleSkipped(p, arm7_icount);
+		arm7_icount = 0;
+	}
+}
+
+/***************************************************************************
+ * BLOCK CACHE
+ *
+ * Straight runs of code in directly mapped fetch memory are read once into
+ * a block, and the opcodes are then handed to arm7exec.c from there instead
+ * of going through Arm7FetchLong()/Arm7FetchWord() for every instruction.
+ * A block ends at the first instruction that can branch, at the end of the
+ * page or right before the idle loop address, so the idle loop speed hack
+ * only has to be checked when a block is entered. Each block remembers the
+ * block that was run after it, so loops don't go through the hash table.
+ *
+ * Blocks read from RAM keep a copy of their code. It is compared once per
+ * Arm7Run(), which catches code written by the 68000 or by the driver in
+ * between, and again after the ARM7 itself wrote to a page that code was
+ * read from. Such a write also ends the running block.
+ **************************************************************************/
+
+INT32 arm7_code_written = 0;
+
+#if USE_BLOCK_CACHE
+
+#define ARM7_BLOCK_MAX		32		// Instructions per block
+#define ARM7_BLOCK_COUNT	1024	// All blocks are dropped when they run out
+#define ARM7_BLOCK_HASH		2048
+
+#define ARM7_ADDR_MASK		0x7fffffff	// MAX_MEMORY_AND in arm7_intf.cpp, for the idle loop address
+
+struct arm7_block
+{
+	UINT32 pc;
+	UINT8 *host;
+	INT32 thumb;
+	INT32 idle;
+	INT32 len;
+	INT32 bytes;					// Size of the code copy, 0 for rom
+	UINT32 checked;					// arm7_block_serial when the copy was last compared
+	struct arm7_block *link;		// Block run after this one last time
+	struct arm7_block *next;
+	UINT32 insn[ARM7_BLOCK_MAX];
+	UINT8 code[ARM7_BLOCK_MAX * 4];
+};
+
+struct arm7_block_cache
+{
+	struct arm7_block *hash[ARM7_BLOCK_HASH];
+	struct arm7_block blocks[ARM7_BLOCK_COUNT];
+	INT32 used;
+};
+
+static struct arm7_block_cache *arm7_blocks = NULL;
+static struct arm7_block *arm7_block_cur = NULL;	// Block being run
+static INT32 arm7_block_pos;						// Next instruction in it
+static UINT32 arm7_block_pc;						// and its address
+static UINT32 arm7_block_serial = 0;
+
+void arm7_block_flush()
+{
+	arm7_block_cur = NULL;
+
+	if (arm7_blocks) {
+		memset(arm7_blocks->hash, 0, sizeof(arm7_blocks->hash));
+		arm7_blocks->used = 0;
+	}
+}
+
+void arm7_block_init()
+{
+	// Without it everything just goes through the interpreter
+	arm7_blocks = (struct arm7_block_cache *)malloc(sizeof(struct arm7_block_cache));
+
+	arm7_block_flush();
+}
+
+void arm7_block_exit()
+{
+	if (arm7_blocks) {
+		free(arm7_blocks);
+		arm7_blocks = NULL;
+	}
+
+	arm7_block_cur = NULL;
+}
+
+// The memory map changed, blocks may now be somewhere else
+void arm7_block_unlink()
+{
+	arm7_block_cur = NULL;
+
+	if (arm7_blocks) {
+		for (INT32 i = 0; i < arm7_blocks->used; i++) {
+			arm7_blocks->blocks[i].link = NULL;
+		}
+	}
+}
+
+// Instructions after which the code doesn't (always) go on in a straight line
+static int arm7_ends_block(UINT32 insn, INT32 thumb)
+{
+	if (thumb) {
+		switch (insn >> 12)
+		{
+			case 0x4: return (insn & 0xfc00) == 0x4400 && ((insn & 0x87) == 0x87 || (insn & 0x0300) == 0x0300);	// hi register ops on r15, bx
+			case 0xb: return (insn & 0xff00) == 0xbd00;		// pop {pc}
+			case 0xd:										// conditional branch, swi
+			case 0xe: return 1;								// branch
+			case 0xf: return (insn & 0x0800) != 0;			// second half of bl
+		}
+
+		return 0;
+	}
+
+	switch ((insn >> 24) & 0x0f)
+	{
+		case 0x0: case 0x1: case 0x2: case 0x3:
+		case 0x4: case 0x5: case 0x6: case 0x7:
+			return ((insn >> 12) & 0x0f) == 0x0f || (insn & 0x0ffffff0) == 0x012fff10;	// writes r15, bx
+		case 0x8: case 0x9:
+			return (insn & 0x00108000) == 0x00108000;		// ldm with r15 in the list
+		case 0xa: case 0xb:									// branch
+		case 0xf: return 1;									// swi
+	}
+
+	return 0;
+}
+
+static void arm7_block_decode(struct arm7_block *block, UINT32 pc, INT32 thumb, UINT8 *host, INT32 len, INT32 ram)
+{
+	UINT32 idle = Arm7GetIdleLoopAddress();
+	INT32 size = thumb ? 2 : 4;
+
+	block->pc = pc;
+	block->host = host;
+	block->thumb = thumb;
+	block->idle = (pc & ARM7_ADDR_MASK) == idle;
+	block->len = 0;
+	block->link = NULL;
+
+	do {
+		UINT32 insn;
+
+		if (thumb) {
+			UINT16 op;
+			memcpy(&op, host + block->len * 2, 2);
+			insn = op;
+		} else {
+			memcpy(&insn, host + block->len * 4, 4);
+		}
+
+		block->insn[block->len++] = insn;
+		pc += size;
+
+		if (arm7_ends_block(insn, thumb) || (pc & ARM7_ADDR_MASK) == idle) break;
+	} while (block->len < ARM7_BLOCK_MAX && block->len * size < len);
+
+	block->bytes = ram ? block->len * size : 0;
+	block->checked = arm7_block_serial;
+	memcpy(block->code, host, block->bytes);
+}
+
+// Find the block starting at pc, decoding it if needed. NULL if the code isn't directly mapped
+static struct arm7_block *arm7_block_get(UINT32 pc, INT32 thumb)
+{
+	INT32 len, ram;
+	UINT8 *host;
+
+	if (arm7_blocks == NULL || (pc & (thumb ? 1 : 3))) return NULL;
+
+	host = Arm7GetCodePointer(pc, &len, &ram);
+	if (host == NULL) return NULL;
+
+	struct arm7_block **slot = &arm7_blocks->hash[(pc >> 1) & (ARM7_BLOCK_HASH - 1)];
+	struct arm7_block *block;
+
+	for (block = *slot; block; block = block->next) {
+		if (block->pc == pc && block->host == host && block->thumb == thumb) {
+			return block;
+		}
+	}
+
+	if (arm7_blocks->used == ARM7_BLOCK_COUNT) {
+		arm7_block_flush();
+	}
+
+	block = &arm7_blocks->blocks[arm7_blocks->used++];
+	arm7_block_decode(block, pc, thumb, host, len, ram);
+	block->next = *slot;
+	*slot = block;
+
+	return block;
+}
+
+// Start running the block at pc, or fetch the opcode the slow way
+static UINT32 arm7_block_enter(UINT32 pc, INT32 thumb)
+{
+	struct arm7_block *prev = arm7_block_cur;
+	struct arm7_block *block;
+
+	if (arm7_code_written) {
+		arm7_code_written = 0;
+		arm7_block_serial++;	// compare the code of every block again
+		prev = NULL;
+	}
+
+	if (prev && prev->link && prev->link->pc == pc && prev->link->thumb == thumb) {
+		block = prev->link;
+	} else {
+		block = arm7_block_get(pc, thumb);
+		if (prev) prev->link = block;
+	}
+
+	arm7_block_cur = block;
+
+	if (block == NULL) {
+		return thumb ? cpu_readop16(pc & (~1)) : cpu_readop32(pc);
+	}
+
+	if (block->checked != arm7_block_serial) {
+		if (block->bytes && memcmp(block->code, block->host, block->bytes)) {
+			arm7_block_decode(block, pc, thumb, block->host, block->bytes, 1);	// the code was overwritten
+		}
+		block->checked = arm7_block_serial;
+	}
+
+	if (block->idle) {
+		Arm7RunEnd();
+	}
+
+	arm7_block_pos = 1;
+	arm7_block_pc = pc + (thumb ? 2 : 4);
+
+	return block->insn[0];
+}
+
+#else
+
+void arm7_block_flush() {}
+void arm7_block_init() {}
+void arm7_block_exit() {}
+void arm7_block_unlink() {}
+
+#endif
+
+// Opcode fetch for arm7exec.c
+ARM7_INLINE UINT32 arm7_readop(UINT32 pc, INT32 thumb)
+{
+#if USE_BLOCK_CACHE
+	struct arm7_block *block = arm7_block_cur;
+
+	if (block && pc == arm7_block_pc && arm7_block_pos < block->len && block->thumb == thumb && arm7_code_written == 0) {
+		arm7_block_pc += thumb ? 2 : 4;
+		return block->insn[arm7_block_pos++];
+	}
+
+	return arm7_block_enter(pc, thumb);
+#else
+	return thumb ? cpu_readop16(pc & (~1)) : cpu_readop32(pc);
+#endif
+}
+
 /***************************************************************************
  * CPU SPECIFIC IMPLEMENTATIONS
  **************************************************************************/
@@ -168,6 +454,10 @@ void Arm7Reset()
 
     // must call core reset
     arm7_core_reset();
+
+#if USE_BLOCK_CACHE
+	arm7_block_flush();
+#endif
 }
 
 /*
@@ -182,6 +472,14 @@ int Arm7Run(int cycles)
 	if (!DebugCPU_ARM7Initted) bprintf(PRINT_ERROR, _T("Arm7Run called without init\n"));
 #endif
 
+	BURN_PROF_CPU_SCOPE("ARM7", &Arm7Config, cycles);
+
+#if USE_BLOCK_CACHE
+	// the code in ram may have been changed since the last run
+	arm7_block_cur = NULL;
+	arm7_block_serial++;
+#endif
+
 /* include the arm7 core execute code */
 #include "arm7exec.c"
 }
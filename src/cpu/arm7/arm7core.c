@@ -804,6 +804,7 @@ static void HandleCoProcDT(UINT32 insn)
 static void HandleBranch(UINT32 insn)
 {
     UINT32 off = (insn & INSN_BRANCH) << 2;
+    UINT32 pc = R15;
 
     /* Save PC into LR if this is a branch with link */
     if (insn & INSN_BL)
@@ -821,6 +822,12 @@ static void HandleBranch(UINT32 insn)
         R15 += off + 8;
     }
 
+    /* a plain backward branch may close an idle loop */
+    if (!(insn & INSN_BL))
+    {
+        ARM7_IDLE_CHECK(pc, R15);
+    }
+
 //    change_pc(R15);
 }
 
@@ -387,7 +387,7 @@ enum
 /* At one point I thought these needed to be cpu implementation specific, but they don't.. */
 #define GET_REGISTER(reg)       GetRegister(reg)
 #define SET_REGISTER(reg, val)  SetRegister(reg, val)
-#define ARM7_CHECKIRQ           arm7_check_irq_state()
+#define ARM7_CHECKIRQ           do { if (ARM7.pendingIrq | ARM7.pendingFiq | ARM7.pendingAbtD | ARM7.pendingAbtP | ARM7.pendingUnd | ARM7.pendingSwi) arm7_check_irq_state(); } while (0)
 
 extern void((*arm7_coproc_do_callback)(unsigned int, unsigned int));
 extern unsigned int((*arm7_coproc_rt_r_callback)(unsigned int));
@@ -41,6 +41,11 @@
 /* This implementation uses an improved switch() for hopefully faster opcode fetches compared to my last version
 .. though there's still room for improvement. */
 {
+    /* for each condition code, the NZCV flag combinations (bit NZCV) it passes with */
+    static const UINT16 condition_pass[16] = {
+        0xf0f0, 0x0f0f, 0xcccc, 0x3333, 0xff00, 0x00ff, 0xaaaa, 0x5555,
+        0x0c0c, 0xf3f3, 0xaa55, 0x55aa, 0x0a05, 0xf5fa, 0xffff, 0x0000
+    };
     UINT32 pc;
     UINT32 insn;
 
@@ -58,7 +63,7 @@
             INT32 offs;
 
             pc = R15;
-            insn = cpu_readop16(pc & (~1));
+            insn = arm7_readop(pc, 1);
             ARM7_ICOUNT -= (3 - thumbCycles[insn >> 8]);
             switch ((insn & THUMB_INSN_TYPE) >> THUMB_INSN_TYPE_SHIFT)
             {
@@ -1116,6 +1121,10 @@
                             ARM7_CHECKIRQ;
                             break;
                     }
+                    if (offs < 0 && R15 == pc + 4 + (offs << 1))
+                    {
+                        ARM7_IDLE_CHECK(pc, R15);
+                    }
                     break;
                 case 0xe: /* B #offs */
                     if (insn & THUMB_BLOP_LO)
@@ -1134,6 +1143,7 @@
                             offs |= 0xfffff800;
                         }
                         R15 += 4 + offs;
+                        ARM7_IDLE_CHECK(pc, R15);
                     }
                     break;
                 case 0xf: /* BL */
@@ -1168,70 +1178,12 @@
 
             /* load 32 bit instruction */
             pc = R15;
-            insn = cpu_readop32(pc);
+            insn = arm7_readop(pc, 0);
 
             /* process condition codes for this instruction */
-            switch (insn >> INSN_COND_SHIFT)
-            {
-            case COND_EQ:
-                if (Z_IS_CLEAR(GET_CPSR))
-                    goto L_Next;
-                break;
-            case COND_NE:
-                if (Z_IS_SET(GET_CPSR))
-                    goto L_Next;
-                break;
-            case COND_CS:
-                if (C_IS_CLEAR(GET_CPSR))
-                    goto L_Next;
-                break;
-            case COND_CC:
-                if (C_IS_SET(GET_CPSR))
-                    goto L_Next;
-                break;
-            case COND_MI:
-                if (N_IS_CLEAR(GET_CPSR))
-                    goto L_Next;
-                break;
-            case COND_PL:
-                if (N_IS_SET(GET_CPSR))
-                    goto L_Next;
-                break;
-            case COND_VS:
-                if (V_IS_CLEAR(GET_CPSR))
-                    goto L_Next;
-                break;
-            case COND_VC:
-                if (V_IS_SET(GET_CPSR))
-                    goto L_Next;
-                break;
-            case COND_HI:
-                if (C_IS_CLEAR(GET_CPSR) || Z_IS_SET(GET_CPSR))
-                    goto L_Next;
-                break;
-            case COND_LS:
-                if (C_IS_SET(GET_CPSR) && Z_IS_CLEAR(GET_CPSR))
-                    goto L_Next;
-                break;
-            case COND_GE:
-                if (!(GET_CPSR & N_MASK) != !(GET_CPSR & V_MASK)) /* Use x ^ (x >> ...) method */
-                    goto L_Next;
-                break;
-            case COND_LT:
-                if (!(GET_CPSR & N_MASK) == !(GET_CPSR & V_MASK))
-                    goto L_Next;
-                break;
-            case COND_GT:
-                if (Z_IS_SET(GET_CPSR) || (!(GET_CPSR & N_MASK) != !(GET_CPSR & V_MASK)))
-                    goto L_Next;
-                break;
-            case COND_LE:
-                if (Z_IS_CLEAR(GET_CPSR) && (!(GET_CPSR & N_MASK) == !(GET_CPSR & V_MASK)))
-                  goto L_Next;
-                break;
-            case COND_NV:
+            if ((condition_pass[insn >> INSN_COND_SHIFT] & (1 << (GET_CPSR >> V_BIT))) == 0)
                 goto L_Next;
-            }
+
             /*******************************************************************/
             /* If we got here - condition satisfied, so decode the instruction */
             /*******************************************************************/
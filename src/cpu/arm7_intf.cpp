@@ -28,7 +28,14 @@ static UINT8  (*pReadByteHandler)(UINT32) = NULL;
 
 static UINT32 Arm7IdleLoop = ~0;
 
+static UINT8 *codepages = NULL; // pages the block cache in arm7.cpp has decoded code from
+
 extern void arm7_set_irq_line(INT32 irqline, INT32 state);
+extern void arm7_block_init();
+extern void arm7_block_exit();
+extern void arm7_block_flush();
+extern void arm7_block_unlink();
+extern INT32 arm7_code_written;
 
 cpu_core_config Arm7Config =
 {
@@ -64,6 +71,13 @@ void Arm7Exit() // only one cpu supported
 		}
 	}
 
+	if (codepages) {
+		free (codepages);
+		codepages = NULL;
+	}
+
+	arm7_block_exit();
+
 	Arm7IdleLoop = ~0;
 	
 	DebugCPU_ARM7Initted = 0;
@@ -85,6 +99,8 @@ void Arm7MapMemory(UINT8 *src, UINT32 start, UINT32 finish, INT32 type)
 		if (type & (1 << WRITE)) membase[WRITE][offset] = src + (i << PAGE_SHIFT);
 		if (type & (1 << FETCH)) membase[FETCH][offset] = src + (i << PAGE_SHIFT);
 	}
+
+	arm7_block_unlink();
 }
 
 void Arm7SetWriteByteHandler(void (*write)(UINT32, UINT8))
@@ -155,6 +171,7 @@ void Arm7WriteByte(UINT32 addr, UINT8 data)
 
 	if (membase[WRITE][addr >> PAGE_SHIFT] != NULL) {
 		membase[WRITE][addr >> PAGE_SHIFT][addr & PAGE_BYTE_AND] = data;
+		if (codepages[addr >> PAGE_SHIFT]) arm7_code_written = 1;
 		return;
 	}
 
@@ -177,6 +194,7 @@ void Arm7WriteWord(UINT32 addr, UINT16 data)
 
 	if (membase[WRITE][addr >> PAGE_SHIFT] != NULL) {
 		*((UINT16*)(membase[WRITE][addr >> PAGE_SHIFT] + (addr & PAGE_WORD_AND))) = data;
+		if (codepages[addr >> PAGE_SHIFT]) arm7_code_written = 1;
 		return;
 	}
 
@@ -199,6 +217,7 @@ void Arm7WriteLong(UINT32 addr, UINT32 data)
 
 	if (membase[WRITE][addr >> PAGE_SHIFT] != NULL) {
 		*((UINT32*)(membase[WRITE][addr >> PAGE_SHIFT] + (addr & PAGE_LONG_AND))) = data;
+		if (codepages[addr >> PAGE_SHIFT]) arm7_code_written = 1;
 		return;
 	}
 
@@ -359,6 +378,33 @@ void Arm7SetIdleLoopAddress(UINT32 address)
 #endif
 
 	Arm7IdleLoop = address;
+
+	arm7_block_flush();
+}
+
+// For the block cache in arm7.cpp
+
+// Returns the host address of directly mapped code at addr, the number of
+// bytes left in its page and whether the page can be written to, or NULL
+UINT8 *Arm7GetCodePointer(UINT32 addr, INT32 *len, INT32 *ram)
+{
+	addr &= MAX_MEMORY_AND;
+
+	UINT8 *ptr = membase[FETCH][addr >> PAGE_SHIFT];
+
+	if (ptr == NULL) return NULL;
+
+	codepages[addr >> PAGE_SHIFT] = 1;
+
+	*len = PAGE_SIZE - (addr & PAGE_BYTE_AND);
+	*ram = membase[WRITE][addr >> PAGE_SHIFT] != NULL;
+
+	return ptr + (addr & PAGE_BYTE_AND);
+}
+
+UINT32 Arm7GetIdleLoopAddress()
+{
+	return Arm7IdleLoop;
 }
 
 
@@ -383,6 +429,8 @@ void Arm7SetIdleLoopAddress(UINT32 address)
 	if (pWriteByteHandler) {
 		pWriteByteHandler(addr, data);
 	}
+
+	arm7_block_flush();
 }
 
 void Arm7Init( INT32 nCPU ) // only one cpu supported
@@ -394,5 +442,10 @@ void Arm7Init( INT32 nCPU ) // only one cpu supported
 		memset(membase[i], 0, PAGE_COUNT * sizeof(UINT8*));
 	}
 
+	codepages = (UINT8*)malloc(PAGE_COUNT);
+	memset(codepages, 0, PAGE_COUNT);
+
+	arm7_block_init();
+
 	CpuCheatRegister(nCPU, &Arm7Config);
 }
@@ -41,6 +41,10 @@ void Arm7SetReadLongHandler(UINT32 (*read)(UINT32));
 // speed hack function
 void Arm7SetIdleLoopAddress(UINT32 address);
 
+// used by the block cache
+UINT8 *Arm7GetCodePointer(UINT32 addr, INT32 *len, INT32 *ram);
+UINT32 Arm7GetIdleLoopAddress();
+
 void Arm7_write_rom_byte(UINT32 addr, UINT8 data); // for cheating
 
 extern struct cpu_core_config Arm7Config;
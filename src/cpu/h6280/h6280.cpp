@@ -112,6 +112,7 @@
 #include "burnint.h"
 #include "h6280.h"
 #include "h6280_intf.h"
+#include "burn_prof.h"
 //#include "driver.h"
 
 #define offs_t	unsigned int
@@ -233,6 +234,8 @@ int h6280Run(int cycles)
 	if (nh6280CpuActive == -1) bprintf(PRINT_ERROR, _T("h6280Run called with no CPU open\n"));
 #endif
 
+	BURN_PROF_CPU_SCOPE("H6280", &H6280Config, cycles);
+
 	int in;
 	h6280_ICount = cycles;
 	h6280.h6280_iCycles = cycles;
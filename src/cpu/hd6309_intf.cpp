@@ -1,5 +1,6 @@
 #include "burnint.h"
 #include "hd6309_intf.h"
+#include "burn_prof.h"
 
 #define MAX_CPU		8
 
@@ -207,6 +208,8 @@ INT32 HD6309Run(INT32 cycles)
 	if (nActiveCPU == -1) bprintf(PRINT_ERROR, _T("HD6309Run called when no CPU open\n"));
 #endif
 
+	BURN_PROF_CPU_SCOPE("HD6309", &HD6309Config, cycles);
+
 	cycles = hd6309_execute(cycles);
 	
 	nHD6309CyclesTotal += cycles;
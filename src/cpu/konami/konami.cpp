@@ -37,6 +37,7 @@
 #include "burnint.h"
 #include "konami.h"
 #include "konami_intf.h"
+#include "burn_prof.h"
 #include <stddef.h>
 #define VERBOSE 0
 
@@ -512,6 +513,8 @@ int konamiRun(int cycles)
 	if (!DebugCPU_KonamiInitted) bprintf(PRINT_ERROR, _T("konamiRun called without init\n"));
 #endif
 
+	BURN_PROF_CPU_SCOPE("Konami", &konamiCPUConfig, cycles);
+
 	konami_ICount = cycles - konami.extra_cycles;
 	nCyclesToDo = konami_ICount;
 	konami.extra_cycles = 0;
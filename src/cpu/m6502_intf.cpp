@@ -1,5 +1,6 @@
 #include "burnint.h"
 #include "m6502_intf.h"
+#include "burn_prof.h"
 #include <stddef.h>
 
 #define MAX_CPU		8
@@ -346,6 +347,8 @@ INT32 M6502Run(INT32 cycles)
 	if (nActiveCPU == -1) bprintf(PRINT_ERROR, _T("M6502Run called with no CPU open\n"));
 #endif
 
+	BURN_PROF_CPU_SCOPE("M6502", &M6502Config, cycles);
+
 	cycles = pCurrentCPU->execute(cycles);
 	
 	nM6502CyclesTotal += cycles;
@@ -2,6 +2,8 @@
 #include "burnint.h"
 #include "m68000_intf.h"
 #include "m68000_debug.h"
+#include "burn_idle.h"
+#include "burn_prof.h"
 
 #ifdef EMU_M68K
 INT32 nSekM68KContextSize[SEK_MAX];
@@ -654,7 +656,26 @@ void __fastcall A68KChangePC(UINT32 pc)
 #endif
 
 #ifdef EMU_M68K
+#if SEK_BITS != M68K_MEMMAP_BITS || SEK_MAXHANDLER != M68K_MEMMAP_MAXHANDLER
+ #error The Musashi memory map fast path (m68kconf.h) must match SekExt::MemMap
+#endif
+
+static burn_idle *pSekIdle = &BurnIdleInfo[IDLE_CPU_SEK][0];
+
 extern "C" {
+UINT8** M68KMemMap = NULL;
+
+INT32* M68KIdleEnabled = &BurnIdleInfo[IDLE_CPU_SEK][0].bEnabled;
+UINT32 M68KIdleWrites = 0;
+
+void M68KIdleBranch(UINT32 pc, UINT32 target, const UINT32* regs)
+{
+	if (BurnIdleBranch(pSekIdle, pc, target, M68KIdleWrites, regs, 16 * sizeof(UINT32))) {
+		BurnIdleSkipped(pSekIdle, m68k_ICount);
+		m68k_ICount = 0;
+	}
+}
+
 UINT32 __fastcall M68KReadByte(UINT32 a) { return (UINT32)ReadByte(a); }
 UINT32 __fastcall M68KReadWord(UINT32 a) { return (UINT32)ReadWord(a); }
 UINT32 __fastcall M68KReadLong(UINT32 a) { return               ReadLong(a); }
@@ -1196,6 +1217,9 @@ void SekOpen(const INT32 i)
 
 #ifdef EMU_M68K
 			m68k_set_context(SekM68KContext[nSekActive]);
+			M68KMemMap = pSekExt->MemMap;
+			pSekIdle = BurnIdleGet(IDLE_CPU_SEK, nSekActive);
+			M68KIdleEnabled = &pSekIdle->bEnabled;
 #endif
 
 #ifdef EMU_A68K
@@ -1375,6 +1399,8 @@ INT32 SekRun(const INT32 nCycles)
 	if (nSekActive == -1) bprintf(PRINT_ERROR, _T("SekRun called when no CPU open\n"));
 #endif
 
+	BURN_PROF_CPU_SCOPE("68000", &SekConfig, nCycles);
+
 #ifdef EMU_A68K
 	if (nSekCPUType[nSekActive] == 0) {
 		nSekCyclesDone = 0;
@@ -1,5 +1,6 @@
 #include "burnint.h"
 #include "m6800_intf.h"
+#include "burn_prof.h"
 #include <stddef.h>
 
 #define MAX_CPU     8
@@ -423,6 +424,8 @@ INT32 M6800Run(INT32 cycles)
 	if (M6800CPUContext[nActiveCPU].nCpuType != CPU_TYPE_M6800) bprintf(PRINT_ERROR, _T("M6800Run called with invalid CPU Type\n"));
 #endif
 
+	BURN_PROF_CPU_SCOPE("M6800", &M6800Config, cycles);
+
 	cycles = m6800_execute(cycles);
 	
 	nM6800CyclesTotal += cycles;
@@ -437,6 +440,8 @@ INT32 HD63701Run(INT32 cycles)
 	if (M6800CPUContext[nActiveCPU].nCpuType != CPU_TYPE_HD63701) bprintf(PRINT_ERROR, _T("HD63701Run called with invalid CPU Type\n"));
 #endif
 
+	BURN_PROF_CPU_SCOPE("HD63701", &HD63701Config, cycles);
+
 	cycles = hd63701_execute(cycles);
 	
 	nM6800CyclesTotal += cycles;
@@ -451,6 +456,8 @@ INT32 M6803Run(INT32 cycles)
 	if (M6800CPUContext[nActiveCPU].nCpuType != CPU_TYPE_M6803 && M6800CPUContext[nActiveCPU].nCpuType != CPU_TYPE_M6801) bprintf(PRINT_ERROR, _T("M6803Run called with invalid CPU Type\n"));
 #endif
 
+	BURN_PROF_CPU_SCOPE("M6803", &M6803Config, cycles);
+
 	cycles = m6803_execute(cycles);
 	
 	nM6800CyclesTotal += cycles;
@@ -465,6 +472,8 @@ INT32 NSC8105Run(INT32 cycles)
 	if (M6800CPUContext[nActiveCPU].nCpuType != CPU_TYPE_NSC8105) bprintf(PRINT_ERROR, _T("NSC8105Run called with invalid CPU Type\n"));
 #endif
 
+	BURN_PROF_CPU_SCOPE("NSC8105", &NSC8105Config, cycles);
+
 	cycles = nsc8105_execute(cycles);
 	
 	nM6800CyclesTotal += cycles;
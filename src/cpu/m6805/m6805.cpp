@@ -33,6 +33,7 @@
 #include "burnint.h"
 #include "driver.h"
 #include "m6805_intf.h"
+#include "burn_prof.h"
 #include <stddef.h>
 
 #define IRQ_LEVEL_DETECT 0
@@ -472,6 +473,8 @@ int m6805Run(int cycles)
 	if (!DebugCPU_M6805Initted) bprintf(PRINT_ERROR, _T("m6805Run called without init\n"));
 #endif
 
+	BURN_PROF_CPU_SCOPE("M6805", &M6805Config, cycles);
+
 	UINT8 ireg;
 	m6805_ICount = cycles;
 	S = SP_ADJUST( S );     /* Taken from CPU_SET_CONTEXT when pointer'afying */
@@ -1,5 +1,6 @@
 #include "burnint.h"
 #include "m6809_intf.h"
+#include "burn_prof.h"
 #include <stddef.h>
 
 #define MAX_CPU		8
@@ -231,6 +232,8 @@ INT32 M6809Run(INT32 cycles)
 	if (nActiveCPU == -1) bprintf(PRINT_ERROR, _T("M6809Run called when no CPU open\n"));
 #endif
 
+	BURN_PROF_CPU_SCOPE("M6809", &M6809Config, cycles);
+
 	cycles = m6809_execute(cycles);
 	
 	nM6809CyclesTotal += cycles;
@@ -249,12 +249,127 @@ void __fastcall M68KWriteWord(unsigned int a, unsigned int d);
 void __fastcall M68KWriteLong(unsigned int a, unsigned int d);
 #endif
 
+/* Memory map of the open cpu (SekExt::MemMap), see m68000_intf.h */
+extern unsigned char** M68KMemMap;
+
+/* Idle loop detection for the open cpu, see burn_idle.h */
+extern int* M68KIdleEnabled;
+extern unsigned int M68KIdleWrites;
+void M68KIdleBranch(unsigned int pc, unsigned int target, const unsigned int* regs);
+
 #ifdef __cplusplus
  }
 #endif
 
+/* Directly mapped pages are read and written inline, only handlers go
+ * through the M68K* functions above. Must match SEK_BITS / SEK_MAXHANDLER.
+ * Not for debug builds, which check breakpoints on every access.
+ */
+#if defined LSB_FIRST && !defined FBA_DEBUG
+ #define M68K_FAST_MEMMAP            OPT_ON
+#else
+ #define M68K_FAST_MEMMAP            OPT_OFF
+#endif
+
+#define M68K_MEMMAP_BITS            10
+#define M68K_MEMMAP_PAGEM           ((1 << M68K_MEMMAP_BITS) - 1)
+#define M68K_MEMMAP_WRITE           (1 << (24 - M68K_MEMMAP_BITS))
+#define M68K_MEMMAP_FETCH           (M68K_MEMMAP_WRITE * 2)
+#define M68K_MEMMAP_MAXHANDLER      10
+
+/* Called on taken backward branches, see m68ki_branch_8/16 */
+#define M68K_IDLE_BRANCH(PC, TARGET, REGS) if (*M68KIdleEnabled) M68KIdleBranch(PC, TARGET, REGS)
+
+#if M68K_FAST_MEMMAP
+
+#include <stdint.h>
+
+#define M68K_MEMMAP_PAGE(a, o)      M68KMemMap[(((a) & 0xFFFFFF) >> M68K_MEMMAP_BITS) + (o)]
+#define M68K_MEMMAP_DIRECT(p)       ((uintptr_t)(p) >= M68K_MEMMAP_MAXHANDLER)
+
+static __inline__ unsigned int M68KFastReadByte(unsigned int a)
+{
+	unsigned char* pr = M68K_MEMMAP_PAGE(a, 0);
+	if (M68K_MEMMAP_DIRECT(pr)) return pr[(a ^ 1) & M68K_MEMMAP_PAGEM];
+	return M68KReadByte(a);
+}
+
+static __inline__ unsigned int M68KFastReadWord(unsigned int a)
+{
+	unsigned char* pr = M68K_MEMMAP_PAGE(a, 0);
+	if (M68K_MEMMAP_DIRECT(pr) && (a & 1) == 0) return *((unsigned short*)(pr + (a & M68K_MEMMAP_PAGEM)));
+	return M68KReadWord(a);
+}
+
+static __inline__ unsigned int M68KFastReadLong(unsigned int a)
+{
+	unsigned char* pr = M68K_MEMMAP_PAGE(a, 0);
+	if (M68K_MEMMAP_DIRECT(pr) && (a & 1) == 0) {
+		unsigned int r = *((unsigned int*)(pr + (a & M68K_MEMMAP_PAGEM)));
+		return (r >> 16) | (r << 16);
+	}
+	return M68KReadLong(a);
+}
+
+static __inline__ unsigned int M68KFastFetchByte(unsigned int a)
+{
+	unsigned char* pr = M68K_MEMMAP_PAGE(a, M68K_MEMMAP_FETCH);
+	if (M68K_MEMMAP_DIRECT(pr)) return pr[(a ^ 1) & M68K_MEMMAP_PAGEM];
+	return M68KFetchByte(a);
+}
+
+static __inline__ unsigned int M68KFastFetchWord(unsigned int a)
+{
+	unsigned char* pr = M68K_MEMMAP_PAGE(a, M68K_MEMMAP_FETCH);
+	if (M68K_MEMMAP_DIRECT(pr)) return *((unsigned short*)(pr + (a & M68K_MEMMAP_PAGEM)));
+	return M68KFetchWord(a);
+}
+
+static __inline__ unsigned int M68KFastFetchLong(unsigned int a)
+{
+	unsigned char* pr = M68K_MEMMAP_PAGE(a, M68K_MEMMAP_FETCH);
+	if (M68K_MEMMAP_DIRECT(pr)) {
+		unsigned int r = *((unsigned int*)(pr + (a & M68K_MEMMAP_PAGEM)));
+		return (r >> 16) | (r << 16);
+	}
+	return M68KFetchLong(a);
+}
+
+static __inline__ void M68KFastWriteByte(unsigned int a, unsigned int d)
+{
+	unsigned char* pr = M68K_MEMMAP_PAGE(a, M68K_MEMMAP_WRITE);
+	if (M68K_MEMMAP_DIRECT(pr)) { pr[(a ^ 1) & M68K_MEMMAP_PAGEM] = (unsigned char)d; return; }
+	M68KWriteByte(a, d);
+}
+
+static __inline__ void M68KFastWriteWord(unsigned int a, unsigned int d)
+{
+	unsigned char* pr = M68K_MEMMAP_PAGE(a, M68K_MEMMAP_WRITE);
+	if (M68K_MEMMAP_DIRECT(pr) && (a & 1) == 0) { *((unsigned short*)(pr + (a & M68K_MEMMAP_PAGEM))) = (unsigned short)d; return; }
+	M68KWriteWord(a, d);
+}
+
+static __inline__ void M68KFastWriteLong(unsigned int a, unsigned int d)
+{
+	unsigned char* pr = M68K_MEMMAP_PAGE(a, M68K_MEMMAP_WRITE);
+	if (M68K_MEMMAP_DIRECT(pr) && (a & 1) == 0) { *((unsigned int*)(pr + (a & M68K_MEMMAP_PAGEM))) = (d >> 16) | (d << 16); return; }
+	M68KWriteLong(a, d);
+}
+
+#endif /* M68K_FAST_MEMMAP */
+
 #define m68ki_remaining_cycles m68k_ICount
 
+#if M68K_FAST_MEMMAP
+/* Read data relative to the PC */
+#define m68k_read_pcrelative_8(address) M68KFastFetchByte(address)
+#define m68k_read_pcrelative_16(address) M68KFastFetchWord(address)
+#define m68k_read_pcrelative_32(address) M68KFastFetchLong(address)
+
+/* Read data immediately following the PC */
+#define m68k_read_immediate_16(address) M68KFastFetchWord(address)
+#define m68k_read_immediate_32(address) M68KFastFetchLong(address)
+#else
 /* Read data relative to the PC */
 #define m68k_read_pcrelative_8(address) M68KFetchByte(address)
 #define m68k_read_pcrelative_16(address) M68KFetchWord(address)
@@ -263,6 +378,7 @@ void __fastcall M68KWriteLong(unsigned int a, unsigned int d);
 /* Read data immediately following the PC */
 #define m68k_read_immediate_16(address) M68KFetchWord(address)
 #define m68k_read_immediate_32(address) M68KFetchLong(address)
+#endif
 
 /* Memory access for the disassembler */
 #define m68k_read_disassembler_8(address) SekDbgFetchByteDisassembler(address)
@@ -276,9 +392,19 @@ void __fastcall M68KWriteLong(unsigned int a, unsigned int d);
 #define m68k_read_memory_32(address) M68KReadLongDebug(address)
 
 /* Write to anywhere */
-#define m68k_write_memory_8(address, value) M68KWriteByteDebug(address, value)
-#define m68k_write_memory_16(address, value) M68KWriteWordDebug(address, value)
-#define m68k_write_memory_32(address, value) M68KWriteLongDebug(address, value)
+#define m68k_write_memory_8(address, value) (M68KIdleWrites++, M68KWriteByteDebug(address, value))
+#define m68k_write_memory_16(address, value) (M68KIdleWrites++, M68KWriteWordDebug(address, value))
+#define m68k_write_memory_32(address, value) (M68KIdleWrites++, M68KWriteLongDebug(address, value))
+#elif M68K_FAST_MEMMAP
+/* Read from anywhere */
+#define m68k_read_memory_8(address) M68KFastReadByte(address)
+#define m68k_read_memory_16(address) M68KFastReadWord(address)
+#define m68k_read_memory_32(address) M68KFastReadLong(address)
+
+/* Write to anywhere */
+#define m68k_write_memory_8(address, value) (M68KIdleWrites++, M68KFastWriteByte(address, value))
+#define m68k_write_memory_16(address, value) (M68KIdleWrites++, M68KFastWriteWord(address, value))
+#define m68k_write_memory_32(address, value) (M68KIdleWrites++, M68KFastWriteLong(address, value))
 #else
 /* Read from anywhere */
 #define m68k_read_memory_8(address) M68KReadByte(address)
@@ -286,9 +412,9 @@ void __fastcall M68KWriteLong(unsigned int a, unsigned int d);
 #define m68k_read_memory_32(address) M68KReadLong(address)
 
 /* Write to anywhere */
-#define m68k_write_memory_8(address, value) M68KWriteByte(address, value)
-#define m68k_write_memory_16(address, value) M68KWriteWord(address, value)
-#define m68k_write_memory_32(address, value) M68KWriteLong(address, value)
+#define m68k_write_memory_8(address, value) (M68KIdleWrites++, M68KWriteByte(address, value))
+#define m68k_write_memory_16(address, value) (M68KIdleWrites++, M68KWriteWord(address, value))
+#define m68k_write_memory_32(address, value) (M68KIdleWrites++, M68KWriteLong(address, value))
 #endif /* FBA_DEBUG */
 
 #endif /* M68K_COMPILE_FOR_MAME */
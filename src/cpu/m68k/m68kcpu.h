@@ -1440,11 +1440,19 @@ INLINE void m68ki_jump_vector(uint vector)
 INLINE void m68ki_branch_8(uint offset)
 {
 	REG_PC += MAKE_INT_8(offset);
+#ifdef M68K_IDLE_BRANCH
+	if (offset & 0x80)
+		M68K_IDLE_BRANCH(REG_PPC, REG_PC, REG_DA);
+#endif
 }
 
 INLINE void m68ki_branch_16(uint offset)
 {
 	REG_PC += MAKE_INT_16(offset);
+#ifdef M68K_IDLE_BRANCH
+	if (offset & 0x8000)
+		M68K_IDLE_BRANCH(REG_PPC, REG_PC, REG_DA);
+#endif
 }
 
 INLINE void m68ki_branch_32(uint offset)
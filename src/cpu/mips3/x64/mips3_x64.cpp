@@ -3,6 +3,7 @@
  * Licensed under BSD 3-clause.
  */
 #include <cstdio>
+#include <cstring>
 #include "mips3_x64.h"
 #include "xbyak/xbyak.h"
 #include "../mips3.h"
@@ -33,7 +34,9 @@ namespace mips
 mips3_x64::mips3_x64(mips3 *interpreter) : CodeGenerator(1024 * 1024 * 16)
 {
     m_core = interpreter;
-    m_blocks.clear();
+    memset(m_block_map, 0, sizeof(m_block_map));
+    m_code_pages = new uint8_t[CODE_PAGE_COUNT];
+    memset(m_code_pages, 0, CODE_PAGE_COUNT);
 
 #ifdef HAS_UDIS86
     ud_init(&m_udobj);
@@ -42,11 +45,115 @@ mips3_x64::mips3_x64(mips3 *interpreter) : CodeGenerator(1024 * 1024 * 16)
 #endif
 }
 
+mips3_x64::~mips3_x64()
+{
+    flush();
+    delete [] m_code_pages;
+}
+
 inline void *mips3_x64::get_block(addr_t pc)
 {
-    if (m_blocks.find(pc) == m_blocks.end())
+    void **page = m_block_map[(uint32_t) pc >> BLOCK_MAP_SHIFT];
+    if (page == nullptr)
         return nullptr;
-    return m_blocks[pc];
+    return page[((uint32_t) pc >> 2) & (BLOCK_MAP_ENTRIES - 1)];
+}
+
+void mips3_x64::add_block(addr_t pc, void *code)
+{
+    uint32_t vpc = (uint32_t) pc;
+    void **&page = m_block_map[vpc >> BLOCK_MAP_SHIFT];
+    if (page == nullptr) {
+        page = new void*[BLOCK_MAP_ENTRIES];
+        memset(page, 0, sizeof(void*) * BLOCK_MAP_ENTRIES);
+    }
+    page[(vpc >> 2) & (BLOCK_MAP_ENTRIES - 1)] = code;
+
+    for (int i = 0; i < 2; i++) {
+        if (i && m_block_pages[1] == m_block_pages[0])
+            break;
+        m_page_blocks[m_block_pages[i]].push_back(vpc);
+        m_code_pages[m_block_pages[i]] = 1;
+    }
+
+    for (auto &s : m_new_sites)
+        m_links[s.first].push_back(s.second);
+    m_block_sites[vpc].swap(m_new_sites);
+    m_new_sites.clear();
+
+    link_block(vpc, code);
+}
+
+// Point every jump to pc at code, or back at its exit stub if code is null
+void mips3_x64::link_block(addr_t pc, void *code)
+{
+    auto it = m_links.find((uint32_t) pc);
+    if (it == m_links.end())
+        return;
+
+    for (int32_t *site : it->second) {
+        if (code)
+            *site = (int32_t) ((uint8_t *) code - (uint8_t *) (site + 1));
+        else
+            *site = 0;
+    }
+}
+
+// Something wrote to a physical page holding recompiled code: drop its
+// blocks, forget the jumps they own and unlink the jumps into them. The code
+// itself stays in the cache (a block may still be running) until the next flush.
+void mips3_x64::invalidate_page(uint32_t page)
+{
+    m_code_pages[page] = 0;
+
+    auto it = m_page_blocks.find(page);
+    if (it == m_page_blocks.end())
+        return;
+
+    for (uint32_t pc : it->second) {
+        void **map = m_block_map[pc >> BLOCK_MAP_SHIFT];
+        if (map)
+            map[(pc >> 2) & (BLOCK_MAP_ENTRIES - 1)] = nullptr;
+        link_block(pc, nullptr);
+
+        // a block spanning two pages is only found the first time
+        auto owned = m_block_sites.find(pc);
+        if (owned == m_block_sites.end())
+            continue;
+        for (auto &s : owned->second) {
+            auto links = m_links.find(s.first);
+            if (links == m_links.end())
+                continue;
+            vector<int32_t*> &sites = links->second;
+            for (size_t i = 0; i < sites.size(); i++) {
+                if (sites[i] == s.second) {
+                    sites[i] = sites.back();
+                    sites.pop_back();
+                    break;
+                }
+            }
+            if (sites.empty())
+                m_links.erase(links);
+        }
+        m_block_sites.erase(owned);
+    }
+    m_page_blocks.erase(it);
+}
+
+void mips3_x64::flush()
+{
+    for (int i = 0; i < (1 << (32 - BLOCK_MAP_SHIFT)); i++) {
+        if (m_block_map[i]) {
+            delete [] m_block_map[i];
+            m_block_map[i] = nullptr;
+        }
+    }
+    m_links.clear();
+    m_block_sites.clear();
+    m_new_sites.clear();
+    m_page_blocks.clear();
+    memset(m_code_pages, 0, CODE_PAGE_COUNT);
+    reset();
 }
 
 
@@ -63,18 +170,17 @@ void mips3_x64::run(int cycles)
 
         if (recompiled_code == nullptr) {
             try {
-                auto ptr = compile_block(m_core->m_state.pc);
+                auto code = compile_block(m_core->m_state.pc);
                 if (m_translate_failed)
                     break;
 
-                m_blocks[m_core->m_state.pc] = ptr;
-                recompiled_code = ptr;
+                add_block(m_core->m_state.pc, code);
+                recompiled_code = code;
             } catch(Xbyak::Error& e) {
                 // code flush
                 if (e == Xbyak::ERR_CODE_IS_TOO_BIG) {
                     drc_log("Flushing recompiler cache...\n");
-                    m_blocks.clear();
-                    reset();
+                    flush();
                     recompiled_code = nullptr;
                 } else {
                     drc_log("%s", e.what());
@@ -144,13 +250,18 @@ void *mips3_x64::compile_block(addr_t pc)
     bool do_recompile = true;
 
     void *block_ptr = Xbyak::CastTo<void*>(getCurr());
+    m_new_sites.clear();
 
     prolog();
 
     m_block_icounter = 0;
 
+    m_core->translate(m_drc_pc, &eaddr);
+    m_block_pages[0] = (uint32_t) eaddr >> CODE_PAGE_SHIFT;
+
     while (do_recompile) {
         m_core->translate(m_drc_pc, &eaddr);
+        m_block_pages[1] = (uint32_t) eaddr >> CODE_PAGE_SHIFT;
         opcode = mem::read_word(eaddr);
         m_drc_pc += 4;
         m_block_icounter++;
@@ -485,20 +596,26 @@ void mips3_x64::update_icounter()
 
 void mips3_x64::jmp_to_block(uint64_t addr)
 {
-    // Simple block linking
+    // Block linking: the rel32 below goes to the ret right after it until
+    // the target is compiled, then add_block() patches it to jump straight
+    // into the target, and invalidate_page() patches it back. The site is
+    // registered by add_block(), so a failed translation leaves nothing behind.
     void *next_ptr = get_block(addr);
+
+    set_next_pc(addr);
+    epilog(false);
+    db(0xE9);
+    int32_t *site = Xbyak::CastTo<int32_t*>(getCurr());
     if (next_ptr) {
 #if LOG_DYNAREC
         drc_log("Block link: %08X to %08X\n", CORE_PC, addr);
 #endif
-        epilog(false);
-        mov(rax, (size_t) next_ptr);
-        jmp(rax);
-        return;
+        dd((uint32_t) ((uint8_t *) next_ptr - (uint8_t *) (site + 1)));
     } else {
-        set_next_pc(addr);
+        dd(0);
     }
-    epilog();
+    m_new_sites.push_back(make_pair((uint32_t) addr, site));
+    ret();
 }
 
 void mips3_x64::jmp_to_register(int reg)
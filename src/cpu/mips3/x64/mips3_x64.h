@@ -6,6 +6,7 @@
 #define MIPS3_X64
 
 #include <unordered_map>
+#include <vector>
 #include "xbyak/xbyak.h"
 #include "../mips3.h"
 
@@ -21,7 +22,18 @@ class mips3_x64 : public Xbyak::CodeGenerator
 {
 public:
     mips3_x64(mips3 *interpreter);
+    ~mips3_x64();
     void run(int cycles);
+    void flush();
+    void invalidate_page(uint32_t page);
+    uint8_t *code_pages() { return m_code_pages; }
+
+    // Blocks are looked up by the low 32 bits of the pc, 64KB per table page
+    static const int BLOCK_MAP_SHIFT = 16;
+    static const int BLOCK_MAP_ENTRIES = 1 << (BLOCK_MAP_SHIFT - 2);
+    // Physical pages, same size as the mips3_intf memory map pages
+    static const int CODE_PAGE_SHIFT = 12;
+    static const int CODE_PAGE_COUNT = 1 << (32 - CODE_PAGE_SHIFT);
 
 private:
     int64_t m_icounter;
@@ -30,6 +42,8 @@ private:
     void run_this(void *ptr);
     void *compile_block(addr_t pc);
     void *get_block(addr_t pc);
+    void add_block(addr_t pc, void *code);
+    void link_block(addr_t pc, void *code);
     bool compile_special(uint32_t opcode);
     bool compile_regimm(uint32_t opcode);
     bool compile_instruction(uint32_t opcode);
@@ -53,7 +67,16 @@ private:
     uint64_t m_block_icounter;
     bool m_translate_failed;
     bool m_stop_translation;
-    unordered_map<addr_t, void(*)> m_blocks;
+    uint32_t m_block_pages[2];
+    void **m_block_map[1 << (32 - BLOCK_MAP_SHIFT)];
+    // Patchable rel32 jumps to each target pc, linked or not
+    unordered_map<uint32_t, vector<int32_t*>> m_links;
+    // Jumps emitted by each block (target pc, site), dropped with the block
+    unordered_map<uint32_t, vector<pair<uint32_t, int32_t*>>> m_block_sites;
+    vector<pair<uint32_t, int32_t*>> m_new_sites;
+    // Block pcs living in each physical page
+    unordered_map<uint32_t, vector<uint32_t>> m_page_blocks;
+    uint8_t *m_code_pages;
 #ifdef HAS_UDIS86
     ud_t m_udobj;
 #endif
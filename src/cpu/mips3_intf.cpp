@@ -37,6 +37,7 @@ static bool g_useRecompiler = false;
 
 #ifdef MIPS3_X64_DRC
 static mips::mips3_x64 *g_mips_x64 = NULL;
+static uint8_t *g_code_pages = NULL;
 #endif
 
 static unsigned char DefReadByte(unsigned int a) { return 0; }
@@ -75,6 +76,7 @@ int Mips3Init()
 
 #ifdef MIPS3_X64_DRC
     g_mips_x64 = new mips::mips3_x64(g_mips);
+    g_code_pages = g_mips_x64->code_pages();
 #endif
 
     ResetMemoryMap();
@@ -93,6 +95,8 @@ int Mips3Exit()
 {
 #ifdef MIPS3_X64_DRC
     delete g_mips_x64;
+    g_mips_x64 = NULL;
+    g_code_pages = NULL;
 #endif
     delete g_mips;
     delete g_mmap;
@@ -107,6 +111,23 @@ void Mips3Reset()
 {
     if (g_mips)
         g_mips->reset();
+#ifdef MIPS3_X64_DRC
+    if (g_mips_x64)
+        g_mips_x64->flush();
+#endif
+}
+
+// Drop recompiled code for memory changed behind the cpu's back (DMA, etc.)
+void Mips3InvalidateCode(unsigned int nStart, unsigned int nEnd)
+{
+#ifdef MIPS3_X64_DRC
+    if (g_mips_x64) {
+        for (unsigned int page = PFN(nStart); page <= PFN(nEnd); page++) {
+            if (g_code_pages[page])
+                g_mips_x64->invalidate_page(page);
+        }
+    }
+#endif
 }
 
 int Mips3Run(int cycles)
@@ -239,6 +260,14 @@ namespace mem
 {
 
 
+#ifdef MIPS3_X64_DRC
+#define CHECK_CODE_WRITE(address) \
+    if (g_code_pages && g_code_pages[PFN(address)]) \
+        g_mips_x64->invalidate_page(PFN(address))
+#else
+#define CHECK_CODE_WRITE(address)
+#endif
+
 template<typename T>
 inline T fast_read(uint8_t *ptr, unsigned adr) {
     return *((T*)  ((uint8_t*) ptr + (adr & PAGE_MASK)));
@@ -302,6 +331,7 @@ void write_byte(addr_t address, uint8_t value)
 
     UINT8 *pr = g_mmap->MemMap[PAGE_WADD + PFN(address)];
     if ((uintptr_t)pr >= MIPS_MAXHANDLER) {
+        CHECK_CODE_WRITE(address);
         pr[address & PAGE_MASK] = value;
         return;
     }
@@ -314,6 +344,7 @@ void write_half(addr_t address, uint16_t value)
 
     UINT8 *pr = g_mmap->MemMap[PAGE_WADD + PFN(address)];
     if ((uintptr_t)pr >= MIPS_MAXHANDLER) {
+        CHECK_CODE_WRITE(address);
         fast_write<uint16_t>(pr, address, BURN_ENDIAN_SWAP_INT16(value));
         return;
     }
@@ -326,6 +357,7 @@ void write_word(addr_t address, uint32_t value)
 
     UINT8 *pr = g_mmap->MemMap[PAGE_WADD + PFN(address)];
     if ((uintptr_t)pr >= MIPS_MAXHANDLER) {
+        CHECK_CODE_WRITE(address);
         fast_write<uint32_t>(pr, address, BURN_ENDIAN_SWAP_INT32(value));
         return;
     }
@@ -338,6 +370,7 @@ void write_dword(addr_t address, uint64_t value)
 
     UINT8 *pr = g_mmap->MemMap[PAGE_WADD + PFN(address)];
     if ((uintptr_t)pr >= MIPS_MAXHANDLER) {
+        CHECK_CODE_WRITE(address);
         fast_write<uint64_t>(pr, address, BURN_ENDIAN_SWAP_INT64(value));
         return;
     }
@@ -21,6 +21,7 @@ int Mips3Exit();
 void Mips3Reset();
 int Mips3Run(int cycles);
 unsigned int Mips3GetPC();
+void Mips3InvalidateCode(unsigned int nStart, unsigned int nEnd);
 
 int Mips3MapMemory(unsigned char* pMemory, unsigned int nStart, unsigned int nEnd, int nType);
 int Mips3MapHandler(uintptr_t nHandler, unsigned int nStart, unsigned int nEnd, int nType);
@@ -64,6 +64,7 @@
 
 //#include "debugger.h"
 #include "burnint.h"
+#include "burn_prof.h"
 #include "pic16c5x.h"
 
 #define CLK 1	/* 1 cycle equals 4 Q-clock ticks */
@@ -828,6 +829,8 @@ static void pic16C5x_update_timer(int counts)
 
 int pic16c5xRun(int cycles)
 {
+	BURN_PROF_CPU_SCOPE("PIC16C5x", &pic16c5xConfig, cycles);
+
 	UINT8 T0_in;
 	pic16C5x_icount = cycles;
 	
@@ -15,6 +15,7 @@
 #include "s2650.h"
 #include "burnint.h"
 #include "s2650_intf.h"
+#include "burn_prof.h"
 
 #define CLEAR_LINE	0
 #define change_pc(x)	\
@@ -856,6 +857,8 @@ int s2650Run(int cycles)
 	if (nActiveS2650 == -1) bprintf(PRINT_ERROR, _T("s2650Run called when no CPU open\n"));
 #endif
 
+	BURN_PROF_CPU_SCOPE("S2650", &s2650Config, cycles);
+
 	s2650_ICount = cycles;
 	do
 	{
@@ -30,7 +30,9 @@
  *****************************************************************************/
 
 #include "burnint.h"
+#include "burn_idle.h"
 #include "sh2_intf.h"
+#include "burn_prof.h"
 #include <stddef.h>
 
 int has_sh2;
@@ -40,6 +42,7 @@ INT32 sh2_busyloop_speedhack_mode2;
 #define BUSY_LOOP_HACKS     1
 #define FAST_OP_FETCH		1
 #define USE_JUMPTABLE		0
+#define USE_BLOCK_CACHE		1
 
 #define SH2_INT_15			15
 
@@ -123,6 +126,9 @@ typedef struct
 
 static SH2 * sh2;
 
+static burn_idle * sh2_idle = &BurnIdleInfo[IDLE_CPU_SH2][0];
+static UINT32 sh2_writes = 0;
+
 static UINT32 sh2_GetTotalCycles()
 {
 	return sh2->cycle_counts + sh2->sh2_cycles_to_run - sh2->sh2_icount;
@@ -154,6 +160,9 @@ enum {
 
 static UINT32 sh2_internal_r(UINT32 A, UINT32 mask);
 static void sh2_internal_w(UINT32 offset, UINT32 data, UINT32 mem_mask);
+#if USE_BLOCK_CACHE
+static struct sh2_block_cache * sh2_block_alloc();
+#endif
 
 //-- sh2 memory handler for Finalburn Alpha ---------------------
 
@@ -181,10 +190,13 @@ typedef struct
 	
 	unsigned char * opbase;
 	int suspend;
+
+	struct sh2_block_cache * blocks;
 } SH2EXT;
 
 static SH2EXT * pSh2Ext;
 static SH2EXT * Sh2Ext = NULL;
+static int nSh2Count = 0;
 
 cpu_core_config Sh2Config =
 {
@@ -455,9 +467,13 @@ int Sh2Exit()
 	has_sh2 = 0;
 
 	if (Sh2Ext) {
+		for (int i = 0; i < nSh2Count; i++) {
+			if (Sh2Ext[i].blocks) free(Sh2Ext[i].blocks);
+		}
 		free(Sh2Ext);
 		Sh2Ext = NULL;
 	}
+	nSh2Count = 0;
 	pSh2Ext = NULL;
 	
 	DebugCPU_SH2Initted = 0;
@@ -490,6 +506,7 @@ int Sh2Init(int nCount)
 		return 1;
 	}
 	memset(Sh2Ext, 0, sizeof(SH2EXT) * nCount);
+	nSh2Count = nCount;
 
 	// init default memory handler
 	for (int i=0; i<nCount; i++) {
@@ -498,6 +515,11 @@ int Sh2Init(int nCount)
 
 		sh2->sh2_eat_cycles = 1;
 
+#if USE_BLOCK_CACHE
+		// Without it everything just goes through the interpreter
+		pSh2Ext->blocks = sh2_block_alloc();
+#endif
+
 		Sh2MapHandler(SH2_MAXHANDLER - 1, 0xE0000000, 0xFFFFFFFF, 0x07);
 		Sh2MapHandler(SH2_MAXHANDLER - 2, 0x40000000, 0xBFFFFFFF, 0x07);
 //		Sh2MapHandler(SH2_MAXHANDLER - 3, 0xC0000000, 0xDFFFFFFF, 0x07);
@@ -530,6 +552,7 @@ void Sh2Open(const int i)
 
 	pSh2Ext = Sh2Ext + i;
 	sh2 = & (pSh2Ext->sh2);
+	sh2_idle = BurnIdleGet(IDLE_CPU_SH2, i);
 }
 
 void Sh2Close()
@@ -711,6 +734,8 @@ SH2_INLINE void WB(UINT32 A, UINT8 V)
 	if (A >= 0x40000000) return;
 	program_write_byte_32be(A & AM,V); */
 	
+	sh2_writes++;
+
 	unsigned char* pr;
 	pr = pSh2Ext->MemMap[(A >> SH2_SHIFT) + SH2_WADD];
 	if ((uintptr_t)pr >= SH2_MAXHANDLER) {
@@ -730,6 +755,8 @@ SH2_INLINE void WW(UINT32 A, UINT16 V)
 	if (A >= 0x40000000) return;
 	program_write_word_32be(A & AM,V); */
 
+	sh2_writes++;
+
 	unsigned char * pr;
 	pr = pSh2Ext->MemMap[(A >> SH2_SHIFT) + SH2_WADD];
 	if ((uintptr_t)pr >= SH2_MAXHANDLER) {
@@ -748,6 +775,9 @@ SH2_INLINE void WL(UINT32 A, UINT32 V)
 	if (A >= 0xc0000000) { program_write_dword_32be(A,V); return; }
 	if (A >= 0x40000000) return;
 	program_write_dword_32be(A & AM,V); */
+
+	sh2_writes++;
+
 	unsigned char * pr;
 	pr = pSh2Ext->MemMap[(A >> SH2_SHIFT) + SH2_WADD];
 	if ((uintptr_t)pr >= SH2_MAXHANDLER) {
@@ -947,6 +977,15 @@ SH2_INLINE void ANDM(UINT32 i)
 	sh2->sh2_icount -= 2;
 }
 
+/* Idle loop detection (see burn_idle.h), after a taken branch to sh2->ea */
+#define SH2_IDLE_CHECK()												\
+	if (sh2_idle->bEnabled &&											\
+		BurnIdleBranch(sh2_idle, sh2->ppc - 2, sh2->ea, sh2_writes, &sh2->sr, 21 * sizeof(UINT32))) {	\
+		BurnIdleSkipped(sh2_idle, sh2->sh2_icount);						\
+		sh2->sh2_total_cycles += sh2->sh2_icount;						\
+		sh2->sh2_icount = 0;											\
+	}
+
 /*  code                 cycles  t-bit
  *  1000 1011 dddd dddd  3/1     -
  *  BF      disp8
@@ -959,6 +998,7 @@ SH2_INLINE void BF(UINT32 d)
 		sh2->pc = sh2->ea = sh2->pc + disp * 2 + 2;
 		change_pc(sh2->pc & AM);
 		sh2->sh2_icount -= 2;
+		SH2_IDLE_CHECK();
 	}
 }
 
@@ -974,6 +1014,7 @@ SH2_INLINE void BFS(UINT32 d)
 		sh2->delay = sh2->pc;
 		sh2->pc = sh2->ea = sh2->pc + disp * 2 + 2;
 		sh2->sh2_icount--;
+		SH2_IDLE_CHECK();
 	}
 }
 
@@ -1006,6 +1047,7 @@ SH2_INLINE void BRA(UINT32 d)
 	sh2->delay = sh2->pc;
 	sh2->pc = sh2->ea = sh2->pc + disp * 2 + 2;
 	sh2->sh2_icount--;
+	SH2_IDLE_CHECK();
 }
 
 /*  code                 cycles  t-bit
@@ -1057,6 +1099,7 @@ SH2_INLINE void BT(UINT32 d)
 		sh2->pc = sh2->ea = sh2->pc + disp * 2 + 2;
 		change_pc(sh2->pc & AM);
 		sh2->sh2_icount -= 2;
+		SH2_IDLE_CHECK();
 	}
 }
 
@@ -1072,6 +1115,7 @@ SH2_INLINE void BTS(UINT32 d)
 		sh2->delay = sh2->pc;
 		sh2->pc = sh2->ea = sh2->pc + disp * 2 + 2;
 		sh2->sh2_icount--;
+		SH2_IDLE_CHECK();
 	}
 }
 
@@ -2767,6 +2811,265 @@ SH2_INLINE void op1111(UINT16 /*opcode*/)
 
 #endif	// USE_JUMPTABLE
 
+/*****************************************************************************
+ *  BLOCK CACHE
+ *
+ *  Straight runs of code fetched from directly mapped memory are decoded once
+ *  into a list of handlers, so Sh2Run() doesn't have to fetch every opcode and
+ *  go through the dispatchers above again. A block keeps a copy of the code it
+ *  was decoded from and is decoded again when that doesn't match any more, so
+ *  code RAM written by the SH-2, by DMA or by the driver is picked up. Delay
+ *  slots and code fetched through handlers still go through the interpreter.
+ *****************************************************************************/
+
+#if USE_BLOCK_CACHE
+
+#define SH2_BLOCK_MAX		32		// Instructions per block
+#define SH2_BLOCK_COUNT		2048	// Blocks per cpu, all are dropped when they run out
+#define SH2_BLOCK_HASH		4096
+
+typedef void (*sh2_op_handler)(UINT16 opcode);
+
+struct sh2_block
+{
+	UINT32 pc;
+	unsigned char * host;			// Where the code was, opbase + (pc & ~3)
+	INT32 len;
+	INT32 bytes;
+	struct sh2_block * next;
+	sh2_op_handler op[SH2_BLOCK_MAX];
+	UINT16 opcode[SH2_BLOCK_MAX];
+	unsigned char code[SH2_BLOCK_MAX * 2 + 4];
+};
+
+struct sh2_block_cache
+{
+	struct sh2_block * hash[SH2_BLOCK_HASH];
+	struct sh2_block blocks[SH2_BLOCK_COUNT];
+	INT32 used;
+};
+
+#define SH2_OP(name, args)	static void sh2op_##name(UINT16 opcode) { name args; }
+
+SH2_OP(ADD, (Rm, Rn))		SH2_OP(ADDC, (Rm, Rn))		SH2_OP(ADDV, (Rm, Rn))		SH2_OP(AND, (Rm, Rn))
+SH2_OP(CMPEQ, (Rm, Rn))		SH2_OP(CMPGE, (Rm, Rn))		SH2_OP(CMPGT, (Rm, Rn))		SH2_OP(CMPHI, (Rm, Rn))
+SH2_OP(CMPHS, (Rm, Rn))		SH2_OP(CMPSTR, (Rm, Rn))	SH2_OP(DIV0S, (Rm, Rn))		SH2_OP(DIV1, (Rm, Rn))
+SH2_OP(DMULS, (Rm, Rn))		SH2_OP(DMULU, (Rm, Rn))		SH2_OP(EXTSB, (Rm, Rn))		SH2_OP(EXTSW, (Rm, Rn))
+SH2_OP(EXTUB, (Rm, Rn))		SH2_OP(EXTUW, (Rm, Rn))		SH2_OP(MAC_L, (Rm, Rn))		SH2_OP(MAC_W, (Rm, Rn))
+SH2_OP(MOV, (Rm, Rn))		SH2_OP(MOVBS, (Rm, Rn))		SH2_OP(MOVWS, (Rm, Rn))		SH2_OP(MOVLS, (Rm, Rn))
+SH2_OP(MOVBL, (Rm, Rn))		SH2_OP(MOVWL, (Rm, Rn))		SH2_OP(MOVLL, (Rm, Rn))		SH2_OP(MOVBM, (Rm, Rn))
+SH2_OP(MOVWM, (Rm, Rn))		SH2_OP(MOVLM, (Rm, Rn))		SH2_OP(MOVBP, (Rm, Rn))		SH2_OP(MOVWP, (Rm, Rn))
+SH2_OP(MOVLP, (Rm, Rn))		SH2_OP(MOVBS0, (Rm, Rn))	SH2_OP(MOVWS0, (Rm, Rn))	SH2_OP(MOVLS0, (Rm, Rn))
+SH2_OP(MOVBL0, (Rm, Rn))	SH2_OP(MOVWL0, (Rm, Rn))	SH2_OP(MOVLL0, (Rm, Rn))	SH2_OP(MULL, (Rm, Rn))
+SH2_OP(MULS, (Rm, Rn))		SH2_OP(MULU, (Rm, Rn))		SH2_OP(NEG, (Rm, Rn))		SH2_OP(NEGC, (Rm, Rn))
+SH2_OP(NOT, (Rm, Rn))		SH2_OP(OR, (Rm, Rn))		SH2_OP(SUB, (Rm, Rn))		SH2_OP(SUBC, (Rm, Rn))
+SH2_OP(SUBV, (Rm, Rn))		SH2_OP(SWAPB, (Rm, Rn))		SH2_OP(SWAPW, (Rm, Rn))		SH2_OP(TST, (Rm, Rn))
+SH2_OP(XOR, (Rm, Rn))		SH2_OP(XTRCT, (Rm, Rn))
+
+SH2_OP(BRAF, (Rn))			SH2_OP(BSRF, (Rn))			SH2_OP(CMPPL, (Rn))			SH2_OP(CMPPZ, (Rn))
+SH2_OP(DT, (Rn))			SH2_OP(JMP, (Rn))			SH2_OP(JSR, (Rn))			SH2_OP(LDCSR, (Rn))
+SH2_OP(LDCGBR, (Rn))		SH2_OP(LDCVBR, (Rn))		SH2_OP(LDCMSR, (Rn))		SH2_OP(LDCMGBR, (Rn))
+SH2_OP(LDCMVBR, (Rn))		SH2_OP(LDSMACH, (Rn))		SH2_OP(LDSMACL, (Rn))		SH2_OP(LDSPR, (Rn))
+SH2_OP(LDSMMACH, (Rn))		SH2_OP(LDSMMACL, (Rn))		SH2_OP(LDSMPR, (Rn))		SH2_OP(MOVT, (Rn))
+SH2_OP(ROTCL, (Rn))			SH2_OP(ROTCR, (Rn))			SH2_OP(ROTL, (Rn))			SH2_OP(ROTR, (Rn))
+SH2_OP(SHAL, (Rn))			SH2_OP(SHAR, (Rn))			SH2_OP(SHLL, (Rn))			SH2_OP(SHLL2, (Rn))
+SH2_OP(SHLL8, (Rn))			SH2_OP(SHLL16, (Rn))		SH2_OP(SHLR, (Rn))			SH2_OP(SHLR2, (Rn))
+SH2_OP(SHLR8, (Rn))			SH2_OP(SHLR16, (Rn))		SH2_OP(STCSR, (Rn))			SH2_OP(STCGBR, (Rn))
+SH2_OP(STCVBR, (Rn))		SH2_OP(STCMSR, (Rn))		SH2_OP(STCMGBR, (Rn))		SH2_OP(STCMVBR, (Rn))
+SH2_OP(STSMACH, (Rn))		SH2_OP(STSMACL, (Rn))		SH2_OP(STSPR, (Rn))			SH2_OP(STSMMACH, (Rn))
+SH2_OP(STSMMACL, (Rn))		SH2_OP(STSMPR, (Rn))		SH2_OP(TAS, (Rn))
+
+SH2_OP(CLRMAC, ())			SH2_OP(CLRT, ())			SH2_OP(DIV0U, ())			SH2_OP(NOP, ())
+SH2_OP(RTE, ())				SH2_OP(RTS, ())				SH2_OP(SETT, ())			SH2_OP(SLEEP, ())
+
+SH2_OP(ANDI, (opcode & 0xff))	SH2_OP(ANDM, (opcode & 0xff))	SH2_OP(BF, (opcode & 0xff))		SH2_OP(BFS, (opcode & 0xff))
+SH2_OP(BT, (opcode & 0xff))		SH2_OP(BTS, (opcode & 0xff))	SH2_OP(CMPIM, (opcode & 0xff))	SH2_OP(MOVA, (opcode & 0xff))
+SH2_OP(MOVBLG, (opcode & 0xff))	SH2_OP(MOVWLG, (opcode & 0xff))	SH2_OP(MOVLLG, (opcode & 0xff))	SH2_OP(MOVBSG, (opcode & 0xff))
+SH2_OP(MOVWSG, (opcode & 0xff))	SH2_OP(MOVLSG, (opcode & 0xff))	SH2_OP(ORI, (opcode & 0xff))	SH2_OP(ORM, (opcode & 0xff))
+SH2_OP(TRAPA, (opcode & 0xff))	SH2_OP(TSTI, (opcode & 0xff))	SH2_OP(TSTM, (opcode & 0xff))	SH2_OP(XORI, (opcode & 0xff))
+SH2_OP(XORM, (opcode & 0xff))
+
+SH2_OP(ADDI, (opcode & 0xff, Rn))		SH2_OP(MOVI, (opcode & 0xff, Rn))
+SH2_OP(MOVWI, (opcode & 0xff, Rn))		SH2_OP(MOVLI, (opcode & 0xff, Rn))
+SH2_OP(BRA, (opcode & 0xfff))			SH2_OP(BSR, (opcode & 0xfff))
+SH2_OP(MOVLS4, (Rm, opcode & 0x0f, Rn))	SH2_OP(MOVLL4, (Rm, opcode & 0x0f, Rn))
+SH2_OP(MOVBS4, (opcode & 0x0f, Rm))		SH2_OP(MOVWS4, (opcode & 0x0f, Rm))
+SH2_OP(MOVBL4, (Rm, opcode & 0x0f))		SH2_OP(MOVWL4, (Rm, opcode & 0x0f))
+
+#undef SH2_OP
+
+// Same decoding as the op0000() ... op1111() dispatchers
+static const sh2_op_handler sh2_op0000_table[0x40] = {
+	sh2op_NOP,    sh2op_NOP,    sh2op_STCSR,  sh2op_BSRF,   sh2op_MOVBS0, sh2op_MOVWS0, sh2op_MOVLS0, sh2op_MULL,
+	sh2op_CLRT,   sh2op_NOP,    sh2op_STSMACH,sh2op_RTS,    sh2op_MOVBL0, sh2op_MOVWL0, sh2op_MOVLL0, sh2op_MAC_L,
+	sh2op_NOP,    sh2op_NOP,    sh2op_STCGBR, sh2op_NOP,    sh2op_MOVBS0, sh2op_MOVWS0, sh2op_MOVLS0, sh2op_MULL,
+	sh2op_SETT,   sh2op_DIV0U,  sh2op_STSMACL,sh2op_SLEEP,  sh2op_MOVBL0, sh2op_MOVWL0, sh2op_MOVLL0, sh2op_MAC_L,
+	sh2op_NOP,    sh2op_NOP,    sh2op_STCVBR, sh2op_BRAF,   sh2op_MOVBS0, sh2op_MOVWS0, sh2op_MOVLS0, sh2op_MULL,
+	sh2op_CLRMAC, sh2op_MOVT,   sh2op_STSPR,  sh2op_RTE,    sh2op_MOVBL0, sh2op_MOVWL0, sh2op_MOVLL0, sh2op_MAC_L,
+	sh2op_NOP,    sh2op_NOP,    sh2op_NOP,    sh2op_NOP,    sh2op_MOVBS0, sh2op_MOVWS0, sh2op_MOVLS0, sh2op_MULL,
+	sh2op_NOP,    sh2op_NOP,    sh2op_NOP,    sh2op_NOP,    sh2op_MOVBL0, sh2op_MOVWL0, sh2op_MOVLL0, sh2op_MAC_L
+};
+
+static const sh2_op_handler sh2_op0010_table[0x10] = {
+	sh2op_MOVBS,  sh2op_MOVWS,  sh2op_MOVLS,  sh2op_NOP,    sh2op_MOVBM,  sh2op_MOVWM,  sh2op_MOVLM,  sh2op_DIV0S,
+	sh2op_TST,    sh2op_AND,    sh2op_XOR,    sh2op_OR,     sh2op_CMPSTR, sh2op_XTRCT,  sh2op_MULU,   sh2op_MULS
+};
+
+static const sh2_op_handler sh2_op0011_table[0x10] = {
+	sh2op_CMPEQ,  sh2op_NOP,    sh2op_CMPHS,  sh2op_CMPGE,  sh2op_DIV1,   sh2op_DMULU,  sh2op_CMPHI,  sh2op_CMPGT,
+	sh2op_SUB,    sh2op_NOP,    sh2op_SUBC,   sh2op_SUBV,   sh2op_ADD,    sh2op_DMULS,  sh2op_ADDC,   sh2op_ADDV
+};
+
+static const sh2_op_handler sh2_op0100_table[0x40] = {
+	sh2op_SHLL,   sh2op_SHLR,   sh2op_STSMMACH,sh2op_STCMSR,sh2op_ROTL,   sh2op_ROTR,   sh2op_LDSMMACH,sh2op_LDCMSR,
+	sh2op_SHLL2,  sh2op_SHLR2,  sh2op_LDSMACH,sh2op_JSR,    sh2op_NOP,    sh2op_NOP,    sh2op_LDCSR,  sh2op_MAC_W,
+	sh2op_DT,     sh2op_CMPPZ,  sh2op_STSMMACL,sh2op_STCMGBR,sh2op_NOP,   sh2op_CMPPL,  sh2op_LDSMMACL,sh2op_LDCMGBR,
+	sh2op_SHLL8,  sh2op_SHLR8,  sh2op_LDSMACL,sh2op_TAS,    sh2op_NOP,    sh2op_NOP,    sh2op_LDCGBR, sh2op_MAC_W,
+	sh2op_SHAL,   sh2op_SHAR,   sh2op_STSMPR, sh2op_STCMVBR,sh2op_ROTCL,  sh2op_ROTCR,  sh2op_LDSMPR, sh2op_LDCMVBR,
+	sh2op_SHLL16, sh2op_SHLR16, sh2op_LDSPR,  sh2op_JMP,    sh2op_NOP,    sh2op_NOP,    sh2op_LDCVBR, sh2op_MAC_W,
+	sh2op_NOP,    sh2op_NOP,    sh2op_NOP,    sh2op_NOP,    sh2op_NOP,    sh2op_NOP,    sh2op_NOP,    sh2op_NOP,
+	sh2op_NOP,    sh2op_NOP,    sh2op_NOP,    sh2op_NOP,    sh2op_NOP,    sh2op_NOP,    sh2op_NOP,    sh2op_MAC_W
+};
+
+static const sh2_op_handler sh2_op0110_table[0x10] = {
+	sh2op_MOVBL,  sh2op_MOVWL,  sh2op_MOVLL,  sh2op_MOV,    sh2op_MOVBP,  sh2op_MOVWP,  sh2op_MOVLP,  sh2op_NOT,
+	sh2op_SWAPB,  sh2op_SWAPW,  sh2op_NEGC,   sh2op_NEG,    sh2op_EXTUB,  sh2op_EXTUW,  sh2op_EXTSB,  sh2op_EXTSW
+};
+
+static const sh2_op_handler sh2_op1000_table[0x10] = {
+	sh2op_MOVBS4, sh2op_MOVWS4, sh2op_NOP,    sh2op_NOP,    sh2op_MOVBL4, sh2op_MOVWL4, sh2op_NOP,    sh2op_NOP,
+	sh2op_CMPIM,  sh2op_BT,     sh2op_NOP,    sh2op_BF,     sh2op_NOP,    sh2op_BTS,    sh2op_NOP,    sh2op_BFS
+};
+
+static const sh2_op_handler sh2_op1100_table[0x10] = {
+	sh2op_MOVBSG, sh2op_MOVWSG, sh2op_MOVLSG, sh2op_TRAPA,  sh2op_MOVBLG, sh2op_MOVWLG, sh2op_MOVLLG, sh2op_MOVA,
+	sh2op_TSTI,   sh2op_ANDI,   sh2op_XORI,   sh2op_ORI,    sh2op_TSTM,   sh2op_ANDM,   sh2op_XORM,   sh2op_ORM
+};
+
+static sh2_op_handler sh2_decode(UINT16 opcode)
+{
+	switch (opcode >> 12)
+	{
+		case  0: return sh2_op0000_table[opcode & 0x3f];
+		case  1: return sh2op_MOVLS4;
+		case  2: return sh2_op0010_table[opcode & 0x0f];
+		case  3: return sh2_op0011_table[opcode & 0x0f];
+		case  4: return sh2_op0100_table[opcode & 0x3f];
+		case  5: return sh2op_MOVLL4;
+		case  6: return sh2_op0110_table[opcode & 0x0f];
+		case  7: return sh2op_ADDI;
+		case  8: return sh2_op1000_table[(opcode >> 8) & 0x0f];
+		case  9: return sh2op_MOVWI;
+		case 10: return sh2op_BRA;
+		case 11: return sh2op_BSR;
+		case 12: return sh2_op1100_table[(opcode >> 8) & 0x0f];
+		case 13: return sh2op_MOVLI;
+		case 14: return sh2op_MOVI;
+	}
+
+	return sh2op_NOP;
+}
+
+// Instructions after which the code doesn't (always) go on in a straight line
+static int sh2_ends_block(sh2_op_handler op)
+{
+	return op == sh2op_BRA || op == sh2op_BSR || op == sh2op_BRAF || op == sh2op_BSRF ||
+		op == sh2op_JMP || op == sh2op_JSR || op == sh2op_RTS || op == sh2op_RTE ||
+		op == sh2op_BT || op == sh2op_BF || op == sh2op_BTS || op == sh2op_BFS ||
+		op == sh2op_TRAPA || op == sh2op_SLEEP;
+}
+
+#ifdef LSB_FIRST
+#define SH2_BLOCK_OP(A)		*(UINT16 *)(pSh2Ext->opbase + ((A) ^ 0x02))
+#else
+#define SH2_BLOCK_OP(A)		*(UINT16 *)(pSh2Ext->opbase + (A))
+#endif
+
+static void sh2_block_flush(struct sh2_block_cache * cache)
+{
+	memset(cache->hash, 0, sizeof(cache->hash));
+	cache->used = 0;
+}
+
+static struct sh2_block_cache * sh2_block_alloc()
+{
+	struct sh2_block_cache * cache = (struct sh2_block_cache *)malloc(sizeof(struct sh2_block_cache));
+
+	if (cache) sh2_block_flush(cache);
+
+	return cache;
+}
+
+static void sh2_block_decode(struct sh2_block * block, UINT32 pc, unsigned char * host)
+{
+	UINT32 a = pc;
+
+	block->pc = pc;
+	block->host = host;
+	block->len = 0;
+
+	do {
+		UINT16 opcode = SH2_BLOCK_OP(a);
+		sh2_op_handler op = sh2_decode(opcode);
+
+		block->opcode[block->len] = opcode;
+		block->op[block->len] = op;
+		block->len++;
+		a += 2;
+
+		if (sh2_ends_block(op)) break;
+	} while (block->len < SH2_BLOCK_MAX && (a & SH2_PAGEM) != 0);
+
+	block->bytes = ((a + 3) & ~3) - (pc & ~3);
+	memcpy(block->code, host, block->bytes);
+}
+
+// Blocks are short, comparing whole words inline beats calling memcmp()
+static inline int sh2_block_same(struct sh2_block * block, unsigned char * host)
+{
+	UINT32 diff = 0;
+
+	for (INT32 i = 0; i < block->bytes; i += 4) {
+		UINT32 a, b;
+		memcpy(&a, block->code + i, 4);
+		memcpy(&b, host + i, 4);
+		diff |= a ^ b;
+	}
+
+	return diff == 0;
+}
+
+// Find the block starting at pc in the current fetch page, decoding it if needed
+static struct sh2_block * sh2_block_get(UINT32 pc)
+{
+	struct sh2_block_cache * cache = pSh2Ext->blocks;
+	unsigned char * host = pSh2Ext->opbase + (pc & ~3);
+	struct sh2_block ** slot = &cache->hash[(pc >> 1) & (SH2_BLOCK_HASH - 1)];
+	struct sh2_block * block;
+
+	for (block = *slot; block; block = block->next) {
+		if (block->pc == pc && block->host == host) {
+			if (!sh2_block_same(block, host)) {
+				sh2_block_decode(block, pc, host);		// the code was overwritten
+			}
+			return block;
+		}
+	}
+
+	if (cache->used == SH2_BLOCK_COUNT) {
+		sh2_block_flush(cache);
+	}
+
+	block = &cache->blocks[cache->used++];
+	sh2_block_decode(block, pc, host);
+	block->next = *slot;
+	*slot = block;
+
+	return block;
+}
+
+#endif	// USE_BLOCK_CACHE
+
 /*****************************************************************************
  *  MAME CPU INTERFACE
  *****************************************************************************/
@@ -3253,12 +3556,66 @@ static UINT32 sh2_internal_r(UINT32 offset, UINT32 /*mem_mask*/)
 
 // -------------------------------------------------------
 
+// Interrupts, cycle counting and the on-chip timers, after each instruction
+SH2_INLINE void sh2_end_of_instruction()
+{
+	if(sh2->test_irq && !sh2->delay)
+	{
+		CHECK_PENDING_IRQ(/*"mame_sh2_execute"*/);
+		sh2->test_irq = 0;
+	}
+
+	sh2->sh2_total_cycles++;
+	sh2->sh2_icount -= sh2->sh2_eat_cycles;
+	
+	// timer check 
+	
+	if (sh2->dma_timer_active[0] | sh2->dma_timer_active[1] | sh2->timer_active)
+	{
+		unsigned int cy = sh2_GetTotalCycles();
+
+
+		if (sh2->dma_timer_active[0])
+			if ((cy - sh2->dma_timer_base[0]) >= sh2->dma_timer_cycles[0])
+				sh2_dmac_callback(0);
+
+		if (sh2->dma_timer_active[1])
+			if ((cy - sh2->dma_timer_base[1]) >= sh2->dma_timer_cycles[1])
+				sh2_dmac_callback(1);
+	
+		if ( sh2->timer_active )
+			if ((cy - sh2->timer_base) >= sh2->timer_cycles)
+				sh2_timer_callback();
+	}
+}
+
+#if USE_BLOCK_CACHE
+// Run a decoded block for as long as the code goes on in a straight line
+static void sh2_block_run(struct sh2_block * block)
+{
+	for (INT32 i = 0; i < block->len; i++) {
+		UINT32 next = sh2->pc + 2;
+
+		sh2->pc = next;
+		sh2->ppc = next;
+
+		block->op[i](block->opcode[i]);
+
+		sh2_end_of_instruction();
+
+		if (sh2->pc != next || sh2->delay || sh2->sh2_icount <= 0 || pSh2Ext->suspend) break;
+	}
+}
+#endif
+
 int Sh2Run(int cycles)
 {
 #if defined FBA_DEBUG
 	if (!DebugCPU_SH2Initted) bprintf(PRINT_ERROR, _T("Sh2Run called without init\n"));
 #endif
 
+	BURN_PROF_CPU_SCOPE("SH2", &Sh2Config, cycles);
+
 	sh2->sh2_icount = cycles;
 	sh2->sh2_cycles_to_run = cycles;
 
@@ -3273,6 +3630,13 @@ int Sh2Run(int cycles)
 		if (pSh2Ext->suspend == 0) {
 			UINT16 opcode;
 
+#if USE_BLOCK_CACHE
+			if (sh2->delay == 0 && pSh2Ext->blocks && (uintptr_t)readop_pr >= SH2_MAXHANDLER) {
+				sh2_block_run(sh2_block_get(sh2->pc & AM));
+				continue;
+			}
+#endif
+
 			if (sh2->delay) {
 				opcode = cpu_readop16(sh2->delay & AM);
 				change_pc(sh2->pc & AM);
@@ -3305,34 +3669,7 @@ int Sh2Run(int cycles)
 			}
 		}
 
-		if(sh2->test_irq && !sh2->delay)
-		{
-			CHECK_PENDING_IRQ(/*"mame_sh2_execute"*/);
-			sh2->test_irq = 0;
-		}
-
-		sh2->sh2_total_cycles++;
-		sh2->sh2_icount -= sh2->sh2_eat_cycles;
-		
-		// timer check 
-		
-		{
-			unsigned int cy = sh2_GetTotalCycles();
-
-
-			if (sh2->dma_timer_active[0])
-				if ((cy - sh2->dma_timer_base[0]) >= sh2->dma_timer_cycles[0])
-					sh2_dmac_callback(0);
-
-			if (sh2->dma_timer_active[1])
-				if ((cy - sh2->dma_timer_base[1]) >= sh2->dma_timer_cycles[1])
-					sh2_dmac_callback(1);
-	
-			if ( sh2->timer_active )
-				if ((cy - sh2->timer_base) >= sh2->timer_cycles)
-					sh2_timer_callback();
-		}
-		
+		sh2_end_of_instruction();
 		
 	} while( sh2->sh2_icount > 0 );
 	
@@ -8,6 +8,7 @@
 
 #include "burnint.h"
 #include "tlcs90_intf.h"
+#include "burn_prof.h"
 #include <stddef.h>
 
 #define T90_IOBASE	0xffc0
@@ -1397,6 +1398,8 @@ INLINE void Cyc_f(t90_Regs *cpustate)   {   cpustate->icount -= cpustate->cyc_f;
 
 INT32 tlcs90Run(INT32 nCycles)
 {
+	BURN_PROF_CPU_SCOPE("TLCS90", &tlcs90Config, nCycles);
+
 	t90_Regs *cpustate = &tlcs90_data[0]; //get_safe_token(device);
 	UINT8    a8,b8;
 	UINT16   a16,b16;
@@ -398,6 +398,7 @@ STOP            01001000  10111011          12  stop
 
 
 #include "burnint.h"
+#include "burn_prof.h"
 #include "driver.h"
 #include "state.h"
 //#include "mamedbg.h"
@@ -1879,6 +1880,8 @@ static int run_end = 0;
 
 INT32 upd7810Run(INT32 cycles)
 {
+	BURN_PROF_CPU_SCOPE("uPD7810", &upd7810Config, cycles);
+
 	upd7810_current_cycles = cycles;
 	upd7810_icount = cycles;
 
@@ -7,6 +7,7 @@
 #include "bitswap.h" // ...xor_le
 #include "driver.h"
 #include "v60_intf.h"
+#include "burn_prof.h"
 
 #define offs_t			UINT32
 #define INPUT_LINE_NMI		CPU_IRQLINE_NMI
@@ -937,6 +938,8 @@ static void set_irq_line(int irqline, int state)
 
 INT32 v60Run(int cycles)
 {
+	BURN_PROF_CPU_SCOPE("V60", &v60Config, cycles);
+
 	UINT32 inc;
 
 	v60.cycles = cycles;
@@ -1,5 +1,6 @@
 #include "burnint.h"
 #include "z180_intf.h"
+#include "burn_prof.h"
 
 static INT32 DebugCPU_Z180Initted = 0;
 
@@ -161,6 +162,8 @@ void Z180Close()
 
 INT32 Z180Run(INT32 cycles)
 {
+	BURN_PROF_CPU_SCOPE("Z180", &Z180Config, cycles);
+
 	if (cycles <= 0) return 0;
 
 #if defined FBA_DEBUG
@@ -94,6 +94,7 @@
  *****************************************************************************/
 
 #include "burnint.h"
+#include "burn_idle.h"
 #include "z80.h"
 #include "z80daisy.h"
 #include <stddef.h>
@@ -110,6 +111,18 @@ static Z80WriteProgHandler Z80ProgramWrite;
 static Z80ReadOpHandler Z80CPUReadOp;
 static Z80ReadOpArgHandler Z80CPUReadOpArg;
 
+/* Page table of the open cpu (ZetExt::pZetMemMap), set by Z80SetMemMap().
+ * Directly mapped 256 byte pages are read and written inline, only the
+ * unmapped ones go through the handlers above. */
+#define Z80_MAP_READ		0x000
+#define Z80_MAP_WRITE		0x100
+#define Z80_MAP_FETCH		0x200
+#define Z80_MAP_ARG			0x300
+#define Z80_MAP_PAGE(o,a)	z80_memmap[(o) | (((a) & 0xffff) >> 8)]
+
+static UINT8 *z80_nomap[0x100 * 4];
+static UINT8 **z80_memmap = z80_nomap;
+
 #define Z80Vector Z80.vector
 
 #define VERBOSE 0
@@ -201,6 +214,9 @@ static INT32 end_run;
 static Z80_Regs Z80;
 UINT32 EA;
 
+static burn_idle *z80_idle = &BurnIdleInfo[IDLE_CPU_Z80][0];
+static UINT32 z80_writes = 0;
+
 void (*z80edfe_callback)(Z80_Regs *Regs) = NULL;
 
 static UINT8 SZ[256];		/* zero and sign flags */
@@ -579,12 +595,17 @@ Z80_INLINE void BURNODD(int cycles, int opcodes, int cyclesum)
 /***************************************************************
  * Output a byte to given I/O port
  ***************************************************************/
-#define OUT(port,value) Z80IOWrite(port,value)
+#define OUT(port,value) (z80_writes++, Z80IOWrite(port,value))
 
 /***************************************************************
  * Read a byte from given memory location
  ***************************************************************/
-#define RM(addr) (UINT8)Z80ProgramRead(addr)
+Z80_INLINE UINT8 RM(UINT32 addr)
+{
+	UINT8 *p = Z80_MAP_PAGE(Z80_MAP_READ, addr);
+	if (p) return p[addr & 0xff];
+	return (UINT8)Z80ProgramRead(addr);
+}
 
 /***************************************************************
  * Read a word from given memory location
@@ -598,10 +619,27 @@ Z80_INLINE void RM16( UINT32 addr, Z80_PAIR *r )
 /***************************************************************
  * Write a byte to given memory location
  ***************************************************************/
-#define WM(addr,value) Z80ProgramWrite(addr,value)
+Z80_INLINE void WM(UINT32 addr, UINT8 value)
+{
+	UINT8 *p = Z80_MAP_PAGE(Z80_MAP_WRITE, addr);
+	z80_writes++;
+	if (p) { p[addr & 0xff] = value; return; }
+	Z80ProgramWrite(addr, value);
+}
 
-#define cpu_readop(n) Z80CPUReadOp(n)
-#define cpu_readop_arg(n) Z80CPUReadOpArg(n)
+Z80_INLINE UINT8 cpu_readop(UINT32 pc)
+{
+	UINT8 *p = Z80_MAP_PAGE(Z80_MAP_FETCH, pc);
+	if (p) return p[pc & 0xff];
+	return Z80CPUReadOp(pc);
+}
+
+Z80_INLINE UINT8 cpu_readop_arg(UINT32 pc)
+{
+	UINT8 *p = Z80_MAP_PAGE(Z80_MAP_ARG, pc);
+	if (p) return p[pc & 0xff];
+	return Z80CPUReadOpArg(pc);
+}
 
 /***************************************************************
  * Write a word to given memory location
@@ -641,6 +679,11 @@ Z80_INLINE UINT32 ARG16(void)
 {
 	unsigned pc = PCD;
 	PC += 2;
+
+	/* both bytes in the same mapped page */
+	UINT8 *p = Z80_MAP_PAGE(Z80_MAP_ARG, pc);
+	if (p && (pc & 0xff) != 0xff) return p[pc & 0xff] | (p[(pc & 0xff) + 1] << 8);
+
 	return cpu_readop_arg(pc) | (cpu_readop_arg((pc+1)&0xffff) << 8);
 }
 
@@ -661,6 +704,17 @@ Z80_INLINE UINT32 ARG16(void)
  ***************************************************************/
 #define PUSH(SR) do { SP -= 2; WM16( SPD, &Z80.SR ); } while (0)
 
+/***************************************************************
+ * Idle loop detection (see burn_idle.h), after a taken jump
+ ***************************************************************/
+#define IDLE_CHECK(oldpc)										\
+	if( z80_idle->bEnabled &&									\
+		BurnIdleBranch(z80_idle, oldpc, PCD, z80_writes, &Z80.sp, 7 * sizeof(Z80_PAIR)) ) \
+	{															\
+		BurnIdleSkipped(z80_idle, z80_ICount);					\
+		Z80Burn( z80_ICount );									\
+	}
+
 /***************************************************************
  * JP
  ***************************************************************/
@@ -670,6 +724,7 @@ Z80_INLINE UINT32 ARG16(void)
 	PCD = ARG16();												\
 	WZ = PCD;													\
 	change_pc(PCD);												\
+	IDLE_CHECK(oldpc);											\
 	/* speed up busy loop */									\
 	if( PCD == oldpc )											\
 	{															\
@@ -701,9 +756,11 @@ Z80_INLINE UINT32 ARG16(void)
 }
 #else
 #define JP {													\
+	unsigned oldpc = PCD-1;										\
 	PCD = ARG16();												\
 	WZ = PCD;													\
 	change_pc(PCD);												\
+	IDLE_CHECK(oldpc);											\
 }
 #endif
 
@@ -714,9 +771,11 @@ Z80_INLINE UINT32 ARG16(void)
 #define JP_COND(cond)											\
 	if( cond )													\
 	{															\
+		unsigned oldpc = PCD-1;									\
 		PCD = ARG16();											\
 		WZ = PCD;												\
 		change_pc(PCD);											\
+		IDLE_CHECK(oldpc);										\
 	}															\
 	else														\
 	{															\
@@ -734,6 +793,7 @@ Z80_INLINE UINT32 ARG16(void)
 	PC += arg;				/* so don't do PC += ARG() */		\
 	WZ = PC;													\
 	change_pc(PCD);												\
+	IDLE_CHECK(oldpc);											\
 	/* speed up busy loop */									\
 	if( PCD == oldpc )											\
 	{															\
@@ -770,11 +830,13 @@ Z80_INLINE UINT32 ARG16(void)
 #define JR_COND(cond,opcode)									\
 	if( cond )													\
 	{															\
+		unsigned oldpc = PCD-1;									\
 		INT8 arg = (INT8)ARG(); /* ARG() also increments PC */	\
 		PC += arg;				/* so don't do PC += ARG() */	\
 	    WZ = PC;													\
 		CC(ex,opcode);											\
 		change_pc(PCD);											\
+		IDLE_CHECK(oldpc);										\
 	}															\
 	else PC++;													\
 
@@ -3615,6 +3677,16 @@ INT32 z80TotalCycles()
 	return Z80.cycles_left - z80_ICount;
 }
 
+void Z80SetIdleInfo(burn_idle *p)
+{
+	z80_idle = p;
+}
+
+void Z80SetMemMap(UINT8 **pMemMap)
+{
+	z80_memmap = pMemMap ? pMemMap : z80_nomap;
+}
+
 void Z80Burn(int cycles)
 {
 	if( cycles > 0 )
@@ -64,6 +64,8 @@ void Z80Reset();
 void Z80Exit();
 int  Z80Execute(int cycles);
 void Z80Burn(int cycles);
+void Z80SetIdleInfo(struct burn_idle *p);
+void Z80SetMemMap(UINT8 **pMemMap);
 void Z80SetIrqLine(int irqline, int state);
 void Z80GetContext (void *dst);
 void Z80SetContext (void *src);
@@ -1,6 +1,8 @@
 // Z80 (Zed Eight-Ty) Interface
 #include "burnint.h"
 #include "z80_intf.h"
+#include "burn_idle.h"
+#include "burn_prof.h"
 #include <stddef.h>
 
 #define MAX_Z80		8
@@ -23,6 +25,8 @@ struct ZetExt {
 	
 	UINT32 BusReq;
 	UINT32 ResetLine;
+
+	UINT64 nCounters[CPU_COUNTER_MAX];	// accesses that missed the page table
 };
  
 static INT32 nZetCyclesDone[MAX_Z80];
@@ -48,7 +52,8 @@ cpu_core_config ZetConfig =
 	ZetRunEnd,
 	ZetReset,
 	0x10000,
-	0
+	0,
+	ZetGetCounters
 };
 
 UINT8 __fastcall ZetDummyReadHandler(UINT16) { return 0; }
@@ -58,11 +63,14 @@ void __fastcall ZetDummyOutHandler(UINT16, UINT8) { }
 
 UINT8 __fastcall ZetReadIO(UINT32 a)
 {
+	ZetCPUContext[nOpenedCPU]->nCounters[CPU_COUNTER_IO]++;
+
 	return ZetCPUContext[nOpenedCPU]->ZetIn(a);
 }
 
 void __fastcall ZetWriteIO(UINT32 a, UINT8 d)
 {
+	ZetCPUContext[nOpenedCPU]->nCounters[CPU_COUNTER_IO]++;
 	ZetCPUContext[nOpenedCPU]->ZetOut(a, d);
 }
 
@@ -75,6 +83,8 @@ UINT8 __fastcall ZetReadProg(UINT32 a)
 	}
 	
 	// check handler
+	ZetCPUContext[nOpenedCPU]->nCounters[CPU_COUNTER_READ]++;
+
 	if (ZetCPUContext[nOpenedCPU]->ZetRead != NULL) {
 		return ZetCPUContext[nOpenedCPU]->ZetRead(a);
 	}
@@ -92,6 +102,8 @@ void __fastcall ZetWriteProg(UINT32 a, UINT8 d)
 	}
 	
 	// check handler
+	ZetCPUContext[nOpenedCPU]->nCounters[CPU_COUNTER_WRITE]++;
+
 	if (ZetCPUContext[nOpenedCPU]->ZetWrite != NULL) {
 		ZetCPUContext[nOpenedCPU]->ZetWrite(a, d);
 		return;
@@ -107,6 +119,8 @@ UINT8 __fastcall ZetReadOp(UINT32 a)
 	}
 	
 	// check read handler
+	ZetCPUContext[nOpenedCPU]->nCounters[CPU_COUNTER_FETCH]++;
+
 	if (ZetCPUContext[nOpenedCPU]->ZetRead != NULL) {
 		return ZetCPUContext[nOpenedCPU]->ZetRead(a);
 	}
@@ -123,6 +137,8 @@ UINT8 __fastcall ZetReadOpArg(UINT32 a)
 	}
 	
 	// check read handler
+	ZetCPUContext[nOpenedCPU]->nCounters[CPU_COUNTER_FETCH]++;
+
 	if (ZetCPUContext[nOpenedCPU]->ZetRead != NULL) {
 		return ZetCPUContext[nOpenedCPU]->ZetRead(a);
 	}
@@ -198,6 +214,16 @@ UINT8 ZetCheatRead(UINT32 a)
 	return ZetReadByte(a);
 }
 
+void ZetGetCounters(INT32 nCPU, UINT64 *pnCounters)
+{
+	if (nCPU < 0 || nCPU >= MAX_Z80 || ZetCPUContext[nCPU] == NULL) {
+		memset(pnCounters, 0, CPU_COUNTER_MAX * sizeof(UINT64));
+		return;
+	}
+
+	memcpy(pnCounters, ZetCPUContext[nCPU]->nCounters, CPU_COUNTER_MAX * sizeof(UINT64));
+}
+
 INT32 ZetInit(INT32 nCPU)
 {
 	DebugCPU_ZetInitted = 1;
@@ -344,6 +370,7 @@ void ZetClose()
 	nZetCyclesDone[nOpenedCPU] = nZetCyclesTotal;
 	nZ80ICount[nOpenedCPU] = z80_ICount;
 	Z80EA[nOpenedCPU] = EA;
+	Z80SetMemMap(NULL);
 
 	nOpenedCPU = -1;
 }
@@ -361,6 +388,8 @@ void ZetOpen(INT32 nCPU)
 	nZetCyclesTotal = nZetCyclesDone[nCPU];
 	z80_ICount = nZ80ICount[nCPU];
 	EA = Z80EA[nCPU];
+	Z80SetIdleInfo(BurnIdleGet(IDLE_CPU_Z80, nCPU));
+	Z80SetMemMap(ZetCPUContext[nCPU]->pZetMemMap);
 
 	nOpenedCPU = nCPU;
 }
@@ -384,6 +413,8 @@ INT32 ZetRun(INT32 nCycles)
 
 	if (nCycles <= 0) return 0;
 
+	BURN_PROF_CPU_SCOPE("Z80", &ZetConfig, nCycles);
+
 	INT32 nDelayed = 0;  // handle delayed cycle counts (from nmi / irq)
 	if (nZetCyclesDelayed[nOpenedCPU]) {
 		nDelayed = nZetCyclesDelayed[nOpenedCPU];
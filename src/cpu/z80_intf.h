@@ -86,6 +86,7 @@ INT32 ZetGetRESETLine();
 
 void ZetCheatWriteROM(UINT32 a, UINT8 d); // cheat core
 UINT8 ZetCheatRead(UINT32 a);
+void ZetGetCounters(INT32 nCPU, UINT64 *pnCounters);
 
 extern struct cpu_core_config ZetConfig;
 